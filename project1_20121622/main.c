@@ -16,6 +16,7 @@
 
 #include "util.h"
 #if NO_PARSE
+#include <time.h>
 #include "scan.h"
 #else
 #include "parse.h"
@@ -44,12 +45,64 @@ int TraceCode = FALSE;
 
 int Error = FALSE;
 
+#if NO_PARSE
+/* the names of the token kinds, in the order of TokenType */
+
+#define NTOKENS (COMMENT_ERROR + 1)
+
+static char *tokenName[NTOKENS] = {
+    "ENDFILE", "ERROR",
+    "IF", "THEN", "ELSE", "END", "REPEAT", "UNTIL", "READ", "WRITE",
+    "ID", "NUM",
+    "ASSIGN", "EQ", "LT", "PLUS", "MINUS", "TIMES", "OVER", "LPAREN", "RPAREN", "SEMI",
+    "LTEQ", "EQEQ", "RTEQ", "RT",
+    "RETURN",
+    "WHILE", "INT", "COMMA", "COMMENT", "LBRACE", "RBRACE", "LBRACKET", "RBRACKET", "COMMENT_ERROR"
+};
+
+/* Procedure benchScanner pulls every token of the source through
+ * getToken with nothing printed, then reports the throughput of
+ * the scanner and the number of tokens of each kind
+ */
+static void benchScanner(char *pgm) {
+    long counts[NTOKENS] = { 0 };
+    long tokens = 0, bytes;
+    struct timespec start, end;
+    double seconds;
+    TokenType token;
+    int k;
+
+    fseek(source, 0, SEEK_END);
+    bytes = ftell(source);
+    rewind(source);
+    EchoSource = TraceScan = FALSE;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while ((token = getToken()) != ENDFILE) {
+        counts[token]++;
+        tokens++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (seconds <= 0) seconds = 1e-9;
+    fprintf(listing, "%s: %ld bytes, %d lines, %ld tokens in %.6f s\n", pgm, bytes, lineno, tokens, seconds);
+    fprintf(listing, "%.2f MB/s, %.0f tokens/s\n", bytes / seconds / 1e6, tokens / seconds);
+    for (k = 0; k < NTOKENS; ++k)
+        if (counts[k] > 0) fprintf(listing, "\t%-14s%ld\n", tokenName[k], counts[k]);
+}
+#endif
+
 main (int argc, char *argv[]) {
     TreeNode *syntaxTree;
-    char pgm[20]; /* source code file name */
+    char pgm[256]; /* source code file name */
+    int bench = FALSE;
 
-    if (argc != 2) {
-        fprintf(stderr, "usage: %s <filename> \n", argv[0]);
+    if (argc == 3 && !strcmp(argv[1], "-bench")) {
+        bench = TRUE;
+        argv++;
+        argc--;
+    }
+    if (argc != 2 || strlen(argv[1]) + 5 > sizeof(pgm)) {
+        fprintf(stderr, "usage: %s [-bench] <filename> \n", argv[0]);
         exit(1);
     }
 
@@ -67,6 +120,10 @@ main (int argc, char *argv[]) {
 //    fprintf(listing, "\nTINY COMPILATION: %s\n", pgm);
 
 #if NO_PARSE
+    if (bench) {
+        benchScanner(pgm);
+        return 0;
+    }
 	fprintf(listing, "\tline number\t%s\t\t%-25s\t\n", "token", "lexeme");
 	fprintf(listing, "---------------------------------------------------------\n");
     while (getToken() != ENDFILE);
@@ -6,6 +6,7 @@
 /* Kenneth C. Louden                                */
 /****************************************************/
 
+#include <setjmp.h>
 #include "globals.h"
 #include "symtab.h"
 #include "analyze.h"
@@ -18,6 +19,26 @@ static int param_location = 0;
 static int global_check = 1;
 static int isTypeCheck = 0;
 
+/* TRUE while a declaration is checked again against the
+ * retained global scope, which already holds its name
+ */
+static int redeclare = FALSE;
+
+/* the global declarations being inserted, searched for the
+ * prototype a function definition completes
+ */
+static TreeNode *declarations = NULL;
+
+/* where a semantic error returns to, NULL to exit */
+static jmp_buf *recovery = NULL;
+
+void semanticError(void) {
+	if (recovery != NULL) longjmp(*recovery, 1);
+	exit(1);
+}
+
+int param_length(TreeNode * t);
+
 /* Procedure traverse is a generic recursive 
  * syntax tree traversal routine:
  * it applies preProc in preorder and postProc 
@@ -86,9 +107,11 @@ static void traverse(TreeNode *t, void (* preProc) (TreeNode *), void(* postProc
 			case ExpK:
 				switch (t->kind.exp) {
 					case IdK:
-					 	if(isTypeCheck == 0)
+					 	if(isTypeCheck == 0){
 					 		lineno_insert(t->attr.name, t->lineno);
-						printf("[DEBUG] name: %s, lineno: %d\n", t->attr.name, t->lineno);
+							t->bucket = st_bucket_lookup(t->attr.name);
+						}
+						if (TraceAnalyze) printf("[DEBUG] name: %s, lineno: %d\n", t->attr.name, t->lineno);
 						break;
 					case ArrK:
 						traverse(t->child[5], preProc, postProc, 0);
@@ -174,23 +197,58 @@ static void traverse(TreeNode *t, void (* preProc) (TreeNode *), void(* postProc
 		traverse(t->sibling, preProc, postProc, 0);
 	}
 }
+/* Function prototypeOf returns the declaration without a
+ * body that function t completes, NULL unless every earlier
+ * declaration of its name is one without a body
+ */
+static TreeNode *prototypeOf(TreeNode *t) {
+	TreeNode *d, *proto = NULL;
+
+	for (d = declarations; d != NULL && d != t; d = d->sibling)
+		if (d->nodekind == DeclK && d->kind.decl == FuncK && !strcmp(d->child[1]->attr.name, t->child[1]->attr.name)) {
+			if (d->child[3] != NULL) return NULL;
+			proto = d;
+		}
+	return d == t ? proto : NULL;
+}
+
+/* Function sameSignature returns TRUE if functions a and b
+ * return the same type and take the same kinds of parameters
+ */
+static int sameSignature(TreeNode *a, TreeNode *b) {
+	TreeNode *p = a->child[2], *q = b->child[2];
+
+	if (a->child[0]->type != b->child[0]->type) return FALSE;
+	for (; p != NULL && q != NULL; p = p->sibling, q = q->sibling)
+		if (p->kind.decl != q->kind.decl || (p->child[0] != NULL && p->child[0]->type != q->child[0]->type))
+			return FALSE;
+	return p == NULL && q == NULL;
+}
+
 static void insertNode(TreeNode *t) {
+	TreeNode *proto;
+
+
+	if (redeclare && (t->kind.decl == FuncK || global_check)) {
+		t->child[1]->bucket = st_bucket_lookup(t->child[1]->attr.name);
+		return;
+	}
 	switch (t->kind.decl) {
 		case VarK:
 
 		 	if (st_lookup(t->child[1]->attr.name) == -1){ 
 		  		if(global_check == 0){
 				 	local_location -= 4;
-					st_insert(t->child[1]->attr.name, t->child[1]->lineno, local_location, "int", 0, "Var");
+					t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, local_location, "int", 0, "Var");
 				}
 				else{
 				 	global_location += 4;
-					st_insert(t->child[1]->attr.name, t->child[1]->lineno, global_location, "int", 0, "Var");
+					t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, global_location, "int", 0, "Var");
 				}
 		 	}
 			else {
 				printf("ERROR in line %d : declaration of %s duplicated first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, st_lookup(t->child[1]->attr.name));
-				exit(1);
+				semanticError();
 			}
 
 			break;
@@ -199,46 +257,55 @@ static void insertNode(TreeNode *t) {
 			 	int temp_arraySize = t->child[4]->attr.val;
 			 	if(global_check == 0){
 					local_location -= temp_arraySize*4;
-			 		st_insert(t->child[1]->attr.name, t->child[1]->lineno, local_location, "array", temp_arraySize, "Var");
+			 		t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, local_location, "array", temp_arraySize, "Var");
 				}
 				else{
 				 	global_location += temp_arraySize*4;
-			 		st_insert(t->child[1]->attr.name, t->child[1]->lineno, global_location, "array", temp_arraySize, "Var");
+			 		t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, global_location, "array", temp_arraySize, "Var");
 				}
 			}		
 			else {
 				printf("ERROR in line %d : declaration of %s duplicated first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, st_lookup(t->child[1]->attr.name));
-				exit(1);
+				semanticError();
 			}
 			break;
 		case ParamK:
 		 	if (st_lookup(t->child[1]->attr.name) == -1) {
-			 	st_insert(t->child[1]->attr.name, t->child[1]->lineno, param_location, "int", 0, "Par");
+			 	t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, param_location, "int", 0, "Par");
 			 	param_location -= 4;
 			}		
 			else {
 				printf("ERROR in line %d : declaration of %s duplicated first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, st_lookup(t->child[1]->attr.name));
-				exit(1);
+				semanticError();
 			}
 
 			break;
 		case ParamArrK:
 		 	if (st_lookup(t->child[1]->attr.name) == -1) {
-			 	st_insert(t->child[1]->attr.name, t->child[1]->lineno, param_location, "array", 0, "Par");
+			 	t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, param_location, "array", 0, "Par");
 			 	param_location -= 4;
 			}
 			else {
 				printf("ERROR in line %d : declaration of %s duplicated first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, st_lookup(t->child[1]->attr.name));
-				exit(1);
+				semanticError();
 			}
 
 			break;
 		case FuncK:
 		 	if (st_function_lookup(t->child[1]->attr.name) == -1) 
-			 	st_insert(t->child[1]->attr.name, t->child[1]->lineno, func_location++, t->child[0]->type == 0 ? "void" : "int", 0, "Func");
+			 	t->child[1]->bucket = st_insert(t->child[1]->attr.name, t->child[1]->lineno, func_location++, t->child[0]->type == 0 ? "void" : "int", 0, "Func");
+			else if ((proto = prototypeOf(t)) != NULL) {
+				/* a declaration without a body, completed or repeated */
+				if (!sameSignature(proto, t)) {
+					printf("ERROR in line %d : conflicting declaration of %s first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, proto->child[1]->lineno);
+					semanticError();
+				}
+				t->child[1]->bucket = proto->child[1]->bucket;
+				lineno_insert(t->child[1]->attr.name, t->child[1]->lineno);
+			}
 			else {
 			 printf("ERROR in line %d : declaration of %s duplicated first declared at line %d\n", t->child[1]->lineno, t->child[1]->attr.name, st_function_lookup(t->child[1]->attr.name));
-				exit(1);
+				semanticError();
 			}
 
 			break;
@@ -284,23 +351,23 @@ static void typeError(TreeNode * t, char * message)
 						 if (strcmp(st_functionType_lookup(t->child[1]->child[5]->attr.name), "int")) {
 						  printf("%s\n", st_functionType_lookup(t->child[1]->child[5]->attr.name));
 						  printf("index type must be int\n");
-						  exit(1);
+						  semanticError();
 						 }
 						}
 						else {
-						 	printf("name: %s\n", t->child[5]->attr.name);
+						 	if (TraceAnalyze) printf("name: %s\n", t->child[5]->attr.name);
 							BucketList l = st_bucket_lookup(t->child[5]->attr.name);
 							
 							if(l == NULL){
-							 printSymTabCur(); 
+							 printSymTabCur(listing); 
 							 printf("Scope: %d\n", scopeCheck());
 							 printf("asdfasdf NULL\n");
-							 exit(1);
+							 semanticError();
 							}
 							
 							if (strcmp(l->type, "array")) {
 							  printf("int type can not be used like array\n");
-							  exit(1);
+							  semanticError();
 							}
 						}
 						break;
@@ -316,7 +383,7 @@ static void typeError(TreeNode * t, char * message)
 
 						 if(strcmp(l->VPF, "Func")) {
 						  printf("%s is not a function\n", t->child[5]->attr.name);
-						  exit(1);
+						  semanticError();
 						 }
 						}
 						 break;
@@ -327,12 +394,12 @@ static void typeError(TreeNode * t, char * message)
 					case FuncK:
 					 	{
 						 BucketList l = st_bucket_lookup(t->child[1]->attr.name);
-						 printf("[DEBUG] function type: %s, name: %s\n", l->type, l->name);
+						 if (TraceAnalyze) printf("[DEBUG] function type: %s, name: %s\n", l->type, l->name);
 							
 						 // main function type check
 						 if(!strcmp(l->name, "main") && strcmp(l->type, "void")){
 							printf("main function type must be void\n");
-							exit(1);
+							semanticError();
 						 }
 
 						 // main function parameter check
@@ -341,8 +408,11 @@ static void typeError(TreeNode * t, char * message)
 						 if(!strcmp(l->name, "main") && t->child[2]->kind.decl != 4) {
 						  	printf("[parameter] %d\n", t->child[2]->kind.decl);
 							printf("main function should not have parameters\n");
-							exit(1);
+							semanticError();
 						 }
+						 // a declaration of a function defined in another unit
+						 if(t->child[3] == NULL) break;
+
 						 // if return statement exist
 						 if(t->child[3]->child[1] != NULL){
 						 	 TreeNode *temp = t->child[3]->child[1];
@@ -351,22 +421,22 @@ static void typeError(TreeNode * t, char * message)
 							 // if function type is void and return statement exist
 							 if(!strcmp(l->type, "void") && temp->kind.stmt == 10){
 							  printf("void function can not have return statement\n");
-							  exit(1);
+							  semanticError();
 							 }
 
 							 if(!strcmp(l->type, "int") && temp->child[4] == NULL){
 								printf("int function return statement must have integer variable\n");
-								exit(1);
+								semanticError();
 							 }
 
-						 	 printf("[DEBUG] return statement %d\n", temp->kind.stmt);
+						 	 if (TraceAnalyze) printf("[DEBUG] return statement %d\n", temp->kind.stmt);
 						 }
 						 else{
 
 						  	if(strcmp(l->type, "void")){
 								
 							 	printf("int function must have return statement\n");
-								exit(1);
+								semanticError();
 							}
 
 
@@ -378,7 +448,7 @@ static void typeError(TreeNode * t, char * message)
 					case VarArrK:
 						if(t->child[0]->type == 0){
 						 	printf("variable type can not be void\n");
-							exit(1);
+							semanticError();
 						}
 						
 						break;
@@ -386,7 +456,7 @@ static void typeError(TreeNode * t, char * message)
 					case ParamArrK:
 						if(t->child[0]->type == 0){
 						 	printf("parameter type can not be void\n");
-							exit(1);
+							semanticError();
 						}
 						break;
 					case TypeK:
@@ -438,7 +508,14 @@ static void nullProc(TreeNode *t)
  * by a postorder syntax tree traversal
  */
 void buildSymtab(TreeNode * syntaxTree)
-{ traverse(syntaxTree,insertNode,nullProc, 0);
+{ func_location = global_location = 0;
+ global_check = 1;
+ isTypeCheck = 0;
+ /* the C-Minus runtime functions input() and output() are predeclared */
+ st_insert("input", 0, func_location++, "int", 0, "Func");
+ st_insert("output", 0, func_location++, "void", 0, "Func");
+ declarations = syntaxTree;
+ traverse(syntaxTree,insertNode,nullProc, 0);
  if (TraceAnalyze)
  { fprintf(listing,"\nSymbol table:\n\n");
   printSymTab(listing);
@@ -456,3 +533,70 @@ void typeCheck(TreeNode * syntaxTree)
   printSymTab(listing);
  }
 }
+
+int globalDataSize(void) {
+	return global_location / 4;
+}
+
+int functionCount(void) {
+	return func_location;
+}
+
+int declareGlobals(TreeNode *list) {
+	jmp_buf env;
+	TreeNode *t;
+	int k;
+
+	init();
+	set_curTable_head();
+	st_setVisible(-1);
+	func_location = global_location = 0;
+	global_check = 1;
+	isTypeCheck = 0;
+	st_insert("input", 0, func_location++, "int", 0, "Func");
+	st_insert("output", 0, func_location++, "void", 0, "Func");
+	recovery = &env;
+	if (setjmp(env)) {
+		recovery = NULL;
+		return FALSE;
+	}
+	declarations = list;
+	for (t = list, k = 1; t != NULL; t = t->sibling, ++k) {
+		if (t->nodekind != DeclK) continue;
+		insertNode(t);
+		/* a function is visible from its first declaration */
+		if (t->child[1]->bucket != NULL && t->child[1]->bucket->order == 0) t->child[1]->bucket->order = k;
+	}
+	recovery = NULL;
+	return TRUE;
+}
+
+int checkDeclaration(TreeNode *t, int order) {
+	jmp_buf env;
+	TreeNode *sibling = t->sibling;
+	int ok = FALSE;
+
+	st_dropScopes();
+	st_setVisible(order);
+	global_check = 1;
+	param_location = 0;
+	isTypeCheck = 0;
+	redeclare = TRUE;
+	t->sibling = NULL;
+	recovery = &env;
+	if (setjmp(env) == 0) {
+		traverse(t, insertNode, nullProc, 0);
+		set_curTable_head();
+		isTypeCheck = 1;
+		traverse(t, nullProc, checkNode, 0);
+		ok = TRUE;
+	}
+	recovery = NULL;
+	t->sibling = sibling;
+	redeclare = FALSE;
+	isTypeCheck = 0;
+	global_check = 1;
+	param_location = 0;
+	st_setVisible(-1);
+	return ok;
+}
@@ -12,4 +12,35 @@ void buildSymtab(TreeNode *);
 
 void typeCheck(TreeNode *);
 
+/* Function globalDataSize returns the number of words of data memory taken by the global variables */
+
+int globalDataSize(void);
+
+/* Function functionCount returns the number of functions declared, the built-in input and output included */
+
+int functionCount(void);
+
+/* Procedure semanticError ends the analysis after an error
+ * has been reported: the compiler exits, unless a declaration
+ * is checked by checkDeclaration
+ */
+
+void semanticError(void);
+
+/* Function declareGlobals enters the top-level declarations
+ * of the list into a new global scope, in order, and returns
+ * FALSE after an error
+ */
+
+int declareGlobals(TreeNode *);
+
+/* Function checkDeclaration builds the local scopes of the
+ * top-level declaration at position order in the list given
+ * to declareGlobals and type checks it against the global
+ * scope, seeing only the declarations before it; it returns
+ * FALSE after an error
+ */
+
+int checkDeclaration(TreeNode *, int order);
+
 #endif
@@ -0,0 +1,240 @@
+/* FILE: ast.c */
+/* Binary syntax trees: the nodes of a tree are numbered in */
+/* preorder and written as fixed-width records linked by */
+/* index, so reading one back is a single pass over a */
+/* mapping with no scanning or parsing */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "util.h"
+#include "ast.h"
+
+static AstNode *records;
+static int nrecords, recordCap;
+static char *names;
+static int nameBytes, nameCap;
+
+static int addName(char *name) {
+	int n = strlen(name) + 1, offset = nameBytes;
+
+	while (nameBytes + n > nameCap) {
+		nameCap = nameCap > 0 ? 2 * nameCap : 4096;
+		names = (char *)realloc(names, nameCap);
+	}
+	memcpy(names + nameBytes, name, n);
+	nameBytes += n;
+	return offset;
+}
+
+static int addRecord(TreeNode *t) {
+	AstNode *r;
+
+	if (nrecords == recordCap) {
+		recordCap = recordCap > 0 ? 2 * recordCap : 1024;
+		records = (AstNode *)realloc(records, recordCap * sizeof(AstNode));
+	}
+	r = &records[nrecords];
+	r->sibling = -1;
+	r->lineno = t->lineno;
+	r->nodekind = t->nodekind;
+	r->kind = t->kind.stmt;
+	if (t->nodekind == ExpK && t->kind.exp == IdK) r->attr = addName(t->attr.name);
+	else if (t->nodekind == ExpK && t->kind.exp == ConstK) r->attr = t->attr.val;
+	else r->attr = 0;
+	r->arraySize = t->arraySize;
+	r->type = t->type;
+	return nrecords++;
+}
+
+/* Function flatten adds the records of t and its siblings
+ * and returns the index of the first, -1 for none
+ */
+static int flatten(TreeNode *t) {
+	int first = -1, prev = -1, i, k, c;
+
+	for (; t != NULL; t = t->sibling) {
+		i = addRecord(t);
+		if (prev < 0) first = i;
+		else records[prev].sibling = i;
+		for (k = 0; k < MAXCHILDREN; ++k) {
+			/* records moves as it grows */
+			c = flatten(t->child[k]);
+			records[i].child[k] = c;
+		}
+		prev = i;
+	}
+	return first;
+}
+
+int astWrite(TreeNode *tree, FILE *f) {
+	AstHeader h;
+	int ok;
+
+	nrecords = nameBytes = 0;
+	memcpy(h.magic, AST_MAGIC, 4);
+	h.root = flatten(tree);
+	h.nnodes = nrecords;
+	h.nameBytes = nameBytes;
+	ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+		fwrite(records, sizeof(AstNode), nrecords, f) == (size_t)nrecords &&
+		fwrite(names, 1, nameBytes, f) == (size_t)nameBytes;
+	return ok ? nrecords : -1;
+}
+
+/* the nodes some record links to */
+static char *linked;
+
+/* Function badLink returns TRUE unless link is NULL or a
+ * node after node i, as preorder numbers them, that no
+ * other record links to; a file that passes is a tree
+ */
+static int badLink(int32_t link, int i, int32_t nnodes) {
+	if (link == -1) return FALSE;
+	if (link <= i || link >= nnodes || linked[link]) return TRUE;
+	linked[link] = TRUE;
+	return FALSE;
+}
+
+/* Function badChild returns TRUE if link c is NULL or to a
+ * record that is not of the given nodekind and, unless kind
+ * is -1, kind
+ */
+static int badChild(AstNode *r, int32_t c, int nodekind, int kind) {
+	return c == -1 || r[c].nodekind != nodekind || (kind != -1 && r[c].kind != kind);
+}
+
+/* Function badShape returns TRUE if record i, whose links
+ * are known to be good, has a kind outside the enums or lacks
+ * a child the analyzer and code generator follow without
+ * looking; the lists a parse makes hold one nodekind only,
+ * and an operator is a TypeK holding its token
+ */
+static int badShape(AstNode *r, int i) {
+	AstNode *n = &r[i];
+	int32_t *c = n->child;
+
+	if (n->sibling != -1 && r[n->sibling].nodekind != n->nodekind) return TRUE;
+	switch (n->nodekind) {
+		case StmtK:
+			switch (n->kind) {
+				case CompoundStmtK:
+					return (c[0] != -1 && r[c[0]].nodekind != DeclK) || (c[1] != -1 && r[c[1]].nodekind != StmtK);
+				case ExpressionStmtK:
+					return c[2] != -1 && r[c[2]].nodekind != ExpK;
+				case SelectionStmtK:
+					return badChild(r, c[3], ExpK, -1) || badChild(r, c[4], StmtK, -1) ||
+						(c[5] != -1 && r[c[5]].nodekind != StmtK);
+				case IterationStmtK:
+					return badChild(r, c[3], ExpK, -1) || badChild(r, c[4], StmtK, -1);
+				case ReturnStmtK:
+					return c[4] != -1 && r[c[4]].nodekind != ExpK;
+				default:
+					return n->kind < IfK || n->kind > ReturnStmtK;
+			}
+		case ExpK:
+			switch (n->kind) {
+				case ArrK:
+					return badChild(r, c[5], ExpK, IdK) || badChild(r, c[1], ExpK, -1);
+				case LvarK:
+					return badChild(r, c[0], ExpK, -1) || (r[c[0]].kind != IdK && r[c[0]].kind != ArrK) ||
+						badChild(r, c[1], ExpK, -1);
+				case ComparisionExpK: case AdditiveExpK: case MultiplicativeExpK:
+					return badChild(r, c[3], DeclK, TypeK) || badChild(r, r[c[3]].child[2], ExpK, -1) ||
+						badChild(r, r[c[3]].child[4], ExpK, -1);
+				case CallK:
+					return badChild(r, c[5], ExpK, IdK) || (c[6] != -1 && r[c[6]].nodekind != ExpK);
+				default:
+					return n->kind < OpK || n->kind > CallK;
+			}
+		case DeclK:
+			switch (n->kind) {
+				case VarArrK:
+					if (badChild(r, c[4], ExpK, ConstK)) return TRUE;
+					/* fall through */
+				case VarK: case ParamK: case ParamArrK:
+					return badChild(r, c[0], DeclK, TypeK) || badChild(r, c[1], ExpK, IdK);
+				case FuncK:
+					/* a prototype has no body */
+					return badChild(r, c[0], DeclK, TypeK) || badChild(r, c[1], ExpK, IdK) ||
+						badChild(r, c[2], DeclK, -1) || (c[3] != -1 && badChild(r, c[3], StmtK, CompoundStmtK));
+				default:
+					return n->kind < VarK || n->kind > TypeK;
+			}
+		default:
+			return TRUE;
+	}
+}
+
+TreeNode *astRead(FILE *f, int *nodes) {
+	struct stat st;
+	AstHeader *h;
+	AstNode *r;
+	char *text;
+	TreeNode **t, *tree = NULL;
+	int i, k;
+
+	*nodes = 0;
+	if (fstat(fileno(f), &st) < 0 || st.st_size < (off_t)sizeof(AstHeader)) {
+		fprintf(listing, "Truncated syntax tree\n");
+		return NULL;
+	}
+	h = (AstHeader *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (h == MAP_FAILED) {
+		fprintf(listing, "Unable to map syntax tree\n");
+		return NULL;
+	}
+	if (memcmp(h->magic, AST_MAGIC, 4) || h->nnodes < 0 || h->nameBytes < 0 ||
+			st.st_size != (off_t)(sizeof(AstHeader) + (off_t)h->nnodes * sizeof(AstNode) + h->nameBytes) ||
+			h->root < -1 || h->root >= h->nnodes || (h->root == -1 && h->nnodes > 0) ||
+			(h->nameBytes > 0 && ((char *)h)[st.st_size - 1] != '\0')) {
+		fprintf(listing, "Bad syntax tree file\n");
+		munmap(h, st.st_size);
+		return NULL;
+	}
+	r = (AstNode *)(h + 1);
+	text = (char *)(r + h->nnodes);
+
+	/* every index is checked before any node is linked */
+	linked = (char *)calloc(h->nnodes + 1, 1);
+	for (i = 0; i < h->nnodes; ++i) {
+		int bad = badLink(r[i].sibling, i, h->nnodes);
+
+		for (k = 0; k < MAXCHILDREN; ++k) bad |= badLink(r[i].child[k], i, h->nnodes);
+		if (r[i].nodekind == ExpK && r[i].kind == IdK) bad |= r[i].attr < 0 || r[i].attr >= h->nameBytes;
+		if (bad) {
+			fprintf(listing, "Bad syntax tree node %d\n", i);
+			free(linked);
+			munmap(h, st.st_size);
+			return NULL;
+		}
+	}
+	free(linked);
+	/* then what the links lead to */
+	for (i = 0; i < h->nnodes; ++i)
+		if (badShape(r, i) || (i == h->root && r[i].nodekind != DeclK)) {
+			fprintf(listing, "Bad syntax tree node %d\n", i);
+			munmap(h, st.st_size);
+			return NULL;
+		}
+	t = (TreeNode **)malloc((h->nnodes + 1) * sizeof(TreeNode *));
+	for (i = 0; i < h->nnodes; ++i) {
+		t[i] = newStmtNode(IfK);
+		t[i]->lineno = r[i].lineno;
+		t[i]->nodekind = (NodeKind)r[i].nodekind;
+		t[i]->kind.stmt = (StmtKind)r[i].kind;
+		if (r[i].nodekind == ExpK && r[i].kind == IdK) t[i]->attr.name = internString(text + r[i].attr, strlen(text + r[i].attr));
+		else t[i]->attr.val = r[i].attr;
+		t[i]->arraySize = r[i].arraySize;
+		t[i]->type = (ExpType)r[i].type;
+	}
+	for (i = 0; i < h->nnodes; ++i) {
+		for (k = 0; k < MAXCHILDREN; ++k) t[i]->child[k] = r[i].child[k] >= 0 ? t[r[i].child[k]] : NULL;
+		t[i]->sibling = r[i].sibling >= 0 ? t[r[i].sibling] : NULL;
+	}
+	if (h->root >= 0) tree = t[h->root];
+	*nodes = h->nnodes;
+	free(t);
+	munmap(h, st.st_size);
+	return tree;
+}
@@ -0,0 +1,50 @@
+/* FILE: ast.h */
+/* Binary syntax trees of the C-Minus compiler, written after */
+/* parsing and mapped back instead of parsing again */
+
+#ifndef _AST_H_
+#define _AST_H_
+
+#include <stdint.h>
+
+#define AST_MAGIC "CMA1"
+
+/* the file starts with a header, then holds nnodes node
+ * records and nameBytes bytes of identifier names, each
+ * ending with a NUL, in the byte order of the machine that
+ * wrote it; root is the first top-level declaration
+ */
+typedef struct {
+	char magic[4];
+	int32_t nnodes;
+	int32_t root;
+	int32_t nameBytes;
+} AstHeader;
+
+/* links are node indices, -1 for NULL; attr is the offset
+ * of the name of an IdK node, the value of a ConstK node
+ * and 0 otherwise
+ */
+typedef struct {
+	int32_t child[MAXCHILDREN];
+	int32_t sibling;
+	int32_t lineno;
+	int32_t nodekind;
+	int32_t kind;
+	int32_t attr;
+	int32_t arraySize;
+	int32_t type;
+} AstNode;
+
+/* Function astWrite writes the tree to file f and returns
+ * the number of nodes, -1 if it cannot be written
+ */
+int astWrite(TreeNode *tree, FILE *f);
+
+/* Function astRead maps the file f written by astWrite and
+ * returns its tree, with *nodes set to the number of nodes,
+ * or NULL with an error on the listing if it is not one
+ */
+TreeNode *astRead(FILE *f, int *nodes);
+
+#endif
@@ -0,0 +1,119 @@
+#!/bin/sh
+# Compiler benchmark: compiles a fixed corpus, programs written
+# by cmgen and the test cases, several times with -time-phases
+# and reports the lines and tokens per second of every phase,
+# the peak memory and the allocations.  The result is compared
+# with a baseline file, failing if a phase got slower, or the
+# memory or allocations grew, by more than the threshold percent;
+# with -save the result becomes the baseline instead.  The rates
+# are those of one machine, so the baseline is saved locally and
+# not kept in the repository; without one nothing is compared.
+#
+# usage: bench.sh [-runs=N] [-threshold=PERCENT] [-save] <baseline>
+
+runs=3
+threshold=10
+save=no
+while [ $# -gt 1 ]; do
+	case $1 in
+	-runs=*) runs=${1#-runs=} ;;
+	-threshold=*) threshold=${1#-threshold=} ;;
+	-save) save=yes ;;
+	*) break ;;
+	esac
+	shift
+done
+if [ $# -ne 1 ]; then
+	echo "usage: $0 [-runs=N] [-threshold=PERCENT] [-save] <baseline>" >&2
+	exit 1
+fi
+baseline=$1
+here=$(dirname "$0")
+compiler=$here/../project3_2
+cmgen=$here/../cmgen
+allocs=$here/tools/allocs.so
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# the generated part of the corpus: many small functions, deep
+# nesting with many calls, and many long names
+$cmgen -seed=1 -lines=20000 > "$work/wide.c" || exit 1
+$cmgen -seed=2 -functions=300 -statements=60 -depth=5 -calls=30 > "$work/deep.c" || exit 1
+$cmgen -seed=3 -functions=500 -globals=400 -idlen=30 > "$work/names.c" || exit 1
+cp "$here"/../testcase/*.c "$here"/*.c "$work"/
+
+# one line per file and run: the PHASES line and the allocations
+for run in $(seq "$runs"); do
+	for f in "$work"/*.c; do
+		LD_PRELOAD=$allocs $compiler -O -time-phases "$f" 2>&1 >/dev/null |
+			grep "^PHASES\|^ALLOCS" | tr '\n' ' ' | sed "s|^|$(basename "$f") |"
+		echo
+	done
+done > "$work/runs"
+
+if [ $save = no ] && [ ! -f "$baseline" ]; then
+	echo "no baseline $baseline, nothing compared; make bench-baseline saves one" >&2
+fi
+
+# the best run of every file, summed over the corpus
+awk -v save="$save" -v baseline="$baseline" -v threshold="$threshold" '
+{
+	gsub(",", "")
+	file = $1
+	for (i = 2; i <= NF; i++) {
+		if ($i == "lines") lines[file] = $(i + 1)
+		else if ($i == "tokens") tokens[file] = $(i + 1)
+		else if ($i == "peak") { if ($(i + 1) > peak) peak = $(i + 1) }
+		else if ($i == "ALLOCS:") allocs[file] = $(i + 1)
+		else if ($i == "parse" || $i == "analyze" || $i == "ir" || $i == "optimize" || $i == "codegen") {
+			key = file SUBSEP $i
+			if (!(key in best) || $(i + 1) < best[key]) best[key] = $(i + 1)
+		}
+	}
+}
+END {
+	nphases = split("parse analyze ir optimize codegen", phase, " ")
+	for (f in lines) { totalLines += lines[f]; totalTokens += tokens[f]; totalAllocs += allocs[f] }
+	for (key in best) { split(key, part, SUBSEP); us[part[2]] += best[key] }
+
+	while ((getline line < baseline) > 0) {
+		split(line, field, " ")
+		base[field[1]] = field[2]
+	}
+	printf "%d lines, %d tokens\n", totalLines, totalTokens
+	printf "%-12s %14s %14s %14s %8s\n", "", "lines/s", "tokens/s", "baseline", "change"
+	failed = 0
+	for (k = 1; k <= nphases; k++) {
+		p = phase[k]
+		rate[p] = us[p] > 0 ? totalLines * 1000000 / us[p] : 0
+		tokenRate = us[p] > 0 ? totalTokens * 1000000 / us[p] : 0
+		change = ""
+		if (base[p] > 0 && rate[p] > 0) {
+			change = sprintf("%+.1f%%", 100 * (rate[p] - base[p]) / base[p])
+			if (rate[p] < base[p] * (1 - threshold / 100)) { change = change " SLOWER"; failed = 1 }
+		}
+		printf "%-12s %14d %14d %14d %8s\n", p, rate[p], tokenRate, base[p], change
+	}
+	rate["peak"] = peak
+	rate["allocations"] = totalAllocs
+	split("peak allocations", sizes, " ")
+	for (k = 1; k <= 2; k++) {
+		p = sizes[k]
+		change = ""
+		if (base[p] > 0) {
+			change = sprintf("%+.1f%%", 100 * (rate[p] - base[p]) / base[p])
+			if (rate[p] > base[p] * (1 + threshold / 100)) { change = change " MORE"; failed = 1 }
+		}
+		printf "%-12s %14d %14s %14d %8s\n", p == "peak" ? "peak KB" : p, rate[p], "", base[p], change
+	}
+
+	if (save == "yes") {
+		for (k = 1; k <= nphases; k++) printf "%s %d\n", phase[k], rate[phase[k]] > baseline
+		printf "peak %d\nallocations %d\n", peak, totalAllocs > baseline
+		print "saved " baseline
+		exit 0
+	}
+	if (failed) print "REGRESSION over " threshold "%"
+	exit failed
+}' "$work/runs"
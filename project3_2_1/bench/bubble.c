@@ -0,0 +1,49 @@
+/* Bubble sort of 300 pseudo-random numbers: prints the smallest,
+ * the largest and a position-weighted checksum
+ */
+
+void sort(int x[], int n) {
+	int i;
+	int j;
+	int t;
+
+	i = 0;
+	while (i < n - 1) {
+		j = 0;
+		while (j < n - 1 - i) {
+			if (x[j] > x[j + 1]) {
+				t = x[j];
+				x[j] = x[j + 1];
+				x[j + 1] = t;
+			}
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+}
+
+void main(void) {
+	int v[300];
+	int i;
+	int seed;
+	int sum;
+
+	seed = 12345;
+	i = 0;
+	while (i < 300) {
+		seed = seed * 1103 + 12345;
+		seed = seed - seed / 32768 * 32768;
+		v[i] = seed;
+		i = i + 1;
+	}
+	sort(v, 300);
+	sum = 0;
+	i = 0;
+	while (i < 300) {
+		sum = sum + v[i] * (i + 1) - sum / 1000 * 1000;
+		i = i + 1;
+	}
+	output(v[0]);
+	output(v[299]);
+	output(sum);
+}
@@ -0,0 +1,56 @@
+/* Tiny helper functions called from hot loops: prints a checksum */
+
+int table[100];
+
+int square(int x) {
+	return x * x;
+}
+
+int max(int a, int b) {
+	if (a > b) return a;
+	return b;
+}
+
+int clamp(int x, int lo, int hi) {
+	return max(lo, hi - max(hi - x, 0));
+}
+
+int get(int v[], int i) {
+	return v[i];
+}
+
+void put(int v[], int i, int x) {
+	v[i] = x;
+}
+
+int sumsq(int n) {
+	int i;
+	int sum;
+
+	sum = 0;
+	i = 0;
+	while (i < n) {
+		sum = sum + square(get(table, i));
+		i = i + 1;
+	}
+	return sum;
+}
+
+void main(void) {
+	int i;
+	int round;
+	int total;
+
+	total = 0;
+	round = 0;
+	while (round < 50) {
+		i = 0;
+		while (i < 100) {
+			put(table, i, clamp(i * round - 2000, 0 - 50, 50));
+			i = i + 1;
+		}
+		total = total + sumsq(100) / 100;
+		round = round + 1;
+	}
+	output(total);
+}
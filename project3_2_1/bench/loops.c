@@ -0,0 +1,28 @@
+/* Nested loops whose bodies recompute values that do not
+ * change inside the loop: prints a checksum
+ */
+
+int scale;
+
+int kernel(int n, int m) {
+	int i;
+	int j;
+	int sum;
+
+	sum = 0;
+	i = 0;
+	while (i < n) {
+		j = 0;
+		while (j < m) {
+			sum = sum + (n * m + scale * 3) / (i + 1) + i * n * m;
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+	return sum;
+}
+
+void main(void) {
+	scale = 7;
+	output(kernel(60, 50));
+}
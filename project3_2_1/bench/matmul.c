@@ -0,0 +1,61 @@
+/* Matrix product of two 20x20 matrices stored row-major:
+ * prints the trace of the result
+ */
+
+int a[400];
+int b[400];
+int c[400];
+
+void fill(int n) {
+	int i;
+	int j;
+
+	i = 0;
+	while (i < n) {
+		j = 0;
+		while (j < n) {
+			a[i * n + j] = i + j;
+			b[i * n + j] = i * 2 - j;
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+}
+
+void multiply(int n) {
+	int i;
+	int j;
+	int k;
+	int sum;
+
+	i = 0;
+	while (i < n) {
+		j = 0;
+		while (j < n) {
+			sum = 0;
+			k = 0;
+			while (k < n) {
+				sum = sum + a[i * n + k] * b[k * n + j];
+				k = k + 1;
+			}
+			c[i * n + j] = sum;
+			j = j + 1;
+		}
+		i = i + 1;
+	}
+}
+
+void main(void) {
+	int i;
+	int trace;
+
+	fill(20);
+	multiply(20);
+	trace = 0;
+	i = 0;
+	while (i < 20) {
+		trace = trace + c[i * 20 + i];
+		i = i + 1;
+	}
+	output(trace);
+}
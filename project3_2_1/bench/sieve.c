@@ -0,0 +1,33 @@
+/* Sieve of Eratosthenes: prints the number of primes below 5000 */
+
+int flag[5000];
+
+int sieve(int n) {
+	int i;
+	int j;
+	int count;
+
+	i = 0;
+	while (i < n) {
+		flag[i] = 1;
+		i = i + 1;
+	}
+	count = 0;
+	i = 2;
+	while (i < n) {
+		if (flag[i] == 1) {
+			count = count + 1;
+			j = i + i;
+			while (j < n) {
+				flag[j] = 0;
+				j = j + i;
+			}
+		}
+		i = i + 1;
+	}
+	return count;
+}
+
+void main(void) {
+	output(sieve(5000));
+}
@@ -0,0 +1,32 @@
+/* FILE: allocs.c */
+/* Allocation counter for the benchmarks: preloaded into the */
+/* compiler, it counts the calls of malloc, calloc and realloc */
+/* and prints the count to stderr at exit */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+
+static long allocations = 0;
+
+void *malloc(size_t n) {
+	allocations++;
+	return __libc_malloc(n);
+}
+
+void *calloc(size_t n, size_t size) {
+	allocations++;
+	return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t n) {
+	allocations++;
+	return __libc_realloc(p, n);
+}
+
+__attribute__((destructor)) static void report(void) {
+	fprintf(stderr, "ALLOCS: %ld\n", allocations);
+}
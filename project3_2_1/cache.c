@@ -0,0 +1,289 @@
+/* FILE: cache.c */
+/* Compile cache of the C-Minus compiler: the listing and */
+/* the code file of a compilation are kept in a directory */
+/* under the hash of the source and the options, so an */
+/* unchanged source is never scanned or parsed again */
+
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "globals.h"
+#include "cache.h"
+
+#define PATHSIZE 1024
+
+/* a compilation is DIR/<key>.lst, its listing, and
+ * DIR/<key>.out, its code file if it has one; DIR/stats
+ * holds the hits and misses of all runs
+ */
+static char *cacheDir = NULL;
+static long cacheMax;
+static char key[17];
+static int hit = FALSE;
+
+static FILE *capture = NULL;	/* the listing while captured */
+static int savedStdout = -1;
+
+/* 64-bit FNV-1a */
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+static unsigned long long fnv(unsigned long long h, const void *p, size_t n) {
+	const unsigned char *s = (const unsigned char *)p;
+
+	while (n-- > 0) {
+		h ^= *s++;
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+static void entryPath(char *path, char *suffix) {
+	snprintf(path, PATHSIZE, "%s/%s.%s", cacheDir, key, suffix);
+}
+
+/* Function copyFile copies from to to, returning FALSE if
+ * either cannot be opened
+ */
+static int copyFile(FILE *from, char *to) {
+	char buf[8192];
+	size_t n;
+	FILE *out = fopen(to, "wb");
+
+	if (out == NULL) return FALSE;
+	while ((n = fread(buf, 1, sizeof(buf), from)) > 0) fwrite(buf, 1, n, out);
+	fclose(out);
+	return TRUE;
+}
+
+/* Procedure install copies from to the entry file of suffix
+ * through a temporary, so other compilers never read half
+ * of it
+ */
+static void install(FILE *from, char *suffix) {
+	char path[PATHSIZE], tmp[PATHSIZE + 16];
+
+	entryPath(path, suffix);
+	snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+	if (copyFile(from, tmp)) rename(tmp, path);
+	else remove(tmp);
+}
+
+static void countStats(int hits, int misses) {
+	char path[PATHSIZE];
+	long h = 0, m = 0;
+	FILE *f;
+
+	snprintf(path, PATHSIZE, "%s/stats", cacheDir);
+	if ((f = fopen(path, "r")) != NULL) {
+		if (fscanf(f, "%ld %ld", &h, &m) != 2) h = m = 0;
+		fclose(f);
+	}
+	if ((f = fopen(path, "w")) != NULL) {
+		fprintf(f, "%ld %ld\n", h + hits, m + misses);
+		fclose(f);
+	}
+}
+
+typedef struct {
+	char name[32];		/* the key */
+	time_t used;
+	long bytes;
+} Entry;
+
+static int byUse(const void *a, const void *b) {
+	time_t x = ((const Entry *)a)->used, y = ((const Entry *)b)->used;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Function scan returns the entries of the directory, the
+ * listing and code file of one key counting as one entry
+ * used when its listing was, and their total size in *total
+ */
+static Entry *scan(int *n, long *total) {
+	DIR *d = opendir(cacheDir);
+	struct dirent *e;
+	struct stat st;
+	char path[PATHSIZE];
+	Entry *entries = NULL;
+	int k, cap = 0;
+
+	*n = 0;
+	*total = 0;
+	if (d == NULL) return NULL;
+	while ((e = readdir(d)) != NULL) {
+		char *dot = strrchr(e->d_name, '.');
+
+		if (dot == NULL || dot - e->d_name != 16) continue;
+		if (strcmp(dot, ".lst") && strcmp(dot, ".out")) continue;
+		snprintf(path, PATHSIZE, "%s/%s", cacheDir, e->d_name);
+		if (stat(path, &st) != 0) continue;
+		for (k = 0; k < *n && strncmp(entries[k].name, e->d_name, 16); ++k);
+		if (k == *n) {
+			if (*n == cap) {
+				cap = cap > 0 ? 2 * cap : 64;
+				entries = (Entry *)realloc(entries, cap * sizeof(Entry));
+			}
+			strncpy(entries[k].name, e->d_name, 16);
+			entries[k].name[16] = '\0';
+			entries[k].used = st.st_mtime;
+			entries[k].bytes = 0;
+			(*n)++;
+		}
+		if (!strcmp(dot, ".lst")) entries[k].used = st.st_mtime;
+		entries[k].bytes += st.st_size;
+		*total += st.st_size;
+	}
+	closedir(d);
+	return entries;
+}
+
+/* Procedure evict removes the least recently used entries
+ * until the cache fits in its size
+ */
+static void evict(void) {
+	char path[PATHSIZE];
+	long total;
+	int n, k;
+	Entry *entries = scan(&n, &total);
+
+	qsort(entries, n, sizeof(Entry), byUse);
+	for (k = 0; k < n && total > cacheMax; ++k) {
+		/* never the entry just stored */
+		if (!strcmp(entries[k].name, key)) continue;
+		snprintf(path, PATHSIZE, "%s/%s.lst", cacheDir, entries[k].name);
+		remove(path);
+		snprintf(path, PATHSIZE, "%s/%s.out", cacheDir, entries[k].name);
+		remove(path);
+		total -= entries[k].bytes;
+	}
+	free(entries);
+}
+
+void cacheOpen(char *dir, long maxBytes) {
+	cacheDir = dir;
+	cacheMax = maxBytes;
+	mkdir(dir, 0777);
+}
+
+void cacheKey(FILE *src, char **opts, int nopts, char *codefile) {
+	static char stamp[] = __DATE__ " " __TIME__;
+	unsigned long long h = FNV_OFFSET;
+	char buf[8192];
+	struct stat st;
+	size_t n;
+	int k;
+
+	/* a rebuilt compiler may compile differently: the binary
+	 * as a whole is told by its file, any pass relinked into
+	 * it changing its size or time
+	 */
+	if (stat("/proc/self/exe", &st) == 0) {
+		n = snprintf(buf, sizeof(buf), "%llu %llu %lld %lld.%09ld", (unsigned long long)st.st_dev,
+			(unsigned long long)st.st_ino, (long long)st.st_size, (long long)st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+		h = fnv(h, buf, n);
+	}
+	else h = fnv(h, stamp, sizeof(stamp));
+	for (k = 0; k < nopts; ++k) h = fnv(h, opts[k], strlen(opts[k]) + 1);
+	/* the name of the code file is written into it */
+	h = fnv(h, codefile, strlen(codefile) + 1);
+	while ((n = fread(buf, 1, sizeof(buf), src)) > 0) h = fnv(h, buf, n);
+	rewind(src);
+	snprintf(key, sizeof(key), "%016llx", h);
+}
+
+int cacheFetch(char *codefile) {
+	char path[PATHSIZE];
+	FILE *lst, *out;
+	size_t n;
+	char buf[8192];
+
+	if (cacheDir == NULL) return FALSE;
+	entryPath(path, "lst");
+	if ((lst = fopen(path, "rb")) == NULL) {
+		countStats(0, 1);
+		return FALSE;
+	}
+	/* the code file first: a hit must leave it as a compilation would */
+	entryPath(path, "out");
+	if ((out = fopen(path, "rb")) != NULL) {
+		int copied = copyFile(out, codefile);
+
+		fclose(out);
+		if (!copied) {
+			fclose(lst);
+			countStats(0, 1);
+			return FALSE;
+		}
+		utime(path, NULL);
+	}
+	while ((n = fread(buf, 1, sizeof(buf), lst)) > 0) fwrite(buf, 1, n, stdout);
+	fclose(lst);
+	entryPath(path, "lst");
+	utime(path, NULL);
+	hit = TRUE;
+	countStats(1, 0);
+	return TRUE;
+}
+
+/* Procedure release ends the capture of stdout and echoes
+ * what was captured; it also runs at exit
+ */
+static void release(void) {
+	char buf[8192];
+	size_t n;
+
+	if (capture == NULL || savedStdout < 0) return;
+	fflush(stdout);
+	dup2(savedStdout, 1);
+	close(savedStdout);
+	savedStdout = -1;
+	rewind(capture);
+	while ((n = fread(buf, 1, sizeof(buf), capture)) > 0) fwrite(buf, 1, n, stdout);
+	fflush(stdout);
+}
+
+void cacheBegin(void) {
+	if (cacheDir == NULL || capture != NULL) return;
+	if ((capture = tmpfile()) == NULL) return;
+	fflush(stdout);
+	savedStdout = dup(1);
+	dup2(fileno(capture), 1);
+	atexit(release);
+}
+
+void cacheStore(char *codefile) {
+	FILE *out;
+
+	if (capture == NULL) return;
+	release();
+	if (codefile != NULL) {
+		if ((out = fopen(codefile, "rb")) == NULL) return;
+		install(out, "out");
+		fclose(out);
+	}
+	rewind(capture);
+	install(capture, "lst");
+	fclose(capture);
+	capture = NULL;
+	evict();
+}
+
+void cacheReport(void) {
+	char path[PATHSIZE];
+	long h = 0, m = 0, total;
+	int n;
+	FILE *f;
+
+	if (cacheDir == NULL) return;
+	snprintf(path, PATHSIZE, "%s/stats", cacheDir);
+	if ((f = fopen(path, "r")) != NULL) {
+		if (fscanf(f, "%ld %ld", &h, &m) != 2) h = m = 0;
+		fclose(f);
+	}
+	free(scan(&n, &total));
+	fprintf(stderr, "CACHE: %s %s, %ld hits, %ld misses, %d entries, %ld of %ld bytes\n",
+		hit ? "hit" : "miss", key, h, m, n, total, cacheMax);
+}
@@ -0,0 +1,40 @@
+/* FILE: cache.h */
+/* Compile cache of the C-Minus compiler, keyed by the */
+/* content of the source and the compiler options */
+
+#ifndef _CACHE_H_
+#define _CACHE_H_
+
+/* Procedure cacheOpen keeps compilations in directory dir,
+ * creating it if needed, and evicts the least recently used
+ * ones beyond maxBytes
+ */
+void cacheOpen(char *dir, long maxBytes);
+
+/* Procedure cacheKey hashes the bytes of the source file, the
+ * nopts options that affect the output and the code file name
+ * into the key of this compilation, and rewinds the source
+ */
+void cacheKey(FILE *src, char **opts, int nopts, char *codefile);
+
+/* Function cacheFetch returns TRUE on a hit, after writing the
+ * cached code file and echoing the cached listing to stdout
+ */
+int cacheFetch(char *codefile);
+
+/* Procedure cacheBegin captures stdout, the listing, until
+ * cacheStore or the exit of the compiler
+ */
+void cacheBegin(void);
+
+/* Procedure cacheStore keeps the captured listing and the code
+ * file, NULL if none was written, under the key
+ */
+void cacheStore(char *codefile);
+
+/* Procedure cacheReport prints the hits and misses of the cache
+ * and its size to stderr
+ */
+void cacheReport(void);
+
+#endif
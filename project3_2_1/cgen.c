@@ -0,0 +1,348 @@
+/* FILE: cgen.c */
+/* TM code generator for the C-Minus compiler */
+/* Every virtual register of a function lives in a stack */
+/* slot of its frame; instructions work through ac and ac1 */
+
+#include "globals.h"
+#include "symtab.h"
+#include "analyze.h"
+#include "ir.h"
+#include "code.h"
+#include "cgen.h"
+#include "x86gen.h"
+
+/* Patch records a jump whose target was not yet emitted */
+typedef struct PatchRec {
+	int loc;
+	char *op;
+	int reg;
+	IrBlock target;		/* jump to a block, or */
+	int func;		/* call to the function with this memloc */
+	char *name;		/* and name */
+	struct PatchRec *next;
+} * Patch;
+
+static Patch blockPatches;
+static Patch callPatches;
+
+static int *blockLoc;		/* code location of every block, -1 if not emitted */
+static int *funcLoc;		/* code location of every function by memloc */
+static int *slot;		/* frame offset of every register */
+
+static void addPatch(Patch *list, int loc, char *op, int reg, IrBlock target, int func) {
+	Patch p = (Patch)malloc(sizeof(struct PatchRec));
+
+	p->loc = loc;
+	p->op = op;
+	p->reg = reg;
+	p->target = target;
+	p->func = func;
+	p->name = NULL;
+	p->next = *list;
+	*list = p;
+}
+
+/* Procedure emitJump emits op reg,target with target a block */
+
+static void emitJump(char *op, int reg, IrBlock target, char *c) {
+	if (blockLoc[target->id] >= 0) emitRM_Abs(op, reg, blockLoc[target->id], c);
+	else addPatch(&blockPatches, emitSkip(1), op, reg, target, -1);
+}
+
+/* Procedure emitCallTo transfers control to the function with
+ * memloc f; calls to functions not yet emitted, or defined in
+ * another unit, are patched at the end
+ */
+static void emitCallTo(int f, char *name) {
+	if (funcLoc[f] >= 0) {
+		emitRM("LDC", pc, funcLoc[f], 0, name);
+		emitReloc(RelCode, NULL);
+	}
+	else {
+		addPatch(&callPatches, emitSkip(1), "LDC", pc, NULL, f);
+		callPatches->name = name;
+	}
+}
+
+/* Procedure emitCall emits the calling sequence: arguments are
+ * stored below sp, the first one highest, then the caller's fp
+ * is saved at the base of the new frame and control transfers
+ * with the return address in ac
+ */
+static void emitCall(IrInstr i) {
+	int k, f = i->sym->memloc;
+
+	emitComment("-> call");
+	for (k = 0; k < i->nargs; ++k) {
+		emitRM("LD", ac, slot[i->args[k]], fp, "load argument");
+		emitRM("ST", ac, -k, sp, "push argument");
+	}
+	emitRM("ST", fp, -i->nargs, sp, "save frame pointer");
+	emitRM("LDA", fp, -i->nargs, sp, "new frame");
+	emitRM("LDA", ac, 1, pc, "return address");
+	emitCallTo(f, i->name);
+	emitComment("<- call");
+}
+
+/* Procedure emitTailCall transfers control to the callee of a tail
+ * call in place of the current frame: the arguments are staged
+ * below sp and moved to the top of the frame, where the caller
+ * put ours, and the new frame keeps our caller's frame pointer
+ * and return address, so the callee returns straight to it
+ */
+static void emitTailCall(IrFunc f, IrInstr i) {
+	int k, m = f->nparams, n = i->nargs, g = i->sym->memloc;
+
+	emitComment("-> tail call");
+	emitRM("LD", ac2, 0, fp, "caller's frame pointer");
+	emitRM("LD", ac3, -1, fp, "caller's return address");
+	for (k = 0; k < n; ++k) {
+		emitRM("LD", ac, slot[i->args[k]], fp, "load argument");
+		emitRM("ST", ac, -k, sp, "stage argument");
+	}
+	for (k = 0; k < n; ++k) {
+		emitRM("LD", ac, -k, sp, "load staged argument");
+		emitRM("ST", ac, m - k, fp, "move argument");
+	}
+	emitRM("LDA", fp, m - n, fp, "reuse frame");
+	emitRM("ST", ac2, 0, fp, "keep caller's frame pointer");
+	emitRM("LDA", ac, 0, ac3, "keep return address");
+	emitCallTo(g, i->name);
+	emitComment("<- tail call");
+}
+
+static char *compareJump(IrOp op) {
+	switch (op) {
+		case IrLt: return "JLT";
+		case IrLe: return "JLE";
+		case IrGt: return "JGT";
+		case IrGe: return "JGE";
+		case IrEq: return "JEQ";
+		default: return "JNE";
+	}
+}
+
+static void genInstr(IrFunc f, IrInstr i) {
+	switch (i->op) {
+		case IrConst:
+			emitRM("LDC", ac, i->imm, 0, "load const");
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrCopy:
+			emitRM("LD", ac, slot[i->src[0]], fp, "copy");
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrAdd:
+		case IrSub:
+		case IrMul:
+		case IrDiv:
+			emitRM("LD", ac, slot[i->src[0]], fp, "load left");
+			emitRM("LD", ac1, slot[i->src[1]], fp, "load right");
+			emitRO(i->op == IrAdd ? "ADD" : i->op == IrSub ? "SUB" : i->op == IrMul ? "MUL" : "DIV",
+				ac, ac, ac1, (char *)irOpName(i->op));
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrLt: case IrLe: case IrGt: case IrGe: case IrEq: case IrNe:
+			emitRM("LD", ac, slot[i->src[0]], fp, "load left");
+			emitRM("LD", ac1, slot[i->src[1]], fp, "load right");
+			emitRO("SUB", ac, ac, ac1, (char *)irOpName(i->op));
+			emitRM(compareJump(i->op), ac, 2, pc, "br if true");
+			emitRM("LDC", ac, 0, ac, "false case");
+			emitRM("LDA", pc, 1, pc, "unconditional jmp");
+			emitRM("LDC", ac, 1, ac, "true case");
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrGAddr:
+			emitRM("LDA", ac, i->imm, gp, i->name != NULL ? i->name : "global address");
+			emitReloc(RelData, i->name);
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrLAddr:
+			emitRM("LDA", ac, i->imm, fp, i->name != NULL ? i->name : "local address");
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrLoad:
+			emitRM("LD", ac, slot[i->src[0]], fp, "load address");
+			emitRM("LD", ac, 0, ac, "load");
+			emitRM("ST", ac, slot[i->dst], fp, "store temp");
+			break;
+		case IrStore:
+			emitRM("LD", ac, slot[i->src[0]], fp, "load address");
+			emitRM("LD", ac1, slot[i->src[1]], fp, "load value");
+			emitRM("ST", ac1, 0, ac, "store");
+			break;
+		case IrCheck:
+			/* HALT 1 stops on a bounds check, the line in ac */
+			emitRM("LD", ac, slot[i->src[0]], fp, "load index");
+			emitRM("JLT", ac, 3, pc, "br if below bounds");
+			emitRM("LDC", ac1, i->imm, 0, i->name);
+			emitRO("SUB", ac1, ac, ac1, "index - size");
+			emitRM("JLT", ac1, 2, pc, "br if in bounds");
+			emitRM("LDC", ac, i->lineno, 0, "line");
+			emitRO("HALT", 1, 0, 0, "index out of bounds");
+			break;
+		case IrCall:
+			if (!strcmp(i->name, "input")) emitRO("IN", ac, 0, 0, "input");
+			else if (!strcmp(i->name, "output")) {
+				emitRM("LD", ac, slot[i->args[0]], fp, "load argument");
+				emitRO("OUT", ac, 0, 0, "output");
+			}
+			else emitCall(i);
+			if (i->dst >= 0) emitRM("ST", ac, slot[i->dst], fp, "store result");
+			break;
+		case IrTailCall:
+			emitTailCall(f, i);
+			break;
+		case IrRet:
+			if (i->src[0] >= 0) emitRM("LD", ac, slot[i->src[0]], fp, "return value");
+			emitRM("LD", ac1, -1, fp, "return address");
+			emitRM("LDA", sp, f->nparams, fp, "pop frame and arguments");
+			emitRM("LD", fp, 0, fp, "restore frame pointer");
+			emitRM("LDA", pc, 0, ac1, "return");
+			break;
+		case IrJump:
+			if (i->block->next != i->block->succ[0])
+				emitJump("LDA", pc, i->block->succ[0], "jump");
+			break;
+		case IrBranch:
+			emitRM("LD", ac, slot[i->src[0]], fp, "load condition");
+			if (i->block->next == i->block->succ[1] && i->block->next != i->block->succ[0]) {
+				/* the false side falls through */
+				emitJump("JNE", ac, i->block->succ[0], "br if true");
+				break;
+			}
+			emitJump("JEQ", ac, i->block->succ[1], "br if false");
+			if (i->block->next != i->block->succ[0])
+				emitJump("LDA", pc, i->block->succ[0], "jump");
+			break;
+		default:
+			break;
+	}
+}
+
+/* Function assignSlots gives every register a frame slot and
+ * returns the number of words of the frame below fp
+ */
+static int assignSlots(IrFunc f) {
+	int next = (f->frameSize > 1 ? f->frameSize : 1) + 1;
+	IrBlock b;
+	IrInstr i;
+	int k;
+
+	slot = (int *)realloc(slot, (f->nregs + 1) * sizeof(int));
+	for (k = 0; k < f->nregs; ++k) slot[k] = 0;
+	for (k = 0; k < f->nparams; ++k) slot[f->params[k]] = f->nparams - k;
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) {
+			if (i->dst >= 0 && slot[i->dst] == 0) slot[i->dst] = -next++;
+			for (k = 0; k < 2; ++k)
+				if (i->src[k] >= 0 && slot[i->src[k]] == 0) slot[i->src[k]] = -next++;
+			for (k = 0; k < i->nargs; ++k)
+				if (slot[i->args[k]] == 0) slot[i->args[k]] = -next++;
+		}
+	return next - 1;
+}
+
+static void genFunction(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	Patch p;
+	int words;
+	char buffer[100];
+
+	if (TraceCode) {
+		snprintf(buffer, sizeof(buffer), "-> function %s", f->name);
+		emitComment(buffer);
+	}
+	words = assignSlots(f);
+	blockLoc = (int *)realloc(blockLoc, f->nblocks * sizeof(int));
+	memset(blockLoc, -1, f->nblocks * sizeof(int));
+	funcLoc[f->sym->memloc] = emitSkip(0);
+	emitFunction(f->name, funcLoc[f->sym->memloc]);
+	emitRM("ST", ac, -1, fp, "store return address");
+	emitRM("LDA", sp, -words - 1, fp, "allocate frame");
+	for (b = f->entry; b != NULL; b = b->next) {
+		blockLoc[b->id] = emitSkip(0);
+		for (i = b->first; i != NULL; i = i->next) genInstr(f, i);
+	}
+	while (blockPatches != NULL) {
+		p = blockPatches;
+		blockPatches = p->next;
+		emitBackup(p->loc);
+		emitRM_Abs(p->op, p->reg, blockLoc[p->target->id], "jump");
+		emitRestore();
+		free(p);
+	}
+	if (TraceCode) {
+		snprintf(buffer, sizeof(buffer), "<- function %s", f->name);
+		emitComment(buffer);
+	}
+}
+
+void codeGen(IrProgram program, char *codefile) {
+	char *s;
+	IrFunc f, mainFunc = NULL;
+	IrGlobal g;
+	IrCounter c;
+	Patch p;
+	int nfuncs = functionCount();
+
+	if (NativeCode) {
+		x86CodeGen(program, codefile);
+		return;
+	}
+	s = malloc(strlen(codefile) + 7);
+	strcpy(s, "File: ");
+	strcat(s, codefile);
+	emitComment("C-Minus Compilation to TM Code");
+	emitComment(s);
+	free(s);
+
+	for (f = program->funcs; f != NULL; f = f->next)
+		if (!strcmp(f->name, "main")) mainFunc = f;
+	for (g = program->globals; g != NULL; g = g->next) emitData(g->name, g->base, g->words);
+	for (c = program->counters; c != NULL; c = c->next) emitProfile(c->kind, c->name, c->line, c->ordinal, c->word);
+	funcLoc = (int *)malloc((nfuncs + 1) * sizeof(int));
+	memset(funcLoc, -1, (nfuncs + 1) * sizeof(int));
+
+	/* generate standard prelude; for an object file the
+	 * linker puts it before the units
+	 */
+	if (!SeparateCompile) {
+		emitComment("Standard prelude:");
+		emitRM("LD", sp, 0, ac, "load maxaddress from location 0");
+		emitRM("ST", ac, 0, ac, "clear location 0");
+		emitRM("LDC", gp, 0, ac, "globals start at 0");
+		emitRM("LDA", fp, 0, sp, "outermost frame");
+		emitComment("End of standard prelude.");
+		if (mainFunc != NULL) {
+			IrInstr call = newInstr(IrCall, -1, -1, -1);
+			call->name = mainFunc->name;
+			call->sym = mainFunc->sym;
+			emitCall(call);
+			free(call);
+		}
+		emitRO("HALT", 0, 0, 0, "");
+	}
+
+	for (f = program->funcs; f != NULL; f = f->next) genFunction(f);
+
+	while (callPatches != NULL) {
+		p = callPatches;
+		callPatches = p->next;
+		emitBackup(p->loc);
+		if (funcLoc[p->func] >= 0) {
+			emitRM(p->op, p->reg, funcLoc[p->func], 0, "call");
+			emitReloc(RelCode, NULL);
+		}
+		else {
+			/* a function of another unit */
+			emitRM(p->op, p->reg, 0, 0, p->name);
+			emitReloc(RelImport, p->name);
+		}
+		emitRestore();
+		free(p);
+	}
+	emitComment("End of execution.");
+	emitFinish(globalDataSize() + program->ncounters);
+}
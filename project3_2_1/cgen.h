@@ -3,6 +3,13 @@
 #ifndef _CGEN_H_
 #define _CGEN_H_
 
-void codeGen(TreeNode * syntaxTree, char *codefile);
+#include "ir.h"
+
+/* Procedure codeGen generates TM code, or x86-64 assembly
+ * when NativeCode is set, to the code file from the IR of
+ * the program; codefile is the name of the code file and
+ * is used to print it as a comment
+ */
+void codeGen(IrProgram program, char *codefile);
 
 #endif
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.4"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,8 +66,8 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "cm.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 1 "cm.y"
 
 #define YYPARSER /* distinguishes Yacc output from other code files */
 
@@ -75,129 +80,200 @@
 #define YYSTYPE TreeNode *
 static int yylex(void);
 
-static char * savedName; /* for use in assignments */
-static int savedLineNo;  /* ditto */
+static int savedLineNo;  /* for use in declarations */
 static TreeNode * savedTree; /* stores syntax tree for later return */
 
 
-#line 84 "cm.tab.c" /* yacc.c:339  */
+#line 88 "cm.tab.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "cm.tab.h".  */
-#ifndef YY_YY_CM_TAB_H_INCLUDED
-# define YY_YY_CM_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    ELSE = 258,
-    IF = 259,
-    INT = 260,
-    RETURN = 261,
-    VOID = 262,
-    WHILE = 263,
-    ID = 264,
-    NUM = 265,
-    PLUS = 266,
-    MINUS = 267,
-    TIMES = 268,
-    OVER = 269,
-    LT = 270,
-    LE = 271,
-    GT = 272,
-    GE = 273,
-    EQ = 274,
-    NE = 275,
-    ASSIGN = 276,
-    SEMI = 277,
-    COMMA = 278,
-    LPAREN = 279,
-    RPAREN = 280,
-    LBRACKET = 281,
-    RBRACKET = 282,
-    LBRACE = 283,
-    RBRACE = 284,
-    THEN = 285,
-    END = 286,
-    REPEAT = 287,
-    UNTIL = 288,
-    READ = 289,
-    WRITE = 290,
-    ENDFILE = 291,
-    ERROR = 292,
-    LOWER_ELSE = 293
-  };
-#endif
+#include "cm.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_ELSE = 3,                       /* ELSE  */
+  YYSYMBOL_IF = 4,                         /* IF  */
+  YYSYMBOL_INT = 5,                        /* INT  */
+  YYSYMBOL_RETURN = 6,                     /* RETURN  */
+  YYSYMBOL_VOID = 7,                       /* VOID  */
+  YYSYMBOL_WHILE = 8,                      /* WHILE  */
+  YYSYMBOL_ID = 9,                         /* ID  */
+  YYSYMBOL_NUM = 10,                       /* NUM  */
+  YYSYMBOL_PLUS = 11,                      /* PLUS  */
+  YYSYMBOL_MINUS = 12,                     /* MINUS  */
+  YYSYMBOL_TIMES = 13,                     /* TIMES  */
+  YYSYMBOL_OVER = 14,                      /* OVER  */
+  YYSYMBOL_LT = 15,                        /* LT  */
+  YYSYMBOL_LE = 16,                        /* LE  */
+  YYSYMBOL_GT = 17,                        /* GT  */
+  YYSYMBOL_GE = 18,                        /* GE  */
+  YYSYMBOL_EQ = 19,                        /* EQ  */
+  YYSYMBOL_NE = 20,                        /* NE  */
+  YYSYMBOL_ASSIGN = 21,                    /* ASSIGN  */
+  YYSYMBOL_SEMI = 22,                      /* SEMI  */
+  YYSYMBOL_COMMA = 23,                     /* COMMA  */
+  YYSYMBOL_LPAREN = 24,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 25,                    /* RPAREN  */
+  YYSYMBOL_LBRACKET = 26,                  /* LBRACKET  */
+  YYSYMBOL_RBRACKET = 27,                  /* RBRACKET  */
+  YYSYMBOL_LBRACE = 28,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 29,                    /* RBRACE  */
+  YYSYMBOL_THEN = 30,                      /* THEN  */
+  YYSYMBOL_END = 31,                       /* END  */
+  YYSYMBOL_REPEAT = 32,                    /* REPEAT  */
+  YYSYMBOL_UNTIL = 33,                     /* UNTIL  */
+  YYSYMBOL_READ = 34,                      /* READ  */
+  YYSYMBOL_WRITE = 35,                     /* WRITE  */
+  YYSYMBOL_ENDFILE = 36,                   /* ENDFILE  */
+  YYSYMBOL_ERROR = 37,                     /* ERROR  */
+  YYSYMBOL_LOWER_ELSE = 38,                /* LOWER_ELSE  */
+  YYSYMBOL_YYACCEPT = 39,                  /* $accept  */
+  YYSYMBOL_program = 40,                   /* program  */
+  YYSYMBOL_declaration_list = 41,          /* declaration_list  */
+  YYSYMBOL_declaration = 42,               /* declaration  */
+  YYSYMBOL_variable_declaration = 43,      /* variable_declaration  */
+  YYSYMBOL_function_declaration = 44,      /* function_declaration  */
+  YYSYMBOL_type_check = 45,                /* type_check  */
+  YYSYMBOL__parameters = 46,               /* _parameters  */
+  YYSYMBOL_parameterList = 47,             /* parameterList  */
+  YYSYMBOL_param = 48,                     /* param  */
+  YYSYMBOL__compoundStatement = 49,        /* _compoundStatement  */
+  YYSYMBOL_local_declarations = 50,        /* local_declarations  */
+  YYSYMBOL_statement_list = 51,            /* statement_list  */
+  YYSYMBOL_statement = 52,                 /* statement  */
+  YYSYMBOL_expressionStmt = 53,            /* expressionStmt  */
+  YYSYMBOL_selectionStmt = 54,             /* selectionStmt  */
+  YYSYMBOL_iterationStmt = 55,             /* iterationStmt  */
+  YYSYMBOL_returnStmt = 56,                /* returnStmt  */
+  YYSYMBOL_expression = 57,                /* expression  */
+  YYSYMBOL_simple_expression = 58,         /* simple_expression  */
+  YYSYMBOL_relativeOp = 59,                /* relativeOp  */
+  YYSYMBOL_additive_expression = 60,       /* additive_expression  */
+  YYSYMBOL_addop = 61,                     /* addop  */
+  YYSYMBOL_term = 62,                      /* term  */
+  YYSYMBOL_mulop = 63,                     /* mulop  */
+  YYSYMBOL_factor = 64,                    /* factor  */
+  YYSYMBOL_call = 65,                      /* call  */
+  YYSYMBOL_args = 66,                      /* args  */
+  YYSYMBOL_arg_list = 67,                  /* arg_list  */
+  YYSYMBOL__var = 68,                      /* _var  */
+  YYSYMBOL__id = 69,                       /* _id  */
+  YYSYMBOL__num = 70                       /* _num  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef int YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
 
 
-extern YYSTYPE yylval;
 
-int yyparse (void);
+#ifdef short
+# undef short
+#endif
 
-#endif /* !YY_YY_CM_TAB_H_INCLUDED  */
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
-/* Copy the second part of user declarations.  */
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
 
-#line 174 "cm.tab.c" /* yacc.c:358  */
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
 
-#ifdef short
-# undef short
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned char yytype_uint8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#else
-typedef signed char yytype_int8;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -205,15 +281,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -227,47 +316,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -280,8 +365,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -346,8 +445,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -356,17 +454,17 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -379,11 +477,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -395,12 +493,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -412,28 +510,31 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  9
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   100
+#define YYLAST   98
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  39
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  32
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  65
+#define YYNRULES  66
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  104
+#define YYNSTATES  105
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   293
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -468,222 +569,222 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,    36,    36,    40,    43,    45,    48,    52,    57,    63,
-      70,    73,    78,    81,    86,    89,    94,    98,   104,   109,
-     112,   114,   117,   119,   122,   125,   129,   133,   137,   140,
-     143,   146,   151,   156,   159,   164,   167,   172,   175,   180,
-     183,   186,   189,   192,   195,   200,   203,   208,   211,   216,
-     219,   224,   227,   232,   235,   238,   241,   246,   251,   254,
-     257,   260,   265,   268,   273,   278
+       0,    35,    35,    39,    42,    44,    47,    51,    55,    61,
+      66,    73,    76,    81,    84,    89,    92,    97,   101,   107,
+     112,   115,   117,   120,   122,   125,   128,   132,   136,   140,
+     143,   146,   149,   154,   159,   162,   167,   170,   175,   178,
+     183,   186,   189,   192,   195,   198,   203,   206,   211,   214,
+     219,   222,   227,   230,   235,   238,   241,   244,   249,   254,
+     257,   260,   263,   268,   271,   276,   281
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "ELSE", "IF", "INT", "RETURN", "VOID",
-  "WHILE", "ID", "NUM", "PLUS", "MINUS", "TIMES", "OVER", "LT", "LE", "GT",
-  "GE", "EQ", "NE", "ASSIGN", "SEMI", "COMMA", "LPAREN", "RPAREN",
-  "LBRACKET", "RBRACKET", "LBRACE", "RBRACE", "THEN", "END", "REPEAT",
-  "UNTIL", "READ", "WRITE", "ENDFILE", "ERROR", "LOWER_ELSE", "$accept",
-  "program", "declaration_list", "declaration", "variable_declaration",
-  "function_declaration", "type_check", "_parameters", "parameterList",
-  "param", "_compoundStatement", "local_declarations", "statement_list",
-  "statement", "expressionStmt", "selectionStmt", "iterationStmt",
-  "returnStmt", "expression", "simple_expression", "relativeOp",
-  "additive_expression", "addop", "term", "mulop", "factor", "call",
-  "args", "arg_list", "_var", "_id", "_num", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "ELSE", "IF", "INT",
+  "RETURN", "VOID", "WHILE", "ID", "NUM", "PLUS", "MINUS", "TIMES", "OVER",
+  "LT", "LE", "GT", "GE", "EQ", "NE", "ASSIGN", "SEMI", "COMMA", "LPAREN",
+  "RPAREN", "LBRACKET", "RBRACKET", "LBRACE", "RBRACE", "THEN", "END",
+  "REPEAT", "UNTIL", "READ", "WRITE", "ENDFILE", "ERROR", "LOWER_ELSE",
+  "$accept", "program", "declaration_list", "declaration",
+  "variable_declaration", "function_declaration", "type_check",
+  "_parameters", "parameterList", "param", "_compoundStatement",
+  "local_declarations", "statement_list", "statement", "expressionStmt",
+  "selectionStmt", "iterationStmt", "returnStmt", "expression",
+  "simple_expression", "relativeOp", "additive_expression", "addop",
+  "term", "mulop", "factor", "call", "args", "arg_list", "_var", "_id",
+  "_num", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -77
+#define YYPACT_NINF (-59)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-77)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -14
+#define YYTABLE_NINF (-15)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
-      47,   -77,   -77,     8,    47,   -77,   -77,   -77,    21,   -77,
-     -77,   -77,   -20,   -77,    50,     7,    10,    21,    13,    28,
-     -77,   -77,    29,    33,    37,    47,    39,    51,   -77,   -77,
-     -77,   -77,   -77,    47,   -77,    21,     3,    11,    53,    12,
-      55,   -77,     5,   -77,   -77,   -77,   -77,   -77,   -77,   -77,
-      58,   -77,    52,    60,   -77,   -77,    61,    19,   -77,     5,
-     -77,    59,     5,    62,   -77,   -77,   -77,   -77,   -77,   -77,
-     -77,   -77,   -77,     5,     5,   -77,   -77,     5,     5,     5,
-       5,    63,   -77,    65,   -77,    64,   -77,    60,   -77,   -77,
-     -77,    66,    69,    56,    38,    38,   -77,     5,   -77,    81,
-     -77,   -77,    38,   -77
+      47,   -59,   -59,    14,    47,   -59,   -59,   -59,    26,   -59,
+     -59,   -59,     4,   -59,    54,    33,    31,    26,    32,    42,
+     -59,   -59,    50,    48,   -20,    47,    56,    53,   -59,   -59,
+     -59,   -59,   -59,   -59,    47,   -59,    26,     3,    29,    55,
+      12,    57,   -59,     9,   -59,   -59,   -59,   -59,   -59,   -59,
+     -59,    60,   -59,    52,    -8,   -59,   -59,    62,    49,   -59,
+       9,   -59,    63,     9,    51,   -59,   -59,   -59,   -59,   -59,
+     -59,   -59,   -59,   -59,     9,     9,   -59,   -59,     9,     9,
+       9,     9,    59,   -59,    61,   -59,     5,   -59,    -8,   -59,
+     -59,   -59,    64,    65,    66,    38,    38,   -59,     9,   -59,
+      84,   -59,   -59,    38,   -59
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       0,    10,    11,     0,     2,     4,     5,     6,     0,     1,
-       3,    64,     0,     7,     0,     0,    11,     0,     0,    12,
-      15,    65,     0,    16,     0,     0,     0,     0,    20,     9,
-      14,     8,    17,    22,    19,     0,     0,     0,     0,     0,
-       0,    29,     0,    18,    24,    21,    23,    25,    26,    27,
-       0,    36,    38,    46,    50,    55,    54,    62,    56,     0,
-      33,     0,     0,     0,    28,    47,    48,    39,    40,    41,
-      42,    43,    44,     0,     0,    51,    52,     0,     0,    59,
-       0,     0,    34,     0,    53,    37,    54,    45,    49,    35,
-      61,     0,    58,     0,     0,     0,    57,     0,    63,    30,
-      32,    60,     0,    31
+       0,    11,    12,     0,     2,     4,     5,     6,     0,     1,
+       3,    65,     0,     7,     0,     0,    12,     0,     0,    13,
+      16,    66,     0,    17,     0,     0,     0,     0,    10,    21,
+       9,    15,     8,    18,    23,    20,     0,     0,     0,     0,
+       0,     0,    30,     0,    19,    25,    22,    24,    26,    27,
+      28,     0,    37,    39,    47,    51,    56,    55,    63,    57,
+       0,    34,     0,     0,     0,    29,    48,    49,    40,    41,
+      42,    43,    44,    45,     0,     0,    52,    53,     0,     0,
+      60,     0,     0,    35,     0,    54,    38,    55,    46,    50,
+      36,    62,     0,    59,     0,     0,     0,    58,     0,    64,
+      31,    33,    61,     0,    32
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -77,   -77,   -77,    82,    67,   -77,    -9,   -77,   -77,    68,
-      70,   -77,   -77,   -76,   -77,   -77,   -77,   -77,   -39,   -77,
-     -77,    16,   -77,    22,   -77,    18,   -77,   -77,   -77,   -24,
+     -59,   -59,   -59,    86,    58,   -59,   -10,   -59,   -59,    69,
+      67,   -59,   -59,   -58,   -59,   -59,   -59,   -59,   -40,   -59,
+     -59,    21,   -59,    22,   -59,    18,   -59,   -59,   -59,   -25,
       -7,    83
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     3,     4,     5,     6,     7,     8,    18,    19,    20,
-      44,    33,    36,    45,    46,    47,    48,    49,    50,    51,
-      73,    52,    74,    53,    77,    54,    55,    91,    92,    56,
-      57,    58
+       0,     3,     4,     5,     6,     7,     8,    18,    19,    20,
+      45,    34,    37,    46,    47,    48,    49,    50,    51,    52,
+      74,    53,    75,    54,    78,    55,    56,    92,    93,    57,
+      58,    59
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
-      61,    12,    13,    63,    14,    17,    15,    38,     9,    39,
-      23,    40,    11,    21,    11,    21,    17,    21,    99,   100,
-      81,    11,    21,    83,    35,    41,   103,    42,    37,    42,
-      11,    28,    43,    13,    60,   -13,    42,    15,    24,    89,
-      90,    93,    38,    79,    39,    80,    40,    11,    21,    86,
-      86,    25,     1,    86,     2,     1,    26,    16,   101,    27,
-      41,    31,    42,    65,    66,    28,    28,    67,    68,    69,
-      70,    71,    72,    75,    76,    65,    66,    59,    32,    62,
-      64,    82,    78,    98,   102,     0,    10,    84,    94,    85,
-      95,    96,    97,    30,    29,    88,    87,     0,    22,     0,
-      34
+      62,    12,    28,    64,    17,    76,    77,    39,    29,    40,
+      23,    41,    11,    21,     9,    17,    66,    67,    11,    21,
+      82,    11,    21,    84,    36,    42,    13,    43,    14,    38,
+      15,    29,    44,    43,    61,    11,    43,   100,   101,    90,
+      91,    94,    39,    21,    40,   104,    41,    11,    21,    87,
+      87,    13,     1,    87,     2,    15,   -14,    24,   102,     1,
+      42,    16,    43,    66,    67,    25,    29,    68,    69,    70,
+      71,    72,    73,    80,    27,    81,    85,    26,    32,    60,
+      33,    63,    65,    79,    95,    83,    96,   103,    98,    97,
+      10,    30,    35,    99,    31,    86,    89,    88,    22
 };
 
 static const yytype_int8 yycheck[] =
 {
-      39,     8,    22,    42,    24,    14,    26,     4,     0,     6,
-      17,     8,     9,    10,     9,    10,    25,    10,    94,    95,
-      59,     9,    10,    62,    33,    22,   102,    24,    35,    24,
-       9,    28,    29,    22,    22,    25,    24,    26,    25,    78,
-      79,    80,     4,    24,     6,    26,     8,     9,    10,    73,
-      74,    23,     5,    77,     7,     5,    27,     7,    97,    26,
-      22,    22,    24,    11,    12,    28,    28,    15,    16,    17,
-      18,    19,    20,    13,    14,    11,    12,    24,    27,    24,
-      22,    22,    21,    27,     3,    -1,     4,    25,    25,    73,
-      25,    25,    23,    25,    24,    77,    74,    -1,    15,    -1,
-      33
+      40,     8,    22,    43,    14,    13,    14,     4,    28,     6,
+      17,     8,     9,    10,     0,    25,    11,    12,     9,    10,
+      60,     9,    10,    63,    34,    22,    22,    24,    24,    36,
+      26,    28,    29,    24,    22,     9,    24,    95,    96,    79,
+      80,    81,     4,    10,     6,   103,     8,     9,    10,    74,
+      75,    22,     5,    78,     7,    26,    25,    25,    98,     5,
+      22,     7,    24,    11,    12,    23,    28,    15,    16,    17,
+      18,    19,    20,    24,    26,    26,    25,    27,    22,    24,
+      27,    24,    22,    21,    25,    22,    25,     3,    23,    25,
+       4,    24,    34,    27,    25,    74,    78,    75,    15
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
        0,     5,     7,    40,    41,    42,    43,    44,    45,     0,
       42,     9,    69,    22,    24,    26,     7,    45,    46,    47,
-      48,    10,    70,    69,    25,    23,    27,    26,    28,    49,
-      48,    22,    27,    50,    43,    45,    51,    69,     4,     6,
-       8,    22,    24,    29,    49,    52,    53,    54,    55,    56,
-      57,    58,    60,    62,    64,    65,    68,    69,    70,    24,
-      22,    57,    24,    57,    22,    11,    12,    15,    16,    17,
-      18,    19,    20,    59,    61,    13,    14,    63,    21,    24,
-      26,    57,    22,    57,    25,    60,    68,    62,    64,    57,
-      57,    66,    67,    57,    25,    25,    25,    23,    27,    52,
-      52,    57,     3,    52
+      48,    10,    70,    69,    25,    23,    27,    26,    22,    28,
+      49,    48,    22,    27,    50,    43,    45,    51,    69,     4,
+       6,     8,    22,    24,    29,    49,    52,    53,    54,    55,
+      56,    57,    58,    60,    62,    64,    65,    68,    69,    70,
+      24,    22,    57,    24,    57,    22,    11,    12,    15,    16,
+      17,    18,    19,    20,    59,    61,    13,    14,    63,    21,
+      24,    26,    57,    22,    57,    25,    60,    68,    62,    64,
+      57,    57,    66,    67,    57,    25,    25,    25,    23,    27,
+      52,    52,    57,     3,    52
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
        0,    39,    40,    41,    41,    42,    42,    43,    43,    44,
-      45,    45,    46,    46,    47,    47,    48,    48,    49,    50,
-      50,    51,    51,    52,    52,    52,    52,    52,    53,    53,
-      54,    54,    55,    56,    56,    57,    57,    58,    58,    59,
-      59,    59,    59,    59,    59,    60,    60,    61,    61,    62,
-      62,    63,    63,    64,    64,    64,    64,    65,    66,    66,
-      67,    67,    68,    68,    69,    70
+      44,    45,    45,    46,    46,    47,    47,    48,    48,    49,
+      50,    50,    51,    51,    52,    52,    52,    52,    52,    53,
+      53,    54,    54,    55,    56,    56,    57,    57,    58,    58,
+      59,    59,    59,    59,    59,    59,    60,    60,    61,    61,
+      62,    62,    63,    63,    64,    64,    64,    64,    65,    66,
+      66,    67,    67,    68,    68,    69,    70
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     1,     1,     1,     3,     6,     6,
-       1,     1,     1,     1,     3,     1,     2,     4,     4,     2,
-       0,     2,     0,     1,     1,     1,     1,     1,     2,     1,
-       5,     7,     5,     2,     3,     3,     1,     3,     1,     1,
-       1,     1,     1,     1,     1,     3,     1,     1,     1,     3,
-       1,     1,     1,     3,     1,     1,     1,     4,     1,     0,
-       3,     1,     1,     4,     1,     1
+       6,     1,     1,     1,     1,     3,     1,     2,     4,     4,
+       2,     0,     2,     0,     1,     1,     1,     1,     1,     2,
+       1,     5,     7,     5,     2,     3,     3,     1,     3,     1,
+       1,     1,     1,     1,     1,     1,     3,     1,     1,     1,
+       3,     1,     1,     1,     3,     1,     1,     1,     4,     1,
+       0,     3,     1,     1,     4,     1,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -700,55 +801,52 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -757,7 +855,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -780,21 +878,21 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -809,8 +907,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -833,249 +931,30 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1084,6 +963,8 @@ YYSTYPE yylval;
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1091,43 +972,36 @@ int yynerrs;
 int
 yyparse (void)
 {
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1135,71 +1009,75 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
@@ -1207,30 +1085,31 @@ yyparse (void)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1241,18 +1120,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1280,15 +1170,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1303,7 +1191,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1323,521 +1211,531 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 36 "cm.y" /* yacc.c:1646  */
-    { 
- 				savedTree = (yyvsp[0]);
+  case 2: /* program: declaration_list  */
+#line 35 "cm.y"
+                          { 
+ 				savedTree = yyvsp[0];
 			}
-#line 1332 "cm.tab.c" /* yacc.c:1646  */
+#line 1220 "cm.tab.c"
     break;
 
-  case 3:
-#line 40 "cm.y" /* yacc.c:1646  */
-    {
-						 (yyval) = addNode((yyvsp[-1]), (yyvsp[0]));
+  case 3: /* declaration_list: declaration_list declaration  */
+#line 39 "cm.y"
+                                                             {
+						 yyval = addNode(yyvsp[-1], yyvsp[0]);
 					 	}
-#line 1340 "cm.tab.c" /* yacc.c:1646  */
+#line 1228 "cm.tab.c"
     break;
 
-  case 4:
-#line 43 "cm.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1346 "cm.tab.c" /* yacc.c:1646  */
+  case 4: /* declaration_list: declaration  */
+#line 42 "cm.y"
+                                                                    { yyval = yyvsp[0]; }
+#line 1234 "cm.tab.c"
     break;
 
-  case 5:
-#line 45 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = (yyvsp[0]);
+  case 5: /* declaration: variable_declaration  */
+#line 44 "cm.y"
+                                             {
+					yyval = yyvsp[0];
 				}
-#line 1354 "cm.tab.c" /* yacc.c:1646  */
+#line 1242 "cm.tab.c"
     break;
 
-  case 6:
-#line 48 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = (yyvsp[0]);
+  case 6: /* declaration: function_declaration  */
+#line 47 "cm.y"
+                                                       {
+					yyval = yyvsp[0];
 				}
-#line 1362 "cm.tab.c" /* yacc.c:1646  */
+#line 1250 "cm.tab.c"
     break;
 
-  case 7:
-#line 52 "cm.y" /* yacc.c:1646  */
-    {
-							 savedName = copyString(tokenString);	
+  case 7: /* variable_declaration: type_check _id SEMI  */
+#line 51 "cm.y"
+                                                    {
 							 savedLineNo = lineno;
-							 (yyval) = variableDeclarationNode((yyvsp[-2]), (yyvsp[-1]), savedLineNo);
+							 yyval = variableDeclarationNode(yyvsp[-2], yyvsp[-1], savedLineNo);
 							}
-#line 1372 "cm.tab.c" /* yacc.c:1646  */
+#line 1259 "cm.tab.c"
     break;
 
-  case 8:
-#line 57 "cm.y" /* yacc.c:1646  */
-    {
+  case 8: /* variable_declaration: type_check _id LBRACKET _num RBRACKET SEMI  */
+#line 55 "cm.y"
+                                                                                                     {
 							 	savedLineNo = lineno;
-								(yyval) = arrayDeclarationNode((yyvsp[-5]), (yyvsp[-4]), savedLineNo, (yyvsp[-2]));
+								yyval = arrayDeclarationNode(yyvsp[-5], yyvsp[-4], savedLineNo, yyvsp[-2]);
 							}
-#line 1381 "cm.tab.c" /* yacc.c:1646  */
+#line 1268 "cm.tab.c"
     break;
 
-  case 9:
-#line 63 "cm.y" /* yacc.c:1646  */
-    {
-							 	printf("function\n");
+  case 9: /* function_declaration: type_check _id LPAREN _parameters RPAREN _compoundStatement  */
+#line 61 "cm.y"
+                                                                                            {
+							 	if (TraceParse) printf("function\n");
 								savedLineNo = lineno;
-								(yyval) = functionDeclarationNode((yyvsp[-5]), (yyvsp[-4]), (yyvsp[-2]), (yyvsp[0]), savedLineNo);
+								yyval = functionDeclarationNode(yyvsp[-5], yyvsp[-4], yyvsp[-2], yyvsp[0], savedLineNo);
 							}
-#line 1391 "cm.tab.c" /* yacc.c:1646  */
+#line 1278 "cm.tab.c"
     break;
 
-  case 10:
-#line 70 "cm.y" /* yacc.c:1646  */
-    {
-				 	(yyval) = tokenType(Integer);
+  case 10: /* function_declaration: type_check _id LPAREN _parameters RPAREN SEMI  */
+#line 66 "cm.y"
+                                                                                                        {
+								/* a function defined in another unit */
+								savedLineNo = lineno;
+								yyval = functionDeclarationNode(yyvsp[-5], yyvsp[-4], yyvsp[-2], NULL, savedLineNo);
+							}
+#line 1288 "cm.tab.c"
+    break;
+
+  case 11: /* type_check: INT  */
+#line 73 "cm.y"
+                            {
+				 	yyval = tokenType(Integer);
 				}
-#line 1399 "cm.tab.c" /* yacc.c:1646  */
+#line 1296 "cm.tab.c"
     break;
 
-  case 11:
-#line 73 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = tokenType(Void);
+  case 12: /* type_check: VOID  */
+#line 76 "cm.y"
+                                       {
+					yyval = tokenType(Void);
 					}
-#line 1407 "cm.tab.c" /* yacc.c:1646  */
+#line 1304 "cm.tab.c"
     break;
 
-  case 12:
-#line 78 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = (yyvsp[0]);
+  case 13: /* _parameters: parameterList  */
+#line 81 "cm.y"
+                                      {
+					yyval = yyvsp[0];
 				}
-#line 1415 "cm.tab.c" /* yacc.c:1646  */
+#line 1312 "cm.tab.c"
     break;
 
-  case 13:
-#line 81 "cm.y" /* yacc.c:1646  */
-    {
+  case 14: /* _parameters: VOID  */
+#line 84 "cm.y"
+                                       {
 				 	savedLineNo = lineno;
-					(yyval) = voidParameterNode(savedLineNo);
+					yyval = voidParameterNode(savedLineNo);
 				}
-#line 1424 "cm.tab.c" /* yacc.c:1646  */
+#line 1321 "cm.tab.c"
     break;
 
-  case 14:
-#line 86 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = addNode((yyvsp[-2]), (yyvsp[0]));
+  case 15: /* parameterList: parameterList COMMA param  */
+#line 89 "cm.y"
+                                                  {
+						yyval = addNode(yyvsp[-2], yyvsp[0]);
 					}
-#line 1432 "cm.tab.c" /* yacc.c:1646  */
+#line 1329 "cm.tab.c"
     break;
 
-  case 15:
-#line 89 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = (yyvsp[0]);
+  case 16: /* parameterList: param  */
+#line 92 "cm.y"
+                                                {
+						yyval = yyvsp[0];
 					}
-#line 1440 "cm.tab.c" /* yacc.c:1646  */
+#line 1337 "cm.tab.c"
     break;
 
-  case 16:
-#line 94 "cm.y" /* yacc.c:1646  */
-    {
+  case 17: /* param: type_check _id  */
+#line 97 "cm.y"
+                               {
 			 	savedLineNo = lineno;
-				(yyval) = variableParameterNode((yyvsp[-1]), (yyvsp[0]), savedLineNo);
+				yyval = variableParameterNode(yyvsp[-1], yyvsp[0], savedLineNo);
 			}
-#line 1449 "cm.tab.c" /* yacc.c:1646  */
+#line 1346 "cm.tab.c"
     break;
 
-  case 17:
-#line 98 "cm.y" /* yacc.c:1646  */
-    {
+  case 18: /* param: type_check _id LBRACKET RBRACKET  */
+#line 101 "cm.y"
+                                                           {
 			 	savedLineNo = lineno;
-				(yyval) = arrayParameterNode((yyvsp[-3]), (yyvsp[-2]), savedLineNo);
+				yyval = arrayParameterNode(yyvsp[-3], yyvsp[-2], savedLineNo);
 			}
-#line 1458 "cm.tab.c" /* yacc.c:1646  */
+#line 1355 "cm.tab.c"
     break;
 
-  case 18:
-#line 104 "cm.y" /* yacc.c:1646  */
-    {
+  case 19: /* _compoundStatement: LBRACE local_declarations statement_list RBRACE  */
+#line 107 "cm.y"
+                                                                                {
 						 	savedLineNo = lineno;
-							(yyval) = compoundStatementNode((yyvsp[-2]), (yyvsp[-1]), savedLineNo);
+							yyval = compoundStatementNode(yyvsp[-2], yyvsp[-1], savedLineNo);
 						}
-#line 1467 "cm.tab.c" /* yacc.c:1646  */
+#line 1364 "cm.tab.c"
     break;
 
-  case 19:
-#line 109 "cm.y" /* yacc.c:1646  */
-    {
-							(yyval) = addNode((yyvsp[-1]), (yyvsp[0]));
+  case 20: /* local_declarations: local_declarations variable_declaration  */
+#line 112 "cm.y"
+                                                                        {
+							yyval = addNode(yyvsp[-1], yyvsp[0]);
 						}
-#line 1475 "cm.tab.c" /* yacc.c:1646  */
+#line 1372 "cm.tab.c"
     break;
 
-  case 20:
-#line 112 "cm.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1481 "cm.tab.c" /* yacc.c:1646  */
+  case 21: /* local_declarations: %empty  */
+#line 115 "cm.y"
+                                                              { yyval = NULL; }
+#line 1378 "cm.tab.c"
     break;
 
-  case 21:
-#line 114 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = addNode((yyvsp[-1]), (yyvsp[0]));
+  case 22: /* statement_list: statement_list statement  */
+#line 117 "cm.y"
+                                                 {
+						yyval = addNode(yyvsp[-1], yyvsp[0]);
 					}
-#line 1489 "cm.tab.c" /* yacc.c:1646  */
+#line 1386 "cm.tab.c"
     break;
 
-  case 22:
-#line 117 "cm.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1495 "cm.tab.c" /* yacc.c:1646  */
+  case 23: /* statement_list: %empty  */
+#line 120 "cm.y"
+                                                      { yyval = NULL; }
+#line 1392 "cm.tab.c"
     break;
 
-  case 23:
-#line 119 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = (yyvsp[0]);
+  case 24: /* statement: expressionStmt  */
+#line 122 "cm.y"
+                                       {
+					yyval = yyvsp[0];
 				}
-#line 1503 "cm.tab.c" /* yacc.c:1646  */
+#line 1400 "cm.tab.c"
     break;
 
-  case 24:
-#line 122 "cm.y" /* yacc.c:1646  */
-    {
-				 	(yyval) = (yyvsp[0]);
+  case 25: /* statement: _compoundStatement  */
+#line 125 "cm.y"
+                                                     {
+				 	yyval = yyvsp[0];
 				}
-#line 1511 "cm.tab.c" /* yacc.c:1646  */
+#line 1408 "cm.tab.c"
     break;
 
-  case 25:
-#line 125 "cm.y" /* yacc.c:1646  */
-    {
-				 	printf("selection\n");
-				 	(yyval) = (yyvsp[0]);
+  case 26: /* statement: selectionStmt  */
+#line 128 "cm.y"
+                                                {
+				 	if (TraceParse) printf("selection\n");
+				 	yyval = yyvsp[0];
 				}
-#line 1520 "cm.tab.c" /* yacc.c:1646  */
+#line 1417 "cm.tab.c"
     break;
 
-  case 26:
-#line 129 "cm.y" /* yacc.c:1646  */
-    {
-				 	printf("iteration\n");
-				 	(yyval) = (yyvsp[0]);
+  case 27: /* statement: iterationStmt  */
+#line 132 "cm.y"
+                                                {
+				 	if (TraceParse) printf("iteration\n");
+				 	yyval = yyvsp[0];
 				}
-#line 1529 "cm.tab.c" /* yacc.c:1646  */
+#line 1426 "cm.tab.c"
     break;
 
-  case 27:
-#line 133 "cm.y" /* yacc.c:1646  */
-    {
-				 	(yyval) = (yyvsp[0]);
+  case 28: /* statement: returnStmt  */
+#line 136 "cm.y"
+                                             {
+				 	yyval = yyvsp[0];
 				}
-#line 1537 "cm.tab.c" /* yacc.c:1646  */
+#line 1434 "cm.tab.c"
     break;
 
-  case 28:
-#line 137 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = expressionStatementNode((yyvsp[-1]));
+  case 29: /* expressionStmt: expression SEMI  */
+#line 140 "cm.y"
+                                        {
+						yyval = expressionStatementNode(yyvsp[-1]);
 					}
-#line 1545 "cm.tab.c" /* yacc.c:1646  */
+#line 1442 "cm.tab.c"
     break;
 
-  case 29:
-#line 140 "cm.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1551 "cm.tab.c" /* yacc.c:1646  */
+  case 30: /* expressionStmt: SEMI  */
+#line 143 "cm.y"
+                                               { yyval = NULL; }
+#line 1448 "cm.tab.c"
     break;
 
-  case 30:
-#line 143 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = selectionStatementNode((yyvsp[-2]), (yyvsp[0]), NULL);
+  case 31: /* selectionStmt: IF LPAREN expression RPAREN statement  */
+#line 146 "cm.y"
+                                                              {
+						yyval = selectionStatementNode(yyvsp[-2], yyvsp[0], NULL);
 					}
-#line 1559 "cm.tab.c" /* yacc.c:1646  */
+#line 1456 "cm.tab.c"
     break;
 
-  case 31:
-#line 146 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = selectionStatementNode((yyvsp[-4]), (yyvsp[-2]), (yyvsp[0]));
+  case 32: /* selectionStmt: IF LPAREN expression RPAREN statement ELSE statement  */
+#line 149 "cm.y"
+                                                                                               {
+						yyval = selectionStatementNode(yyvsp[-4], yyvsp[-2], yyvsp[0]);
 					}
-#line 1567 "cm.tab.c" /* yacc.c:1646  */
+#line 1464 "cm.tab.c"
     break;
 
-  case 32:
-#line 151 "cm.y" /* yacc.c:1646  */
-    {
-						(yyval) = iterationStatementNode((yyvsp[-2]), (yyvsp[0]));
+  case 33: /* iterationStmt: WHILE LPAREN expression RPAREN statement  */
+#line 154 "cm.y"
+                                                                 {
+						yyval = iterationStatementNode(yyvsp[-2], yyvsp[0]);
 					}
-#line 1575 "cm.tab.c" /* yacc.c:1646  */
+#line 1472 "cm.tab.c"
     break;
 
-  case 33:
-#line 156 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = returnStatementNode(NULL);
+  case 34: /* returnStmt: RETURN SEMI  */
+#line 159 "cm.y"
+                                    {
+					yyval = returnStatementNode(NULL);
 				}
-#line 1583 "cm.tab.c" /* yacc.c:1646  */
+#line 1480 "cm.tab.c"
     break;
 
-  case 34:
-#line 159 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = returnStatementNode((yyvsp[-1]));
+  case 35: /* returnStmt: RETURN expression SEMI  */
+#line 162 "cm.y"
+                                                         {
+					yyval = returnStatementNode(yyvsp[-1]);
 				}
-#line 1591 "cm.tab.c" /* yacc.c:1646  */
+#line 1488 "cm.tab.c"
     break;
 
-  case 35:
-#line 164 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = assignExpression((yyvsp[-2]), (yyvsp[0]));
+  case 36: /* expression: _var ASSIGN expression  */
+#line 167 "cm.y"
+                                               {
+					yyval = assignExpression(yyvsp[-2], yyvsp[0]);
 				}
-#line 1599 "cm.tab.c" /* yacc.c:1646  */
+#line 1496 "cm.tab.c"
     break;
 
-  case 36:
-#line 167 "cm.y" /* yacc.c:1646  */
-    {
-					(yyval) = (yyvsp[0]);
+  case 37: /* expression: simple_expression  */
+#line 170 "cm.y"
+                                                    {
+					yyval = yyvsp[0];
 				}
-#line 1607 "cm.tab.c" /* yacc.c:1646  */
+#line 1504 "cm.tab.c"
     break;
 
-  case 37:
-#line 172 "cm.y" /* yacc.c:1646  */
-    {
-							(yyval) = comparisionExpressionNode((yyvsp[-2]), (yyvsp[-1]), (yyvsp[0]));
+  case 38: /* simple_expression: additive_expression relativeOp additive_expression  */
+#line 175 "cm.y"
+                                                                                   {
+							yyval = comparisionExpressionNode(yyvsp[-2], yyvsp[-1], yyvsp[0]);
 						}
-#line 1615 "cm.tab.c" /* yacc.c:1646  */
+#line 1512 "cm.tab.c"
     break;
 
-  case 38:
-#line 175 "cm.y" /* yacc.c:1646  */
-    {
-							(yyval) = (yyvsp[0]);
+  case 39: /* simple_expression: additive_expression  */
+#line 178 "cm.y"
+                                                                      {
+							yyval = yyvsp[0];
 						}
-#line 1623 "cm.tab.c" /* yacc.c:1646  */
+#line 1520 "cm.tab.c"
     break;
 
-  case 39:
-#line 180 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(LT);
+  case 40: /* relativeOp: LT  */
+#line 183 "cm.y"
+                           {
+				 yyval = tokenType(LT);
 				}
-#line 1631 "cm.tab.c" /* yacc.c:1646  */
+#line 1528 "cm.tab.c"
     break;
 
-  case 40:
-#line 183 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(LE);
+  case 41: /* relativeOp: LE  */
+#line 186 "cm.y"
+                                     {
+				 yyval = tokenType(LE);
 				}
-#line 1639 "cm.tab.c" /* yacc.c:1646  */
+#line 1536 "cm.tab.c"
     break;
 
-  case 41:
-#line 186 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(GT);
+  case 42: /* relativeOp: GT  */
+#line 189 "cm.y"
+                                     {
+				 yyval = tokenType(GT);
 				}
-#line 1647 "cm.tab.c" /* yacc.c:1646  */
+#line 1544 "cm.tab.c"
     break;
 
-  case 42:
-#line 189 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(GE);
+  case 43: /* relativeOp: GE  */
+#line 192 "cm.y"
+                                     {
+				 yyval = tokenType(GE);
 				}
-#line 1655 "cm.tab.c" /* yacc.c:1646  */
+#line 1552 "cm.tab.c"
     break;
 
-  case 43:
-#line 192 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(EQ);
+  case 44: /* relativeOp: EQ  */
+#line 195 "cm.y"
+                                     {
+				 yyval = tokenType(EQ);
 				}
-#line 1663 "cm.tab.c" /* yacc.c:1646  */
+#line 1560 "cm.tab.c"
     break;
 
-  case 44:
-#line 195 "cm.y" /* yacc.c:1646  */
-    {
-				 (yyval) = tokenType(NE);
+  case 45: /* relativeOp: NE  */
+#line 198 "cm.y"
+                                     {
+				 yyval = tokenType(NE);
 				}
-#line 1671 "cm.tab.c" /* yacc.c:1646  */
+#line 1568 "cm.tab.c"
     break;
 
-  case 45:
-#line 200 "cm.y" /* yacc.c:1646  */
-    {
-							(yyval) = additiveExpressionNode((yyvsp[-2]), (yyvsp[-1]), (yyvsp[0]));
+  case 46: /* additive_expression: additive_expression addop term  */
+#line 203 "cm.y"
+                                                               {
+							yyval = additiveExpressionNode(yyvsp[-2], yyvsp[-1], yyvsp[0]);
 						}
-#line 1679 "cm.tab.c" /* yacc.c:1646  */
+#line 1576 "cm.tab.c"
     break;
 
-  case 46:
-#line 203 "cm.y" /* yacc.c:1646  */
-    {
-						 	(yyval) = (yyvsp[0]);
+  case 47: /* additive_expression: term  */
+#line 206 "cm.y"
+                                                       {
+						 	yyval = yyvsp[0];
 						}
-#line 1687 "cm.tab.c" /* yacc.c:1646  */
+#line 1584 "cm.tab.c"
     break;
 
-  case 47:
-#line 208 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = tokenType(PLUS);
+  case 48: /* addop: PLUS  */
+#line 211 "cm.y"
+                     {
+				yyval = tokenType(PLUS);
 			}
-#line 1695 "cm.tab.c" /* yacc.c:1646  */
+#line 1592 "cm.tab.c"
     break;
 
-  case 48:
-#line 211 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = tokenType(MINUS);
+  case 49: /* addop: MINUS  */
+#line 214 "cm.y"
+                                {
+				yyval = tokenType(MINUS);
 			}
-#line 1703 "cm.tab.c" /* yacc.c:1646  */
+#line 1600 "cm.tab.c"
     break;
 
-  case 49:
-#line 216 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = multiplicativeExpressionNode((yyvsp[-2]), (yyvsp[-1]), (yyvsp[0]));
+  case 50: /* term: term mulop factor  */
+#line 219 "cm.y"
+                                  {
+				yyval = multiplicativeExpressionNode(yyvsp[-2], yyvsp[-1], yyvsp[0]);
 			}
-#line 1711 "cm.tab.c" /* yacc.c:1646  */
+#line 1608 "cm.tab.c"
     break;
 
-  case 50:
-#line 219 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]);
+  case 51: /* term: factor  */
+#line 222 "cm.y"
+                                 {
+				yyval = yyvsp[0];
 			}
-#line 1719 "cm.tab.c" /* yacc.c:1646  */
+#line 1616 "cm.tab.c"
     break;
 
-  case 51:
-#line 224 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = tokenType(TIMES);
+  case 52: /* mulop: TIMES  */
+#line 227 "cm.y"
+                      {
+				yyval = tokenType(TIMES);
 			}
-#line 1727 "cm.tab.c" /* yacc.c:1646  */
+#line 1624 "cm.tab.c"
     break;
 
-  case 52:
-#line 227 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = tokenType(OVER);
+  case 53: /* mulop: OVER  */
+#line 230 "cm.y"
+                               {
+				yyval = tokenType(OVER);
 			}
-#line 1735 "cm.tab.c" /* yacc.c:1646  */
+#line 1632 "cm.tab.c"
     break;
 
-  case 53:
-#line 232 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[-1]);
+  case 54: /* factor: LPAREN expression RPAREN  */
+#line 235 "cm.y"
+                                         {
+				yyval = yyvsp[-1];
 			}
-#line 1743 "cm.tab.c" /* yacc.c:1646  */
+#line 1640 "cm.tab.c"
     break;
 
-  case 54:
-#line 235 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]);
+  case 55: /* factor: _var  */
+#line 238 "cm.y"
+                               {
+				yyval = yyvsp[0];
 			}
-#line 1751 "cm.tab.c" /* yacc.c:1646  */
+#line 1648 "cm.tab.c"
     break;
 
-  case 55:
-#line 238 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]);
+  case 56: /* factor: call  */
+#line 241 "cm.y"
+                               {
+				yyval = yyvsp[0];
 			}
-#line 1759 "cm.tab.c" /* yacc.c:1646  */
+#line 1656 "cm.tab.c"
     break;
 
-  case 56:
-#line 241 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]);
+  case 57: /* factor: _num  */
+#line 244 "cm.y"
+                               {
+				yyval = yyvsp[0];
 			}
-#line 1767 "cm.tab.c" /* yacc.c:1646  */
+#line 1664 "cm.tab.c"
     break;
 
-  case 57:
-#line 246 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = callNode((yyvsp[-3]), (yyvsp[-1]));
+  case 58: /* call: _id LPAREN args RPAREN  */
+#line 249 "cm.y"
+                                       {
+				yyval = callNode(yyvsp[-3], yyvsp[-1]);
 			}
-#line 1775 "cm.tab.c" /* yacc.c:1646  */
+#line 1672 "cm.tab.c"
     break;
 
-  case 58:
-#line 251 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]); 
+  case 59: /* args: arg_list  */
+#line 254 "cm.y"
+                         {
+				yyval = yyvsp[0]; 
 		  	}
-#line 1783 "cm.tab.c" /* yacc.c:1646  */
+#line 1680 "cm.tab.c"
     break;
 
-  case 59:
-#line 254 "cm.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1789 "cm.tab.c" /* yacc.c:1646  */
+  case 60: /* args: %empty  */
+#line 257 "cm.y"
+                  { yyval = NULL; }
+#line 1686 "cm.tab.c"
     break;
 
-  case 60:
-#line 257 "cm.y" /* yacc.c:1646  */
-    { 
-				(yyval) = addNode((yyvsp[-2]), (yyvsp[0])); 
+  case 61: /* arg_list: arg_list COMMA expression  */
+#line 260 "cm.y"
+                                            { 
+				yyval = addNode(yyvsp[-2], yyvsp[0]); 
 			}
-#line 1797 "cm.tab.c" /* yacc.c:1646  */
+#line 1694 "cm.tab.c"
     break;
 
-  case 61:
-#line 260 "cm.y" /* yacc.c:1646  */
-    { 
-		 		(yyval) = (yyvsp[0]); 
+  case 62: /* arg_list: expression  */
+#line 263 "cm.y"
+                             { 
+		 		yyval = yyvsp[0]; 
 			}
-#line 1805 "cm.tab.c" /* yacc.c:1646  */
+#line 1702 "cm.tab.c"
     break;
 
-  case 62:
-#line 265 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = (yyvsp[0]);
+  case 63: /* _var: _id  */
+#line 268 "cm.y"
+                    {
+				yyval = yyvsp[0];
 			}
-#line 1813 "cm.tab.c" /* yacc.c:1646  */
+#line 1710 "cm.tab.c"
     break;
 
-  case 63:
-#line 268 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = newArrayNode((yyvsp[-3]), (yyvsp[-1]));
+  case 64: /* _var: _id LBRACKET expression RBRACKET  */
+#line 271 "cm.y"
+                                                           {
+				yyval = newArrayNode(yyvsp[-3], yyvsp[-1]);
 			}
-#line 1821 "cm.tab.c" /* yacc.c:1646  */
+#line 1718 "cm.tab.c"
     break;
 
-  case 64:
-#line 273 "cm.y" /* yacc.c:1646  */
-    {
-			(yyval) = newIdNode(tokenString);
+  case 65: /* _id: ID  */
+#line 276 "cm.y"
+                   {
+			yyval = newIdNode(tokenName);
 		}
-#line 1829 "cm.tab.c" /* yacc.c:1646  */
+#line 1726 "cm.tab.c"
     break;
 
-  case 65:
-#line 278 "cm.y" /* yacc.c:1646  */
-    {
-				(yyval) = newConstNode(tokenString);
+  case 66: /* _num: NUM  */
+#line 281 "cm.y"
+                    {
+				yyval = newConstNode(tokenValue);
 			}
-#line 1837 "cm.tab.c" /* yacc.c:1646  */
+#line 1734 "cm.tab.c"
     break;
 
 
-#line 1841 "cm.tab.c" /* yacc.c:1646  */
+#line 1738 "cm.tab.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1851,25 +1749,23 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -1880,50 +1776,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -1952,12 +1812,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -1974,13 +1833,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -1994,7 +1854,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2006,7 +1866,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2017,26 +1877,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2052,20 +1916,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 282 "cm.y" /* yacc.c:1906  */
+
+#line 285 "cm.y"
 
 
 int yyerror(char * message) { 
@@ -2094,6 +1956,7 @@ static int yylex(void) {
 }
 
 TreeNode * parse(void) { 
+	savedTree = NULL;
 	yyparse();
 	return savedTree;
 }
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_CM_TAB_H_INCLUDED
 # define YY_YY_CM_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -40,48 +45,53 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    ELSE = 258,
-    IF = 259,
-    INT = 260,
-    RETURN = 261,
-    VOID = 262,
-    WHILE = 263,
-    ID = 264,
-    NUM = 265,
-    PLUS = 266,
-    MINUS = 267,
-    TIMES = 268,
-    OVER = 269,
-    LT = 270,
-    LE = 271,
-    GT = 272,
-    GE = 273,
-    EQ = 274,
-    NE = 275,
-    ASSIGN = 276,
-    SEMI = 277,
-    COMMA = 278,
-    LPAREN = 279,
-    RPAREN = 280,
-    LBRACKET = 281,
-    RBRACKET = 282,
-    LBRACE = 283,
-    RBRACE = 284,
-    THEN = 285,
-    END = 286,
-    REPEAT = 287,
-    UNTIL = 288,
-    READ = 289,
-    WRITE = 290,
-    ENDFILE = 291,
-    ERROR = 292,
-    LOWER_ELSE = 293
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    ELSE = 258,                    /* ELSE  */
+    IF = 259,                      /* IF  */
+    INT = 260,                     /* INT  */
+    RETURN = 261,                  /* RETURN  */
+    VOID = 262,                    /* VOID  */
+    WHILE = 263,                   /* WHILE  */
+    ID = 264,                      /* ID  */
+    NUM = 265,                     /* NUM  */
+    PLUS = 266,                    /* PLUS  */
+    MINUS = 267,                   /* MINUS  */
+    TIMES = 268,                   /* TIMES  */
+    OVER = 269,                    /* OVER  */
+    LT = 270,                      /* LT  */
+    LE = 271,                      /* LE  */
+    GT = 272,                      /* GT  */
+    GE = 273,                      /* GE  */
+    EQ = 274,                      /* EQ  */
+    NE = 275,                      /* NE  */
+    ASSIGN = 276,                  /* ASSIGN  */
+    SEMI = 277,                    /* SEMI  */
+    COMMA = 278,                   /* COMMA  */
+    LPAREN = 279,                  /* LPAREN  */
+    RPAREN = 280,                  /* RPAREN  */
+    LBRACKET = 281,                /* LBRACKET  */
+    RBRACKET = 282,                /* RBRACKET  */
+    LBRACE = 283,                  /* LBRACE  */
+    RBRACE = 284,                  /* RBRACE  */
+    THEN = 285,                    /* THEN  */
+    END = 286,                     /* END  */
+    REPEAT = 287,                  /* REPEAT  */
+    UNTIL = 288,                   /* UNTIL  */
+    READ = 289,                    /* READ  */
+    WRITE = 290,                   /* WRITE  */
+    ENDFILE = 291,                 /* ENDFILE  */
+    ERROR = 292,                   /* ERROR  */
+    LOWER_ELSE = 293               /* LOWER_ELSE  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
@@ -94,6 +104,8 @@ typedef int YYSTYPE;
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_CM_TAB_H_INCLUDED  */
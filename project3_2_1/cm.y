@@ -10,8 +10,7 @@
 #define YYSTYPE TreeNode *
 static int yylex(void);
 
-static char * savedName; /* for use in assignments */
-static int savedLineNo;  /* ditto */
+static int savedLineNo;  /* for use in declarations */
 static TreeNode * savedTree; /* stores syntax tree for later return */
 
 %}
@@ -50,7 +49,6 @@ declaration	:	variable_declaration {
 				}
 				;
 variable_declaration	:	type_check _id SEMI {
-							 savedName = copyString(tokenString);	
 							 savedLineNo = lineno;
 							 $$ = variableDeclarationNode($1, $2, savedLineNo);
 							}
@@ -61,10 +59,15 @@ variable_declaration	:	type_check _id SEMI {
 							;
 
 function_declaration	:	type_check _id LPAREN _parameters RPAREN _compoundStatement {
-							 	printf("function\n");
+							 	if (TraceParse) printf("function\n");
 								savedLineNo = lineno;
 								$$ = functionDeclarationNode($1, $2, $4, $6, savedLineNo);
 							}
+							| type_check _id LPAREN _parameters RPAREN SEMI {
+								/* a function defined in another unit */
+								savedLineNo = lineno;
+								$$ = functionDeclarationNode($1, $2, $4, NULL, savedLineNo);
+							}
 							;
 
 type_check	:	INT {
@@ -123,11 +126,11 @@ statement	:	expressionStmt {
 				 	$$ = $1;
 				}
 				| selectionStmt {
-				 	printf("selection\n");
+				 	if (TraceParse) printf("selection\n");
 				 	$$ = $1;
 				}
 				| iterationStmt {
-				 	printf("iteration\n");
+				 	if (TraceParse) printf("iteration\n");
 				 	$$ = $1;
 				}
 				| returnStmt {
@@ -271,12 +274,12 @@ _var	:	_id {
 			;
 
 _id	:	ID {
-			$$ = newIdNode(tokenString);
+			$$ = newIdNode(tokenName);
 		}
 		;
 					
 _num	:	NUM {
-				$$ = newConstNode(tokenString);
+				$$ = newConstNode(tokenValue);
 			}
 			;
 %%
@@ -307,6 +310,7 @@ static int yylex(void) {
 }
 
 TreeNode * parse(void) { 
+	savedTree = NULL;
 	yyparse();
 	return savedTree;
 }
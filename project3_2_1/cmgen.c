@@ -0,0 +1,292 @@
+/* FILE: cmgen.c */
+/* Workload generator for the C-Minus compiler: writes valid */
+/* C-Minus programs of any size to stdout, for measuring how */
+/* the scanner, parser and analyzer scale */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAMESIZE 64
+#define ARRAYSIZE 16	/* of global arrays; constant indices stay below */
+#define TRIPS 3		/* iterations of every generated loop */
+#define LEAVES 16	/* the first functions, which call none */
+
+static int functions = 100;	/* besides main */
+static int globals = 20;	/* every fourth an array */
+static int locals = 4;		/* per function, besides loop counters */
+static int statements = 20;	/* per function, nested ones included */
+static int depth = 2;		/* of nested if and while statements */
+static int idlen = 6;		/* of every identifier */
+static int calls = 10;		/* percent of expressions that call */
+static long lines = 0;		/* functions are added until there are as many */
+static unsigned long long seed = 1;
+
+static long printed = 0;	/* lines written */
+
+/* xorshift64, so a seed gives the same program everywhere */
+static unsigned random32(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned)(seed >> 32);
+}
+
+static int chance(int percent) {
+	return (int)(random32() % 100) < percent;
+}
+
+/* Function name returns identifier k of a kind: its prefix,
+ * which no keyword starts with, then k in base 26 padded to
+ * idlen letters; the buffers are used in turn
+ */
+static char *name(char prefix, int k) {
+	static char buf[8][NAMESIZE];
+	static int next = 0;
+	char *s = buf[next++ % 8];
+	char digits[NAMESIZE];
+	int n = 0, len;
+
+	do {
+		digits[n++] = 'a' + k % 26;
+		k /= 26;
+	} while (k > 0 && n < NAMESIZE - 2);
+	len = idlen - 1 > n ? idlen - 1 : n;
+	s[0] = prefix;
+	memset(s + 1, 'a', len - n);
+	for (k = 0; k < n; ++k) s[len - k] = digits[k];
+	s[len + 1] = '\0';
+	return s;
+}
+
+static void indent(int level) {
+	while (level-- > 0) putchar('\t');
+}
+
+static void line(void) {
+	putchar('\n');
+	printed++;
+}
+
+/* the function being written: its parameters and locals,
+ * none in main, and the functions before it; it calls only
+ * the leaves among them, so a program runs in time linear
+ * in its size
+ */
+static int fn, params, scopeLocals;
+static int *paramsOf;
+
+static void global(void) {
+	int k = random32() % globals;
+
+	if (k % 4 == 3) printf("%s[%u]", name('g', k), random32() % ARRAYSIZE);
+	else printf("%s", name('g', k));
+}
+
+static void term(void) {
+	int kind = random32() % 4;
+
+	if (kind == 1 && params > 0) printf("%s", name('p', random32() % params));
+	else if (kind == 2 && scopeLocals > 0) printf("%s", name('l', random32() % scopeLocals));
+	else if (kind == 3 && globals > 0) global();
+	else printf("%u", random32() % 100);
+}
+
+/* Function callees returns how many functions the one being
+ * written may call: the leaves before it, none for a leaf
+ */
+static int callees(void) {
+	return fn < LEAVES ? 0 : LEAVES;
+}
+
+static void call(int callee) {
+	int k;
+
+	printf("%s(", name('f', callee));
+	for (k = 0; k < paramsOf[callee]; ++k) {
+		if (k > 0) printf(", ");
+		term();
+	}
+	printf(")");
+}
+
+static void expression(void) {
+	static char *op[] = { "+", "-", "*", "+", "-" };
+
+	if (callees() > 0 && chance(calls)) call(random32() % callees());
+	else {
+		term();
+		if (chance(60)) {
+			printf(" %s ", op[random32() % 5]);
+			term();
+		}
+		else if (chance(10)) printf(" / %u", 1 + random32() % 9);
+	}
+}
+
+static void condition(void) {
+	static char *rel[] = { "<", "<=", ">", ">=", "==", "!=" };
+
+	term();
+	printf(" %s ", rel[random32() % 6]);
+	term();
+}
+
+static void assignment(int level) {
+	indent(level);
+	if (scopeLocals > 0 && (globals == 0 || chance(70))) printf("%s", name('l', random32() % scopeLocals));
+	else if (globals > 0) global();
+	else printf("%s", name('p', random32() % params));
+	printf(" = ");
+	expression();
+	printf(";");
+	line();
+}
+
+/* Procedure block writes *budget statements at most, nested
+ * no deeper than depth; the loop counter of a while at level
+ * n is c<n>, which nothing else assigns, so every loop ends
+ */
+static void block(int level, int *budget) {
+	int n = 1 + random32() % 4;
+
+	while (n-- > 0 && *budget > 0) {
+		int kind = random32() % 10;
+
+		(*budget)--;
+		if (level - 1 < depth && kind == 0) {
+			indent(level);
+			printf("if (");
+			condition();
+			printf(") {");
+			line();
+			block(level + 1, budget);
+			indent(level);
+			if (chance(50)) {
+				printf("} else {");
+				line();
+				block(level + 1, budget);
+				indent(level);
+			}
+			printf("}");
+			line();
+		}
+		else if (level - 1 < depth && kind == 1) {
+			char counter[NAMESIZE];
+
+			strcpy(counter, name('c', level));
+			indent(level);
+			printf("%s = 0;", counter);
+			line();
+			indent(level);
+			printf("while (%s < %d) {", counter, TRIPS);
+			line();
+			block(level + 1, budget);
+			indent(level + 1);
+			printf("%s = %s + 1;", counter, counter);
+			line();
+			indent(level);
+			printf("}");
+			line();
+		}
+		else if (callees() > 0 && kind == 2 && chance(calls * 4)) {
+			indent(level);
+			call(random32() % callees());
+			printf(";");
+			line();
+		}
+		else assignment(level);
+	}
+}
+
+static void function(int k) {
+	int budget = statements, j;
+
+	fn = k;
+	params = paramsOf[k];
+	scopeLocals = locals;
+	printf("int %s(", name('f', k));
+	for (j = 0; j < params; ++j) printf("%sint %s", j > 0 ? ", " : "", name('p', j));
+	printf(")");
+	line();
+	printf("{");
+	line();
+	for (j = 0; j < locals; ++j) {
+		printf("\tint %s;", name('l', j));
+		line();
+	}
+	for (j = 1; j <= depth; ++j) {
+		printf("\tint %s;", name('c', j));
+		line();
+	}
+	for (j = 0; j < locals; ++j) {
+		printf("\t%s = %s;", name('l', j), name('p', j % params));
+		line();
+	}
+	while (budget > 0) block(1, &budget);
+	printf("\treturn ");
+	expression();
+	printf(";");
+	line();
+	printf("}");
+	line();
+}
+
+static void usage(char *name) {
+	fprintf(stderr, "usage: %s [-functions=N] [-globals=N] [-locals=N] [-statements=N] [-depth=N] [-idlen=N] [-calls=PERCENT] [-lines=N] [-seed=N]\n", name);
+	exit(1);
+}
+
+int main(int argc, char *argv[]) {
+	int arg, k, cap;
+
+	for (arg = 1; arg < argc; ++arg) {
+		if (!strncmp(argv[arg], "-functions=", 11)) functions = atoi(argv[arg] + 11);
+		else if (!strncmp(argv[arg], "-globals=", 9)) globals = atoi(argv[arg] + 9);
+		else if (!strncmp(argv[arg], "-locals=", 8)) locals = atoi(argv[arg] + 8);
+		else if (!strncmp(argv[arg], "-statements=", 12)) statements = atoi(argv[arg] + 12);
+		else if (!strncmp(argv[arg], "-depth=", 7)) depth = atoi(argv[arg] + 7);
+		else if (!strncmp(argv[arg], "-idlen=", 7)) idlen = atoi(argv[arg] + 7);
+		else if (!strncmp(argv[arg], "-calls=", 7)) calls = atoi(argv[arg] + 7);
+		else if (!strncmp(argv[arg], "-lines=", 7)) lines = atol(argv[arg] + 7);
+		else if (!strncmp(argv[arg], "-seed=", 6)) seed = strtoull(argv[arg] + 6, NULL, 10);
+		else usage(argv[0]);
+	}
+	if (functions < 0 || globals < 0 || locals < 0 || statements < 0 || depth < 0 ||
+			idlen < 2 || idlen >= NAMESIZE || calls < 0 || calls > 100 || lines < 0)
+		usage(argv[0]);
+	if (seed == 0) seed = 1;
+
+	for (k = 0; k < globals; ++k) {
+		if (k % 4 == 3) printf("int %s[%d];", name('g', k), ARRAYSIZE);
+		else printf("int %s;", name('g', k));
+		line();
+	}
+	cap = functions > 0 ? functions : 1;
+	paramsOf = (int *)malloc(cap * sizeof(int));
+	for (k = 0; k < functions || printed < lines; ++k) {
+		if (k == cap) {
+			cap *= 2;
+			paramsOf = (int *)realloc(paramsOf, cap * sizeof(int));
+		}
+		paramsOf[k] = 1 + random32() % 3;
+		line();
+		function(k);
+	}
+	fn = k;
+	line();
+	printf("void main(void)");
+	line();
+	printf("{");
+	line();
+	if (fn > 0) {
+		params = scopeLocals = 0;
+		printf("\toutput(");
+		call(fn - 1);
+		printf(");");
+		line();
+	}
+	printf("}");
+	line();
+	return 0;
+}
@@ -0,0 +1,82 @@
+/* FILE: cmrt.c */
+/* Runtime for C-Minus programs compiled to x86-64: */
+/* cc -o prog prog.s cmrt.c */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void cmrt_start(void);
+
+/* the counters of a program compiled with -profile, ending
+ * with a null count; there are none without it
+ */
+struct cmrt_counter {
+	int *count;
+	int kind;		/* the calls of a function, the iterations of a loop, either side of an if */
+	int line;		/* of the loop or if */
+	int ordinal;		/* among the loops and ifs on the line, from 1 */
+	const char *name;
+};
+
+static const char *heading[][2] = {
+	{ "calls", "function" }, { "iterations", "loop" }, { "then", "if" }, { "else", "if" }
+};
+
+extern struct cmrt_counter cmrt_profile[] __attribute__((weak));
+
+/* report the counters like the TM simulator does: a section
+ * for every kind, each the most frequent first
+ */
+static void cmrt_report(void) {
+	struct cmrt_counter **order;
+	int kind, k, j, n = 0;
+
+	while (cmrt_profile[n].count != NULL) n++;
+	order = malloc((n + 1) * sizeof(*order));
+	for (kind = 0; kind < 4; ++kind) {
+		int m = 0;
+
+		for (k = 0; k < n; ++k) {
+			if (cmrt_profile[k].kind != kind) continue;
+			for (j = m++; j > 0 && *order[j - 1]->count < *cmrt_profile[k].count; --j)
+				order[j] = order[j - 1];
+			order[j] = &cmrt_profile[k];
+		}
+		if (m == 0) continue;
+		fprintf(stderr, "%12s  %s\n", heading[kind][0], heading[kind][1]);
+		for (k = 0; k < m; ++k) {
+			struct cmrt_counter *c = order[k];
+
+			if (kind == 0) fprintf(stderr, "%12d  %s\n", *c->count, c->name);
+			else if (c->ordinal > 1) fprintf(stderr, "%12d  %s:%d.%d\n", *c->count, c->name, c->line, c->ordinal);
+			else fprintf(stderr, "%12d  %s:%d\n", *c->count, c->name, c->line);
+		}
+	}
+	free(order);
+}
+
+/* called by a failed bounds check of code compiled with
+ * -fbounds-check
+ */
+void cmrt_bounds(int line) {
+	fflush(stdout);
+	fprintf(stderr, "Array index out of bounds at line %d\n", line);
+	exit(2);
+}
+
+int cm_input(void) {
+	int x;
+
+	if (scanf("%d", &x) != 1) x = 0;
+	return x;
+}
+
+void cm_output(int x) {
+	printf("%d\n", x);
+}
+
+int main(void) {
+	cmrt_start();
+	if (cmrt_profile != NULL) cmrt_report();
+	return 0;
+}
@@ -0,0 +1,288 @@
+/* FILE: code.c */
+/* TM code emitting utilities for the C-Minus compiler */
+
+#include <stdarg.h>
+#include "globals.h"
+#include "util.h"
+#include "code.h"
+#include "peephole.h"
+#include "tmb.h"
+
+/* TM location number for current instruction emission */
+static int emitLoc = 0;
+
+/* Highest TM location emitted so far
+ * For use in conjunction with emitSkip,
+ * emitBackup, and emitRestore
+ */
+static int highEmitLoc = 0;
+
+/* the instruction buffer, one entry past highEmitLoc
+ * holding the comments after the last instruction
+ */
+static TmInstr *codeBuf = NULL;
+static int codeCap = 0;
+
+/* the functions and globals of the unit */
+static char **funcName = NULL;
+static int *funcLoc = NULL;
+static int nfuncs = 0;
+
+static char **dataName = NULL;
+static int *dataBase = NULL, *dataWords = NULL;
+static int ndata = 0;
+
+/* the counters of -profile */
+static char **counterName = NULL;
+static int *counterKind = NULL, *counterLine = NULL, *counterOrdinal = NULL, *counterWord = NULL;
+static int ncounters = 0;
+
+static char *opName[] = {
+	"HALT", "IN", "OUT", "ADD", "SUB", "MUL", "DIV", "????",
+	"LD", "ST", "????",
+	"LDA", "LDC", "JLT", "JLE", "JGT", "JGE", "JEQ", "JNE", "????"
+};
+
+/* Procedure reserve grows the buffer to hold location loc */
+static void reserve(int loc) {
+	int k, old = codeCap;
+
+	if (loc < codeCap) return;
+	codeCap = codeCap > 0 ? codeCap : 256;
+	while (codeCap <= loc) codeCap *= 2;
+	codeBuf = (TmInstr *)realloc(codeBuf, codeCap * sizeof(TmInstr));
+	for (k = old; k < codeCap; ++k) {
+		codeBuf[k].op = -1;
+		codeBuf[k].reloc = RelNone;
+		codeBuf[k].sym = NULL;
+		codeBuf[k].comment = codeBuf[k].before = NULL;
+	}
+}
+
+static int lookupOp(char *op) {
+	int k;
+
+	for (k = 0; k < opRALim; ++k)
+		if (!strcmp(opName[k], op)) return k;
+	fprintf(listing, "BUG: unknown TM opcode %s\n", op);
+	return opHALT;
+}
+
+static void setInstr(char *op, int r, int s, int t, int d, char *c) {
+	TmInstr *i;
+
+	reserve(emitLoc + 1);
+	i = &codeBuf[emitLoc++];
+	i->op = lookupOp(op);
+	i->r = r;
+	i->s = s;
+	i->t = t;
+	i->d = d;
+	i->reloc = RelNone;
+	i->sym = NULL;
+	if (i->comment != NULL) free(i->comment);
+	i->comment = TraceCode ? copyString(c) : NULL;
+	if (highEmitLoc < emitLoc) highEmitLoc = emitLoc;
+}
+
+void emitComment(char *c) {
+	TmInstr *i;
+	int len;
+
+	if (!TraceCode) return;
+	reserve(emitLoc);
+	i = &codeBuf[emitLoc];
+	len = i->before != NULL ? strlen(i->before) : 0;
+	i->before = (char *)realloc(i->before, len + strlen(c) + 4);
+	sprintf(i->before + len, "* %s\n", c);
+}
+
+void emitRO(char *op, int r, int s, int t, char *c) {
+	setInstr(op, r, s, t, 0, c);
+}
+
+void emitRM(char *op, int r, int d, int s, char *c) {
+	setInstr(op, r, s, 0, d, c);
+}
+
+int emitSkip(int howMany) {
+	int i = emitLoc;
+
+	emitLoc += howMany;
+	if (highEmitLoc < emitLoc) highEmitLoc = emitLoc;
+	return i;
+}
+
+void emitBackup(int loc) {
+	if (loc > highEmitLoc) emitComment("BUG in emitBackup");
+	emitLoc = loc;
+}
+
+void emitRestore(void) {
+	emitLoc = highEmitLoc;
+}
+
+void emitRM_Abs(char *op, int r, int a, char *c) {
+	setInstr(op, r, pc, 0, a - (emitLoc + 1), c);
+}
+
+void emitReloc(int kind, char *sym) {
+	codeBuf[emitLoc - 1].reloc = kind;
+	codeBuf[emitLoc - 1].sym = sym;
+}
+
+void emitFunction(char *name, int loc) {
+	funcName = (char **)realloc(funcName, (nfuncs + 1) * sizeof(char *));
+	funcLoc = (int *)realloc(funcLoc, (nfuncs + 1) * sizeof(int));
+	funcName[nfuncs] = name;
+	funcLoc[nfuncs++] = loc;
+}
+
+void emitData(char *name, int base, int words) {
+	dataName = (char **)realloc(dataName, (ndata + 1) * sizeof(char *));
+	dataBase = (int *)realloc(dataBase, (ndata + 1) * sizeof(int));
+	dataWords = (int *)realloc(dataWords, (ndata + 1) * sizeof(int));
+	dataName[ndata] = name;
+	dataBase[ndata] = base;
+	dataWords[ndata++] = words;
+}
+
+void emitProfile(int kind, char *name, int line, int ordinal, int word) {
+	counterKind = (int *)realloc(counterKind, (ncounters + 1) * sizeof(int));
+	counterName = (char **)realloc(counterName, (ncounters + 1) * sizeof(char *));
+	counterLine = (int *)realloc(counterLine, (ncounters + 1) * sizeof(int));
+	counterOrdinal = (int *)realloc(counterOrdinal, (ncounters + 1) * sizeof(int));
+	counterWord = (int *)realloc(counterWord, (ncounters + 1) * sizeof(int));
+	counterKind[ncounters] = kind;
+	counterName[ncounters] = name;
+	counterLine[ncounters] = line;
+	counterOrdinal[ncounters] = ordinal;
+	counterWord[ncounters++] = word;
+}
+
+/* the text of the code file, written at once */
+static char *text = NULL;
+static int textLen = 0, textCap = 0;
+
+static void put(char *fmt, ...) {
+	va_list ap;
+	int n;
+
+	for (;;) {
+		va_start(ap, fmt);
+		n = vsnprintf(text + textLen, textCap - textLen, fmt, ap);
+		va_end(ap);
+		if (n < textCap - textLen) break;
+		textCap = textCap > 0 ? 2 * textCap + n : 4096 + n;
+		text = (char *)realloc(text, textCap);
+	}
+	textLen += n;
+}
+
+/* Procedure putObject puts the directives of an object file:
+ * its data size, the globals and functions it defines, and
+ * the instructions the linker adjusts
+ */
+static void putObject(int n, int words) {
+	static char *relocName[] = { "", "code", "data", "import" };
+	int k;
+
+	put("* C-Minus object file\n");
+	put(".data %d\n", words);
+	for (k = 0; k < ndata; ++k) put(".global %s %d %d\n", dataName[k], dataBase[k], dataWords[k]);
+	for (k = 0; k < nfuncs; ++k) put(".function %s %d\n", funcName[k], funcLoc[k]);
+	for (k = 0; k < n; ++k) {
+		if (codeBuf[k].op < 0 || codeBuf[k].reloc == RelNone) continue;
+		put(".reloc %d %s", k, relocName[codeBuf[k].reloc]);
+		if (codeBuf[k].sym != NULL) put(" %s", codeBuf[k].sym);
+		put("\n");
+	}
+}
+
+static void writeText(int n, int words) {
+	TmInstr *i;
+	int loc, k;
+
+	if (SeparateCompile) putObject(n, words);
+	for (loc = 0; loc <= n; ++loc) {
+		i = &codeBuf[loc];
+		if (i->before != NULL) put("%s", i->before);
+		if (loc == n || i->op < 0) continue;
+		if (i->op < opRRLim) put("%3d:  %5s  %d,%d,%d ", loc, opName[i->op], i->r, i->s, i->t);
+		else put("%3d:  %5s  %d,%d(%d) ", loc, opName[i->op], i->r, i->d, i->s);
+		if (TraceCode) put("\t%s", i->comment);
+		put("\n");
+	}
+	/* comments to anything but a simulator that profiles */
+	for (k = 0; k < ncounters; ++k)
+		put("* profile %d %d %s %d %d\n", counterWord[k], counterKind[k], counterName[k], counterLine[k], counterOrdinal[k]);
+	fwrite(text, 1, textLen, code);
+	free(text);
+	text = NULL;
+	textLen = textCap = 0;
+}
+
+/* Procedure writeBinary writes the header and one record per
+ * location; unused locations become HALT like in the simulator
+ */
+static void writeBinary(int n, int words, int entry) {
+	size_t size = sizeof(TmbHeader) + n * sizeof(TmbInstr);
+	char *image = (char *)calloc(1, size);
+	TmbHeader *h = (TmbHeader *)image;
+	TmbInstr *b = (TmbInstr *)(image + sizeof(TmbHeader));
+	int loc;
+
+	memcpy(h->magic, TMB_MAGIC, 4);
+	h->ninstr = n;
+	h->dataWords = words;
+	h->entry = entry;
+	for (loc = 0; loc < n; ++loc) {
+		TmInstr *i = &codeBuf[loc];
+
+		if (i->op < 0) continue;
+		b[loc].op = i->op;
+		b[loc].r = i->r;
+		b[loc].s = i->s;
+		b[loc].t = i->t;
+		b[loc].d = i->d;
+	}
+	fwrite(image, 1, size, code);
+	free(image);
+}
+
+void emitFinish(int words) {
+	int n = highEmitLoc;
+	int loc, k;
+
+	reserve(n);
+	for (k = 0; k < nfuncs && strcmp(funcName[k], "main"); ++k);
+	if (Optimize && Peephole) {
+		/* an object file keeps every function for the linker,
+		 * a program only what main reaches
+		 */
+		if (SeparateCompile) n = peephole(codeBuf, n, funcLoc, nfuncs);
+		else n = peephole(codeBuf, n, funcLoc + k, k < nfuncs ? 1 : 0);
+	}
+	if (BinaryCode && !SeparateCompile) writeBinary(n, words, k < nfuncs ? funcLoc[k] : 0);
+	else writeText(n, words);
+	for (loc = 0; loc < codeCap; ++loc) {
+		free(codeBuf[loc].comment);
+		free(codeBuf[loc].before);
+	}
+	free(codeBuf);
+	codeBuf = NULL;
+	codeCap = emitLoc = highEmitLoc = 0;
+	free(funcName);
+	free(funcLoc);
+	free(dataName);
+	free(dataBase);
+	free(dataWords);
+	free(counterKind);
+	free(counterName);
+	free(counterLine);
+	free(counterOrdinal);
+	free(counterWord);
+	funcName = dataName = counterName = NULL;
+	funcLoc = dataBase = dataWords = counterKind = counterLine = counterOrdinal = counterWord = NULL;
+	nfuncs = ndata = ncounters = 0;
+}
@@ -0,0 +1,147 @@
+/* FILE: code.h */
+/* Code emitting utilities for the C-Minus compiler */
+/* and interface to the TM machine */
+
+#ifndef _CODE_H_
+#define _CODE_H_
+
+/* pc = program counter */
+#define pc 7
+
+/* fp = frame pointer: parameters are above it,
+ * the saved frame pointer is at 0(fp), the return
+ * address at -1(fp), locals and temporaries below
+ */
+#define fp 6
+
+/* gp = global pointer: globals start at 0(gp) */
+#define gp 5
+
+/* sp = stack pointer: first free word below the frame */
+#define sp 4
+
+/* accumulators */
+#define ac 0
+#define ac1 1
+
+/* scratch registers holding the caller's frame pointer
+ * and return address across a tail call
+ */
+#define ac2 2
+#define ac3 3
+
+/* TM opcodes, in the order of the simulator */
+typedef enum {
+	/* RO instructions */
+	opHALT, opIN, opOUT, opADD, opSUB, opMUL, opDIV,
+	opRRLim,
+	/* RM instructions */
+	opLD, opST,
+	opRMLim,
+	/* RA instructions */
+	opLDA, opLDC, opJLT, opJLE, opJGT, opJGE, opJEQ, opJNE,
+	opRALim
+} TmOpCode;
+
+/* how the linker adjusts an instruction of an object file */
+typedef enum {
+	RelNone,
+	RelCode,	/* d is a code location of the unit */
+	RelData,	/* d is a word of the global sym */
+	RelImport	/* LDC pc calling the function sym of another unit */
+} TmReloc;
+
+/* Instructions are kept in a buffer until emitFinish
+ * writes them; RO instructions use r,s,t and RM and RA
+ * instructions r,d(s)
+ */
+typedef struct {
+	int op;		/* a TmOpCode, -1 for an unused location */
+	int r, s, t, d;
+	int reloc;	/* a TmReloc */
+	char *sym;
+	char *comment;	/* NULL unless TraceCode is TRUE */
+	char *before;	/* comment lines printed before it */
+} TmInstr;
+
+/* code emitting utilities */
+
+/* Procedure emitComment prints a comment line with comment c in the code file */
+
+void emitComment(char *c);
+
+/* Procedure emitRO emits a register-only TM instruction
+ * op = the opcode
+ * r = target register
+ * s = 1st source register
+ * t = 2nd source register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRO(char *op, int r, int s, int t, char *c);
+
+/* Procedure emitRM emits a register-to-memory TM instruction
+ * op = the opcode
+ * r = target register
+ * d = the offset
+ * s = the base register
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM(char *op, int r, int d, int s, char *c);
+
+/* Function emitSkip skips "howMany" code locations for later
+ * backpatch. It also returns the current code position
+ */
+int emitSkip(int howMany);
+
+/* Procedure emitBackup backs up to loc = a previously skipped location */
+
+void emitBackup(int loc);
+
+/* Procedure emitRestore restores the current code position
+ * to the highest previously unemitted position
+ */
+void emitRestore(void);
+
+/* Procedure emitRM_Abs converts an absolute reference to a
+ * pc-relative reference when emitting a register-to-memory TM instruction
+ * op = the opcode
+ * r = target register
+ * a = the absolute location in memory
+ * c = a comment to be printed if TraceCode is TRUE
+ */
+void emitRM_Abs(char *op, int r, int a, char *c);
+
+/* Procedure emitReloc marks the last instruction emitted
+ * for the linker
+ * kind = a TmReloc
+ * sym = the function or global it refers to, or NULL
+ */
+void emitReloc(int kind, char *sym);
+
+/* Procedure emitFunction records that function name
+ * starts at code location loc
+ */
+void emitFunction(char *name, int loc);
+
+/* Procedure emitData records that global name takes
+ * words of data from word base on
+ */
+void emitData(char *name, int base, int words);
+
+/* Procedure emitProfile records that global word is a
+ * counter of -profile, of kind, a CountKind, for function
+ * name and the line and ordinal of a loop or if, for the
+ * simulator to report when the program ends
+ */
+void emitProfile(int kind, char *name, int line, int ordinal, int word);
+
+/* Procedure emitFinish runs the peephole optimizer over the
+ * buffered instructions when Optimize is TRUE and writes them
+ * to the code file with a single write: as an object file
+ * for tmld when SeparateCompile is TRUE, as binary code in
+ * the format of tmb.h when BinaryCode is TRUE, else as text
+ * dataWords = the words of global data
+ */
+void emitFinish(int dataWords);
+
+#endif
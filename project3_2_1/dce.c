@@ -0,0 +1,250 @@
+/* FILE: dce.c */
+/* Constant branch folding, unreachable block elimination, */
+/* and dead code elimination driven by liveness analysis */
+
+#include "globals.h"
+#include "ir.h"
+#include "ssa.h"
+#include "opt.h"
+
+int foldBranches(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	IrInstr *def = (IrInstr *)calloc(f->nregs, sizeof(IrInstr));
+	int folded = 0;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->op == IrConst) def[i->dst] = i;
+	for (b = f->entry; b != NULL; b = b->next) {
+		IrBlock dead;
+
+		i = b->last;
+		if (i == NULL || i->op != IrBranch || def[i->src[0]] == NULL) continue;
+		if (def[i->src[0]]->imm != 0) {
+			dead = b->succ[1];
+		}
+		else {
+			dead = b->succ[0];
+			b->succ[0] = b->succ[1];
+		}
+		b->nsucc = 1;
+		/* if both edges went to the same block, one of them stays */
+		removePred(dead, b);
+		i->op = IrJump;
+		i->src[0] = -1;
+		folded++;
+	}
+	free(def);
+	computeDominators(f);
+	return folded;
+}
+
+/* Procedure mergeBlocks straightens the control flow graph of a
+ * function out of SSA form: a block that is the only successor
+ * of its only predecessor is appended to it, and predecessors of
+ * a block holding just a jump are sent to its target instead
+ */
+static int mergeBlocks(IrFunc f) {
+	IrBlock b, s, prev;
+	IrInstr i, next;
+	int k, j, merged = 0;
+
+	for (b = f->entry; b != NULL; b = b->next) {
+		while (b->nsucc == 1 && (s = b->succ[0]) != b && s != f->entry && s->npred == 1) {
+			removeInstr(b->last);
+			for (i = s->first; i != NULL; i = next) {
+				next = i->next;
+				removeInstr(i);
+				appendInstr(b, i);
+			}
+			b->nsucc = s->nsucc;
+			for (k = 0; k < s->nsucc; ++k) {
+				b->succ[k] = s->succ[k];
+				for (j = 0; j < s->succ[k]->npred; ++j)
+					if (s->succ[k]->pred[j] == s) s->succ[k]->pred[j] = b;
+			}
+			s->nsucc = s->npred = 0;
+			for (prev = f->entry; prev->next != s; prev = prev->next);
+			prev->next = s->next;
+			merged++;
+		}
+	}
+
+	for (prev = f->entry, b = prev->next; b != NULL; b = prev->next) {
+		IrBlock t;
+
+		if (b->first == NULL || b->first != b->last || b->first->op != IrJump || (t = b->succ[0]) == b) {
+			prev = b;
+			continue;
+		}
+		for (k = 0; k < b->npred; ++k) {
+			IrBlock p = b->pred[k];
+			for (j = 0; j < p->nsucc; ++j)
+				if (p->succ[j] == b) p->succ[j] = t;
+			if (t->npred == t->predCap) {
+				t->predCap *= 2;
+				t->pred = (IrBlock *)realloc(t->pred, t->predCap * sizeof(IrBlock));
+			}
+			t->pred[t->npred++] = p;
+		}
+		removePred(t, b);
+		prev->next = b->next;
+		merged++;
+	}
+	return merged;
+}
+
+/* liveness sets are bit vectors over the registers */
+
+#define WORDBITS (8 * (int)sizeof(unsigned))
+
+static int setWords;
+
+#define SET_HAS(s, r) ((s)[(r) / WORDBITS] & (1u << ((r) % WORDBITS)))
+#define SET_ADD(s, r) ((s)[(r) / WORDBITS] |= (1u << ((r) % WORDBITS)))
+#define SET_DEL(s, r) ((s)[(r) / WORDBITS] &= ~(1u << ((r) % WORDBITS)))
+
+static void useRegs(unsigned *live, IrInstr i) {
+	int k;
+
+	for (k = 0; k < 2; ++k)
+		if (i->src[k] >= 0) SET_ADD(live, i->src[k]);
+	for (k = 0; k < i->nargs; ++k) SET_ADD(live, i->args[k]);
+}
+
+/* Procedure computeLiveness computes the registers live on exit
+ * from every block by backward iteration to a fixed point;
+ * liveOut is indexed by block id
+ */
+static void computeLiveness(IrFunc f, unsigned **liveOut) {
+	unsigned **liveIn = (unsigned **)calloc(f->nblocks, sizeof(unsigned *));
+	unsigned *live = (unsigned *)malloc(setWords * sizeof(unsigned));
+	IrBlock b;
+	IrInstr i;
+	int n, k, w, changed;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		liveIn[b->id] = (unsigned *)calloc(setWords, sizeof(unsigned));
+	do {
+		changed = FALSE;
+		for (n = f->nrpo - 1; n >= 0; --n) {
+			b = f->rpoOrder[n];
+			memset(liveOut[b->id], 0, setWords * sizeof(unsigned));
+			for (k = 0; k < b->nsucc; ++k)
+				for (w = 0; w < setWords; ++w) liveOut[b->id][w] |= liveIn[b->succ[k]->id][w];
+			memcpy(live, liveOut[b->id], setWords * sizeof(unsigned));
+			for (i = b->last; i != NULL; i = i->prev) {
+				if (i->dst >= 0) SET_DEL(live, i->dst);
+				useRegs(live, i);
+			}
+			if (memcmp(live, liveIn[b->id], setWords * sizeof(unsigned))) {
+				memcpy(liveIn[b->id], live, setWords * sizeof(unsigned));
+				changed = TRUE;
+			}
+		}
+	} while (changed);
+
+	for (b = f->entry; b != NULL; b = b->next) free(liveIn[b->id]);
+	free(liveIn);
+	free(live);
+}
+
+/* Function removeUnused removes the pure instructions whose
+ * results flow only into one another, like the copies a loop
+ * carries for registers of an inlined function that nothing
+ * reads, which stay live around the loop; a register is used
+ * if an instruction with an effect, or one defining a used
+ * register, reads it.  It returns the number removed
+ */
+static int removeUnused(IrFunc f) {
+	unsigned *used = (unsigned *)calloc(setWords, sizeof(unsigned));
+	IrBlock b, *order;
+	IrInstr i, prev;
+	int n = 0, k, r, removed = 0, changed;
+
+	for (b = f->entry; b != NULL; b = b->next) n++;
+	order = (IrBlock *)malloc(n * sizeof(IrBlock));
+	for (n = 0, b = f->entry; b != NULL; b = b->next) order[n++] = b;
+	do {
+		changed = FALSE;
+		/* backwards, as operands are mostly defined before use */
+		for (k = n - 1; k >= 0; --k)
+			for (i = order[k]->last; i != NULL; i = i->prev) {
+				if ((isPure(i->op) || i->op == IrLoad) && !SET_HAS(used, i->dst)) continue;
+				for (r = 0; r < 2; ++r)
+					if (i->src[r] >= 0 && !SET_HAS(used, i->src[r])) {
+						SET_ADD(used, i->src[r]);
+						changed = TRUE;
+					}
+				for (r = 0; r < i->nargs; ++r)
+					if (!SET_HAS(used, i->args[r])) {
+						SET_ADD(used, i->args[r]);
+						changed = TRUE;
+					}
+			}
+	} while (changed);
+	for (k = 0; k < n; ++k)
+		for (i = order[k]->last; i != NULL; i = prev) {
+			prev = i->prev;
+			if ((isPure(i->op) || i->op == IrLoad) && !SET_HAS(used, i->dst)) {
+				removeInstr(i);
+				free(i);
+				removed++;
+			}
+		}
+	free(order);
+	free(used);
+	return removed;
+}
+
+int eliminateDeadCode(IrFunc f, int *blocks) {
+	unsigned **liveOut;
+	unsigned *live;
+	IrBlock b;
+	IrInstr i, prev;
+	int removed = 0, changed, before = 0, after = 0;
+
+	for (b = f->entry; b != NULL; b = b->next) before++;
+	computeDominators(f);
+
+	setWords = (f->nregs + WORDBITS - 1) / WORDBITS + 1;
+	liveOut = (unsigned **)calloc(f->nblocks, sizeof(unsigned *));
+	for (b = f->entry; b != NULL; b = b->next)
+		liveOut[b->id] = (unsigned *)malloc(setWords * sizeof(unsigned));
+	live = (unsigned *)malloc(setWords * sizeof(unsigned));
+	removed = removeUnused(f);
+	do {
+		changed = FALSE;
+		computeLiveness(f, liveOut);
+		for (b = f->entry; b != NULL; b = b->next) {
+			memcpy(live, liveOut[b->id], setWords * sizeof(unsigned));
+			for (i = b->last; i != NULL; i = prev) {
+				prev = i->prev;
+				if (i->dst >= 0 && !SET_HAS(live, i->dst)) {
+					/* a dead store to a register */
+					if (isPure(i->op) || i->op == IrLoad) {
+						removeInstr(i);
+						free(i);
+						removed++;
+						changed = TRUE;
+						continue;
+					}
+					if (i->op == IrCall) i->dst = -1;
+				}
+				if (i->dst >= 0) SET_DEL(live, i->dst);
+				useRegs(live, i);
+			}
+		}
+	} while (changed);
+
+	for (b = f->entry; b != NULL; b = b->next) free(liveOut[b->id]);
+	free(liveOut);
+	free(live);
+
+	while (mergeBlocks(f) > 0);
+	computeDominators(f);
+	for (b = f->entry; b != NULL; b = b->next) after++;
+	*blocks = before - after;
+	return removed;
+}
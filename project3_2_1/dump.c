@@ -0,0 +1,161 @@
+/* FILE: dump.c */
+/* Machine-readable dumps: the symbol table and the tree are */
+/* streamed to the file as they are walked, each field */
+/* written where it is, with nothing built up in memory */
+
+#include "globals.h"
+#include "symtab.h"
+#include "dump.h"
+
+static const char *stmtName[] = { "IfK", "WhileK", "RepeatK", "AssignK", "ReadK", "WriteK",
+	"CompoundStmtK", "ExpressionStmtK", "SelectionStmtK", "IterationStmtK", "ReturnStmtK" };
+static const char *expName[] = { "OpK", "ConstK", "IdK", "ArrK",
+	"LvarK", "ComparisionExpK", "AdditiveExpK", "MultiplicativeExpK", "CallK" };
+static const char *declName[] = { "VarK", "VarArrK", "ParamK", "ParamArrK", "ParamVoidK", "FuncK", "TypeK" };
+
+static FILE *out;
+static DumpFormat format;
+static int nsymbols, nnodes;
+
+/* Function kindName returns the name of the kind of t */
+static const char *kindName(TreeNode *t) {
+	switch (t->nodekind) {
+	case StmtK:
+		if (t->kind.stmt <= ReturnStmtK) return stmtName[t->kind.stmt];
+		break;
+	case ExpK:
+		if (t->kind.exp <= CallK) return expName[t->kind.exp];
+		break;
+	case DeclK:
+		if (t->kind.decl <= TypeK) return declName[t->kind.decl];
+		break;
+	}
+	return "Unknown";
+}
+
+/* Function typeName returns what a TypeK node stands for:
+ * a type, or the operator the parser keeps there
+ */
+static const char *typeName(int type) {
+	switch (type) {
+	case Integer: return "int";
+	case Void: return "void";
+	case LT: return "<";
+	case LE: return "<=";
+	case GT: return ">";
+	case GE: return ">=";
+	case EQ: return "==";
+	case NE: return "!=";
+	case PLUS: return "+";
+	case MINUS: return "-";
+	case TIMES: return "*";
+	case OVER: return "/";
+	case ASSIGN: return "=";
+	default: return "?";
+	}
+}
+
+static void putInt(int n) {
+	unsigned v = ((unsigned)n << 1) ^ (unsigned)(n >> 31);
+
+	while (v >= 0x80) {
+		putc((v & 0x7f) | 0x80, out);
+		v >>= 7;
+	}
+	putc(v, out);
+}
+
+static void putString(const char *s) {
+	int n = strlen(s);
+
+	putInt(n);
+	fwrite(s, 1, n, out);
+}
+
+/* names, kinds and types are letters and operators, never
+ * anything JSON needs escaped
+ */
+static void symbol(BucketList l, int scope) {
+	LineList t;
+
+	if (format == DumpBinary) {
+		int n = 0;
+
+		putc('S', out);
+		putInt(l->id);
+		putInt(scope);
+		putInt(l->memloc);
+		putInt(l->arraySize);
+		putString(l->name);
+		putString(l->VPF);
+		putString(l->type);
+		for (t = l->lines; t != NULL; t = t->next) n++;
+		putInt(n);
+		for (t = l->lines; t != NULL; t = t->next) putInt(t->lineno);
+	}
+	else {
+		fprintf(out, "{\"symbol\":%d,\"name\":\"%s\",\"scope\":%d,\"memloc\":%d,\"vpf\":\"%s\",\"type\":\"%s\",\"arraySize\":%d,\"references\":[",
+			l->id, l->name, scope, l->memloc, l->VPF, l->type, l->arraySize);
+		for (t = l->lines; t != NULL; t = t->next)
+			fprintf(out, t == l->lines ? "%d" : ",%d", t->lineno);
+		fputs("]}\n", out);
+	}
+	nsymbols++;
+}
+
+/* Procedure node writes t, its subtrees and its siblings,
+ * which hang from slot child of node parent
+ */
+static void node(TreeNode *t, int parent, int child) {
+	int id, k;
+
+	for (; t != NULL; t = t->sibling) {
+		int isId = t->nodekind == ExpK && t->kind.exp == IdK;
+		int isConst = t->nodekind == ExpK && t->kind.exp == ConstK;
+		int isType = t->nodekind == DeclK && t->kind.decl == TypeK;
+
+		id = nnodes++;
+		if (format == DumpBinary) {
+			putc('N', out);
+			putInt(parent);
+			putInt(child);
+			putInt(t->lineno);
+			putInt(t->nodekind);
+			putInt(t->kind.stmt);
+			putInt(t->arraySize);
+			if (isId) {
+				putString(t->attr.name);
+				putInt(t->bucket != NULL ? t->bucket->id : -1);
+			}
+			else if (isConst) putInt(t->attr.val);
+			else if (isType) putString(typeName(t->type));
+		}
+		else {
+			fprintf(out, "{\"node\":%d,\"parent\":%d,\"child\":%d,\"line\":%d,\"kind\":\"%s\"",
+				id, parent, child, t->lineno, kindName(t));
+			if (isId)
+				fprintf(out, ",\"name\":\"%s\",\"symbol\":%d", t->attr.name, t->bucket != NULL ? t->bucket->id : -1);
+			else if (isConst) fprintf(out, ",\"value\":%d", t->attr.val);
+			else if (isType) fprintf(out, ",\"type\":\"%s\"", typeName(t->type));
+			if (t->arraySize != 0) fprintf(out, ",\"arraySize\":%d", t->arraySize);
+			fputs("}\n", out);
+		}
+		for (k = 0; k < MAXCHILDREN; ++k) node(t->child[k], id, k);
+	}
+}
+
+int dumpProgram(TreeNode *tree, FILE *f, DumpFormat dumpFormat) {
+	out = f;
+	format = dumpFormat;
+	nsymbols = nnodes = 0;
+	if (format == DumpBinary) fwrite(DUMP_MAGIC, 1, 4, out);
+	st_walk(symbol);
+	node(tree, -1, 0);
+	if (format == DumpBinary) {
+		putc('E', out);
+		putInt(nsymbols);
+		putInt(nnodes);
+	}
+	else fprintf(out, "{\"symbols\":%d,\"nodes\":%d}\n", nsymbols, nnodes);
+	return nnodes;
+}
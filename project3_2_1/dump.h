@@ -0,0 +1,47 @@
+/* FILE: dump.h */
+/* Machine-readable dumps of the checked syntax tree and */
+/* symbol table of the C-Minus compiler */
+
+#ifndef _DUMP_H_
+#define _DUMP_H_
+
+#define DUMP_MAGIC "CMD1"
+
+/* A dump holds the symbols, then the nodes of the tree in
+ * preorder, then a count of both.  Symbols are numbered in
+ * order of insertion and nodes in preorder; a node names
+ * its parent, -1 for a top-level declaration, and the child
+ * slot of the parent it hangs from, siblings following one
+ * another with the same parent and slot.
+ *
+ * As JSON Lines, one object per line:
+ *
+ *   {"symbol":2,"name":"x","scope":1,"memloc":0,"vpf":"Var",
+ *    "type":"array","arraySize":10,"references":[3,7]}
+ *   {"node":5,"parent":4,"child":1,"line":3,"kind":"IdK",
+ *    "name":"x","symbol":2}
+ *   {"symbols":12,"nodes":80}
+ *
+ * where an IdK node has its name and symbol, -1 if none is
+ * bound, a ConstK node its "value", a TypeK node its "type"
+ * and a node with an arraySize that too.
+ *
+ * In binary, DUMP_MAGIC and then records of the same fields,
+ * each a tag byte followed by integers, zigzag-encoded in
+ * groups of 7 bits, lowest first, and strings, a length and
+ * that many bytes:
+ *
+ *   'S' id scope memloc arraySize name vpf type n line...
+ *   'N' parent child line nodekind kind arraySize, then
+ *       name symbol for IdK, value for ConstK, type for TypeK,
+ *       the same strings as in JSON
+ *   'E' symbols nodes
+ */
+typedef enum { DumpJson, DumpBinary } DumpFormat;
+
+/* Function dumpProgram writes the symbol table and tree to
+ * file f in one pass and returns the number of nodes
+ */
+int dumpProgram(TreeNode *tree, FILE *f, DumpFormat format);
+
+#endif
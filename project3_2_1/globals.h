@@ -65,6 +65,10 @@ typedef enum {Void, Integer, Boolean,
 
 #define MAXCHILDREN 8
 
+/* symbol table record bound to ID nodes by the analyzer (see symtab.h) */
+
+struct BucketListRec;
+
 typedef struct treeNode
 {
   struct treeNode *child[MAXCHILDREN];
@@ -83,6 +87,7 @@ typedef struct treeNode
   } attr;
   int arraySize;
   ExpType type;
+  struct BucketListRec *bucket;
 } TreeNode;
 
 /*
@@ -124,6 +129,58 @@ extern int TraceAnalyze;
 
 extern int TraceCode;
 
+/* TraceOptimize = TRUE causes the optimizer statistics and the optimized IR to be printed to the listing file */
+
+extern int TraceOptimize;
+
+/* Optimize = TRUE runs the IR optimization passes (set by the -O option) */
+
+extern int Optimize;
+
+/* LoopInvariantMotion = TRUE lets the optimizer hoist loop-invariant code (cleared by -fno-licm) */
+
+extern int LoopInvariantMotion;
+
+/* TailCalls = TRUE lets the optimizer eliminate tail calls (cleared by -fno-tail-calls) */
+
+extern int TailCalls;
+
+/* Peephole = TRUE lets the optimizer rewrite the emitted TM code (cleared by -fno-peephole) */
+
+extern int Peephole;
+
+/* InlineLimit = the largest function, in IR instructions, the optimizer inlines (set by -finline-limit=N, 0 disables) */
+
+extern int InlineLimit;
+
+/* UnrollFactor = the copies of the body of a counted loop the optimizer runs per test (set by -funroll-factor=N, 1 disables) */
+
+extern int UnrollFactor;
+
+/* BoundsCheck = TRUE makes the program stop when an index of an array of known size is out of bounds, and -O elide the checks range analysis proves needless (set by -fbounds-check) */
+
+extern int BoundsCheck;
+
+/* NativeCode = TRUE makes codeGen emit x86-64 assembly instead of TM code (set by -x86-64) */
+
+extern int NativeCode;
+
+/* BinaryCode = TRUE makes codeGen write compact binary TM code instead of text (set by -binary) */
+
+extern int BinaryCode;
+
+/* SeparateCompile = TRUE compiles one unit of a program to an object file for tmld, or to assembly for the system linker with -x86-64 (set by -c) */
+
+extern int SeparateCompile;
+
+/* Profile = TRUE makes the generated program count the calls of every function and the iterations of every loop, and report them when it ends (set by -profile) */
+
+extern int Profile;
+
+/* ProfileUse = TRUE when -fprofile-use=FILE read the report of runs of a program compiled with -profile, for -O to inline by it and lay out the blocks of ifs with the hot side falling through */
+
+extern int ProfileUse;
+
 /* Error = TRUE prevents further passed if an error occurs */
 
 extern int Error;
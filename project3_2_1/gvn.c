@@ -0,0 +1,235 @@
+/* FILE: gvn.c */
+/* Dominator-based global value numbering over SSA form */
+/* (Briggs, Cooper and Simpson, "Value Numbering") */
+
+#include <limits.h>
+#include "globals.h"
+#include "ir.h"
+#include "opt.h"
+
+/* SIZE is the size of the value table */
+#define SIZE 4093
+
+typedef struct ValueRec {
+	IrOp op;
+	int a, b, imm;
+	int reg;		/* register holding the value */
+	struct ValueRec *next;
+} * Value;
+
+static Value valueTable[SIZE];
+
+/* undo log of the values entered in the current dominator path */
+static Value *valueLog;
+static int logTop, logCap;
+
+static int *rep;		/* representative register of every register */
+static char *isConst;
+static int *constVal;
+static int memEpoch;		/* bumped by every store and call */
+static int redundant, propagated;
+
+static int find(int v) {
+	while (rep[v] != v) {
+		rep[v] = rep[rep[v]];
+		v = rep[v];
+	}
+	return v;
+}
+
+static int hashValue(IrOp op, int a, int b, int imm) {
+	unsigned h = (unsigned)op;
+
+	h = h * 31 + (unsigned)a;
+	h = h * 31 + (unsigned)b;
+	h = h * 31 + (unsigned)imm;
+	return (int)(h % SIZE);
+}
+
+static int lookupValue(IrOp op, int a, int b, int imm) {
+	Value v = valueTable[hashValue(op, a, b, imm)];
+
+	while (v != NULL && !(v->op == op && v->a == a && v->b == b && v->imm == imm))
+		v = v->next;
+	return v == NULL ? -1 : v->reg;
+}
+
+static void enterValue(IrOp op, int a, int b, int imm, int reg) {
+	int h = hashValue(op, a, b, imm);
+	Value v = (Value)malloc(sizeof(struct ValueRec));
+
+	v->op = op;
+	v->a = a;
+	v->b = b;
+	v->imm = imm;
+	v->reg = reg;
+	v->next = valueTable[h];
+	valueTable[h] = v;
+	if (logTop == logCap) {
+		logCap = logCap == 0 ? 256 : logCap * 2;
+		valueLog = (Value *)realloc(valueLog, logCap * sizeof(Value));
+	}
+	valueLog[logTop++] = v;
+}
+
+/* values are unlinked in reverse order of entry, so each one
+ * is still at the head of its chain when it is removed
+ */
+static void leaveValues(int mark) {
+	while (logTop > mark) {
+		Value v = valueLog[--logTop];
+		int h = hashValue(v->op, v->a, v->b, v->imm);
+
+		valueTable[h] = v->next;
+		free(v);
+	}
+}
+
+static int isCommutative(IrOp op) {
+	return op == IrAdd || op == IrMul || op == IrEq || op == IrNe;
+}
+
+/* Function fold evaluates op over constants, returning FALSE
+ * when the result is not defined at compile time; sums and
+ * products wrap around like they do on the targets
+ */
+static int fold(IrOp op, int a, int b, int *result) {
+	switch (op) {
+		case IrAdd: *result = (int)((unsigned)a + (unsigned)b); break;
+		case IrSub: *result = (int)((unsigned)a - (unsigned)b); break;
+		case IrMul: *result = (int)((unsigned)a * (unsigned)b); break;
+		case IrDiv:
+			/* left to trap at run time */
+			if (b == 0 || (a == INT_MIN && b == -1)) return FALSE;
+			*result = a / b;
+			break;
+		case IrLt: *result = a < b; break;
+		case IrLe: *result = a <= b; break;
+		case IrGt: *result = a > b; break;
+		case IrGe: *result = a >= b; break;
+		case IrEq: *result = a == b; break;
+		case IrNe: *result = a != b; break;
+		default: return FALSE;
+	}
+	return TRUE;
+}
+
+/* Procedure numberInstr value numbers one instruction, removing it
+ * from its block when an equivalent value is already available
+ */
+static void numberInstr(IrInstr i) {
+	int k, found, a, b;
+
+	for (k = 0; k < 2; ++k)
+		if (i->src[k] >= 0) i->src[k] = find(i->src[k]);
+	for (k = 0; k < i->nargs; ++k) i->args[k] = find(i->args[k]);
+
+	if (i->op == IrCopy) {
+		rep[i->dst] = i->src[0];
+		removeInstr(i);
+		propagated++;
+		return;
+	}
+	if (i->op == IrStore) {
+		memEpoch++;
+		enterValue(IrLoad, i->src[0], -1, memEpoch, i->src[1]);
+		return;
+	}
+	if (i->op == IrCall) {
+		memEpoch++;
+		return;
+	}
+	if (i->op == IrLoad) {
+		found = lookupValue(IrLoad, i->src[0], -1, memEpoch);
+		if (found >= 0) {
+			rep[i->dst] = found;
+			removeInstr(i);
+			redundant++;
+		}
+		else enterValue(IrLoad, i->src[0], -1, memEpoch, i->dst);
+		return;
+	}
+	if (!isPure(i->op)) return;
+
+	if (i->op != IrConst && i->src[1] >= 0 && isConst[i->src[0]] && isConst[i->src[1]] &&
+			fold(i->op, constVal[i->src[0]], constVal[i->src[1]], &i->imm)) {
+		i->op = IrConst;
+		i->src[0] = i->src[1] = -1;
+	}
+	if (i->op == IrConst) {
+		isConst[i->dst] = TRUE;
+		constVal[i->dst] = i->imm;
+	}
+
+	a = i->src[0];
+	b = i->src[1];
+	if (isCommutative(i->op) && a > b) {
+		a = i->src[1];
+		b = i->src[0];
+	}
+	found = lookupValue(i->op, a, b, i->imm);
+	if (found >= 0) {
+		rep[i->dst] = found;
+		removeInstr(i);
+		redundant++;
+	}
+	else enterValue(i->op, a, b, i->imm, i->dst);
+}
+
+/* Procedure numberPhi removes phi functions whose operands
+ * all carry the same value
+ */
+static void numberPhi(IrInstr i) {
+	int k, same = -1;
+
+	for (k = 0; k < i->nargs; ++k) {
+		int a = find(i->args[k]);
+		if (a == i->dst) continue;
+		if (same >= 0 && a != same) return;
+		same = a;
+	}
+	if (same < 0) return;
+	rep[i->dst] = same;
+	removeInstr(i);
+	redundant++;
+}
+
+static void numberBlock(IrBlock b) {
+	int mark = logTop;
+	IrInstr i, next;
+	int k;
+
+	memEpoch++;
+	for (i = b->first; i != NULL; i = next) {
+		next = i->next;
+		if (i->op == IrPhi) numberPhi(i);
+		else numberInstr(i);
+	}
+	for (k = 0; k < b->nsucc; ++k) {
+		IrBlock s = b->succ[k];
+		int p = predIndex(s, b);
+
+		for (i = s->first; i != NULL && i->op == IrPhi; i = i->next)
+			i->args[p] = find(i->args[p]);
+	}
+	for (k = 0; k < b->nkids; ++k) numberBlock(b->kids[k]);
+	leaveValues(mark);
+}
+
+int valueNumber(IrFunc f, int *copies) {
+	int v;
+
+	rep = (int *)malloc(f->nregs * sizeof(int));
+	isConst = (char *)calloc(f->nregs, 1);
+	constVal = (int *)malloc(f->nregs * sizeof(int));
+	for (v = 0; v < f->nregs; ++v) rep[v] = v;
+	redundant = propagated = 0;
+
+	numberBlock(f->entry);
+
+	free(rep);
+	free(isConst);
+	free(constVal);
+	*copies = propagated;
+	return redundant;
+}
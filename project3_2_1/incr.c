@@ -0,0 +1,392 @@
+/* FILE: incr.c */
+/* Incremental reanalysis for editors: the source is kept as */
+/* its top-level declarations, the sibling list built by */
+/* declaration_list, and after an edit only the declarations */
+/* whose text changed are parsed and checked again */
+
+#include <unistd.h>
+#include <time.h>
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "parse.h"
+#include "analyze.h"
+#include "incr.h"
+
+#define LINESIZE 4096
+
+typedef struct {
+	char *text;		/* from the end of the declaration before */
+	int line;		/* the line text starts on */
+	int declLine;		/* the line of its first token */
+	unsigned long long hash;	/* of text */
+	TreeNode *tree;		/* NULL after a syntax error */
+	int order;		/* position in the list of trees */
+	int dirty;		/* to be checked */
+	char *diagnostics;	/* of its last parse or check */
+} Decl;
+
+static Decl *decls = NULL;
+static int ndecls = 0;
+
+/* the global scope is retained while the global declarations
+ * keep their kinds, names, types and sizes
+ */
+static unsigned long long globalsHash;
+static int globalsOk = FALSE;
+static char *globalsDiagnostics = NULL;
+
+/* the diagnostics, printed to stdout by the analyzer, are
+ * captured in a temporary file
+ */
+static int diagFd = -1, savedStdout = -1;
+
+/* 64-bit FNV-1a */
+static unsigned long long fnv(unsigned long long h, const char *s, size_t n) {
+	while (n-- > 0) {
+		h ^= (unsigned char)*s++;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+static long microseconds(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+static void beginCapture(void) {
+	if (diagFd < 0) {
+		FILE *diag = tmpfile();
+
+		if (diag == NULL) return;
+		diagFd = fileno(diag);
+		savedStdout = dup(1);
+	}
+	fflush(stdout);
+	if (ftruncate(diagFd, 0) != 0) return;
+	lseek(diagFd, 0, SEEK_SET);
+	dup2(diagFd, 1);
+}
+
+/* Function endCapture returns what was printed since
+ * beginCapture
+ */
+static char *endCapture(void) {
+	off_t n;
+	char *s;
+
+	fflush(stdout);
+	if (diagFd < 0) return copyString("");
+	dup2(savedStdout, 1);
+	n = lseek(diagFd, 0, SEEK_END);
+	s = (char *)malloc(n + 1);
+	if (pread(diagFd, s, n, 0) != n) n = 0;
+	s[n] = '\0';
+	return s;
+}
+
+char *readFile(char *name) {
+	FILE *f = fopen(name, "rb");
+	char *text;
+	long n;
+
+	if (f == NULL) return NULL;
+	fseek(f, 0, SEEK_END);
+	n = ftell(f);
+	rewind(f);
+	text = (char *)malloc(n + 1);
+	n = fread(text, 1, n, f);
+	text[n] = '\0';
+	fclose(f);
+	return text;
+}
+
+static void addDecl(Decl **d, int *n, int *cap, char *start, char *end, int line, int declLine) {
+	Decl *x;
+
+	if (*n == *cap) {
+		*cap = *cap > 0 ? 2 * *cap : 64;
+		*d = (Decl *)realloc(*d, *cap * sizeof(Decl));
+	}
+	x = &(*d)[(*n)++];
+	memset(x, 0, sizeof(Decl));
+	x->text = (char *)malloc(end - start + 1);
+	memcpy(x->text, start, end - start);
+	x->text[end - start] = '\0';
+	x->line = line;
+	x->declLine = declLine;
+	x->hash = fnv(14695981039346656037ULL, start, end - start);
+}
+
+/* Function split divides text into its top-level declarations:
+ * each one ends with a semicolon or a closing brace outside
+ * of braces, and text after the last one is a declaration
+ * only if it holds more than comments
+ */
+static Decl *split(char *text, int *n) {
+	Decl *d = NULL;
+	char *p = text, *start = text;
+	int cap = 0, depth = 0, line = 1, startLine = 1, declLine = 0, end;
+
+	*n = 0;
+	while (*p != '\0') {
+		if (p[0] == '/' && p[1] == '*') {
+			for (p += 2; *p != '\0' && !(p[0] == '*' && p[1] == '/'); ++p)
+				if (*p == '\n') line++;
+			if (*p != '\0') p += 2;
+			continue;
+		}
+		end = FALSE;
+		if (*p == '\n') line++;
+		else if (!isspace((unsigned char)*p) && declLine == 0) declLine = line;
+		if (*p == '{') depth++;
+		else if (*p == '}') end = --depth <= 0;
+		else if (*p == ';') end = depth <= 0;
+		p++;
+		if (end) {
+			addDecl(&d, n, &cap, start, p, startLine, declLine);
+			start = p;
+			startLine = line;
+			declLine = 0;
+			depth = 0;
+		}
+	}
+	if (declLine != 0) addDecl(&d, n, &cap, start, p, startLine, declLine);
+	return d;
+}
+
+static void shiftLines(TreeNode *t, int delta) {
+	int k;
+
+	for (; t != NULL; t = t->sibling) {
+		t->lineno += delta;
+		for (k = 0; k < MAXCHILDREN; ++k) shiftLines(t->child[k], delta);
+	}
+}
+
+static int sameText(Decl *a, Decl *b) {
+	return a->hash == b->hash && !strcmp(a->text, b->text);
+}
+
+/* Procedure reuse moves the tree and diagnostics of an
+ * unchanged declaration to its new place; diagnostics name
+ * lines, so a moved declaration that has some is checked
+ * again
+ */
+static int reuse(Decl *d, Decl *old) {
+	int delta = d->line - old->line;
+
+	d->tree = old->tree;
+	d->diagnostics = old->diagnostics;
+	old->tree = NULL;
+	old->diagnostics = NULL;
+	if (delta == 0) return TRUE;
+	if (d->tree == NULL) return FALSE;
+	shiftLines(d->tree, delta);
+	if (d->diagnostics[0] != '\0') d->dirty = TRUE;
+	return TRUE;
+}
+
+static void parseDecl(Decl *d) {
+	free(d->diagnostics);
+	beginCapture();
+	scanText(d->text, d->line);
+	Error = FALSE;
+	d->tree = parse();
+	if (Error) d->tree = NULL;
+	d->diagnostics = endCapture();
+	d->dirty = d->tree != NULL;
+}
+
+/* Function globalsSignature hashes what the global scope is
+ * built from, the parameters of the functions and whether they
+ * have a body included, which a definition of a function
+ * declared before must agree with
+ */
+static unsigned long long globalsSignature(void) {
+	unsigned long long h = 14695981039346656037ULL;
+	char s[LINESIZE];
+	int k;
+
+	for (k = 0; k < ndecls; ++k) {
+		TreeNode *t = decls[k].tree;
+
+		if (t == NULL || t->nodekind != DeclK) snprintf(s, sizeof(s), "?;");
+		else snprintf(s, sizeof(s), "%d %s %d %d;", t->kind.decl, t->child[1]->attr.name,
+			t->child[0]->type, t->kind.decl == VarArrK ? t->child[4]->attr.val : 0);
+		h = fnv(h, s, strlen(s));
+		if (t != NULL && t->nodekind == DeclK && t->kind.decl == FuncK) {
+			TreeNode *p;
+
+			for (p = t->child[2]; p != NULL; p = p->sibling) {
+				snprintf(s, sizeof(s), "(%d %d", p->kind.decl, p->child[0] != NULL ? (int)p->child[0]->type : -1);
+				h = fnv(h, s, strlen(s));
+			}
+			h = fnv(h, t->child[3] != NULL ? "){" : ");", 2);
+		}
+	}
+	return h;
+}
+
+int incrUpdate(char *text, int *parsed, int *checked) {
+	Decl *old = decls;
+	int nold = ndecls, n, k, order, prefix, suffix, errors = 0;
+	unsigned long long signature;
+	TreeNode *list = NULL, *last = NULL;
+
+	*parsed = *checked = 0;
+	for (k = 0; k < nold; ++k)
+		if (old[k].tree != NULL) old[k].tree->sibling = NULL;
+	decls = split(text, &ndecls);
+	n = ndecls;
+
+	/* an edit leaves the declarations before and after it */
+	for (prefix = 0; prefix < n && prefix < nold && sameText(&decls[prefix], &old[prefix]); ++prefix)
+		if (!reuse(&decls[prefix], &old[prefix])) break;
+	for (suffix = 0; suffix < n - prefix && suffix < nold - prefix &&
+			sameText(&decls[n - 1 - suffix], &old[nold - 1 - suffix]); ++suffix)
+		if (!reuse(&decls[n - 1 - suffix], &old[nold - 1 - suffix])) break;
+	for (k = prefix; k < n - suffix; ++k) {
+		parseDecl(&decls[k]);
+		(*parsed)++;
+	}
+	for (k = 0; k < nold; ++k) {
+		freeTree(old[k].tree);
+		free(old[k].text);
+		free(old[k].diagnostics);
+	}
+	free(old);
+
+	for (k = 0, order = 0; k < n; ++k) {
+		if (decls[k].tree == NULL) continue;
+		decls[k].order = ++order;
+		if (last == NULL) list = decls[k].tree;
+		else last->sibling = decls[k].tree;
+		last = decls[k].tree;
+	}
+
+	signature = globalsSignature();
+	if (!globalsOk || signature != globalsHash) {
+		free(globalsDiagnostics);
+		beginCapture();
+		globalsOk = declareGlobals(list);
+		globalsDiagnostics = endCapture();
+		globalsHash = signature;
+		for (k = 0; k < n; ++k) decls[k].dirty = decls[k].tree != NULL;
+	}
+	if (globalsOk)
+		for (k = 0; k < n; ++k) {
+			if (!decls[k].dirty) continue;
+			free(decls[k].diagnostics);
+			beginCapture();
+			checkDeclaration(decls[k].tree, decls[k].order);
+			decls[k].diagnostics = endCapture();
+			decls[k].dirty = FALSE;
+			(*checked)++;
+		}
+
+	if (globalsDiagnostics[0] != '\0') errors++;
+	for (k = 0; k < n; ++k)
+		if (decls[k].diagnostics[0] != '\0' && (globalsOk || decls[k].tree == NULL)) errors++;
+	return errors;
+}
+
+void incrReset(void) {
+	int k;
+
+	for (k = 0; k < ndecls; ++k)
+		if (decls[k].tree != NULL) decls[k].tree->sibling = NULL;
+	for (k = 0; k < ndecls; ++k) {
+		freeTree(decls[k].tree);
+		free(decls[k].text);
+		free(decls[k].diagnostics);
+	}
+	free(decls);
+	decls = NULL;
+	ndecls = 0;
+	globalsOk = FALSE;
+}
+
+int incrDeclarations(void) {
+	return ndecls;
+}
+
+/* Procedure reportLines calls report with every line of text */
+static void reportLines(int line, char *text, void (*report)(int, char *)) {
+	char message[LINESIZE];
+	char *p = text, *nl;
+	int len;
+
+	while (*p != '\0') {
+		nl = strchr(p, '\n');
+		if (nl == NULL) nl = p + strlen(p);
+		len = nl - p < LINESIZE ? nl - p : LINESIZE - 1;
+		memcpy(message, p, len);
+		message[len] = '\0';
+		report(line, message);
+		p = *nl != '\0' ? nl + 1 : nl;
+	}
+}
+
+void incrDiagnostics(void (*report)(int line, char *message)) {
+	int k;
+
+	if (globalsDiagnostics != NULL) reportLines(0, globalsDiagnostics, report);
+	for (k = 0; k < ndecls; ++k)
+		if (globalsOk || decls[k].tree == NULL) reportLines(decls[k].declLine, decls[k].diagnostics, report);
+}
+
+void incrSymbols(void (*report)(TreeNode *decl)) {
+	int k;
+
+	for (k = 0; k < ndecls; ++k)
+		if (decls[k].tree != NULL && decls[k].tree->nodekind == DeclK) report(decls[k].tree);
+}
+
+/* the source file named by the diagnostics */
+static char *sourceName;
+
+static void printDiagnostic(int line, char *message) {
+	if (line > 0) printf("%s:%d: %s\n", sourceName, line, message);
+	else printf("%s: %s\n", sourceName, message);
+}
+
+/* Function check brings the declarations up to the text of
+ * file, prints the diagnostics and returns the number of
+ * declarations with errors
+ */
+static int check(char *file) {
+	long start = microseconds();
+	char *text = readFile(file);
+	int errors, parsed, checked;
+
+	if (text == NULL) {
+		printf("%s: cannot read %s\nDONE 1 errors\n", sourceName, file);
+		fflush(stdout);
+		return 1;
+	}
+	errors = incrUpdate(text, &parsed, &checked);
+	free(text);
+	incrDiagnostics(printDiagnostic);
+	printf("DONE %d errors, %d of %d declarations parsed, %d checked, %ld us\n",
+		errors, parsed, ndecls, checked, microseconds() - start);
+	fflush(stdout);
+	return errors;
+}
+
+int incremental(char *pgm) {
+	char request[LINESIZE];
+	int errors;
+
+	sourceName = pgm;
+	EchoSource = TraceScan = TraceParse = TraceAnalyze = TraceOptimize = FALSE;
+	errors = check(pgm);
+	while (fgets(request, sizeof(request), stdin) != NULL) {
+		request[strcspn(request, "\r\n")] = '\0';
+		errors = check(request[0] != '\0' ? request : pgm);
+	}
+	return errors > 0;
+}
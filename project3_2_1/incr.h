@@ -0,0 +1,48 @@
+/* FILE: incr.h */
+/* Incremental reanalysis of the C-Minus compiler for editors */
+
+#ifndef _INCR_H_
+#define _INCR_H_
+
+/* Function incremental checks the source file pgm, then reads
+ * one request per line from stdin and checks again: the name
+ * of the file holding the new text of the source, or an empty
+ * line for pgm itself.  Only the top-level declarations whose
+ * text changed are parsed again, and only they are checked
+ * unless the global declarations changed.  Each answer is the
+ * diagnostics as file:line: message lines and a DONE line;
+ * it returns the exit status at the end of stdin
+ */
+int incremental(char *pgm);
+
+/* Function incrUpdate brings the kept declarations up to the
+ * source text, sets the numbers parsed and checked again and
+ * returns the number of declarations with errors
+ */
+int incrUpdate(char *text, int *parsed, int *checked);
+
+/* Procedure incrReset drops the kept declarations */
+void incrReset(void);
+
+/* Function incrDeclarations returns the number of kept
+ * top-level declarations
+ */
+int incrDeclarations(void);
+
+/* Procedure incrDiagnostics calls report with every line of
+ * the diagnostics and the line of the declaration it is
+ * about, 0 for the global declarations as a whole
+ */
+void incrDiagnostics(void (*report)(int line, char *message));
+
+/* Procedure incrSymbols calls report with every top-level
+ * declaration that parsed
+ */
+void incrSymbols(void (*report)(TreeNode *decl));
+
+/* Function readFile returns the contents of file name, NULL
+ * if it cannot be read
+ */
+char *readFile(char *name);
+
+#endif
@@ -0,0 +1,162 @@
+/* FILE: inline.c */
+/* Inlining of small leaf functions into their callers */
+
+#include "globals.h"
+#include "ir.h"
+#include "opt.h"
+#include "pgo.h"
+
+/* Function isLeaf returns TRUE if f calls no function other
+ * than the input and output built-ins, so it cannot recurse
+ */
+static int isLeaf(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->op == IrTailCall ||
+					(i->op == IrCall && strcmp(i->name, "input") && strcmp(i->name, "output")))
+				return FALSE;
+	return TRUE;
+}
+
+static int usesFrame(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->op == IrLAddr) return TRUE;
+	return FALSE;
+}
+
+static IrInstr cloneInstr(IrInstr i, int base, int frame) {
+	IrInstr c = newInstr(i->op, i->dst, i->src[0], i->src[1]);
+	int k;
+
+	if (c->dst >= 0) c->dst += base;
+	for (k = 0; k < 2; ++k)
+		if (c->src[k] >= 0) c->src[k] += base;
+	c->imm = i->op == IrLAddr ? i->imm - frame : i->imm;
+	c->nargs = i->nargs;
+	if (i->nargs > 0) {
+		c->args = (int *)malloc(i->nargs * sizeof(int));
+		for (k = 0; k < i->nargs; ++k) c->args[k] = i->args[k] + base;
+	}
+	c->name = i->name;
+	c->sym = i->sym;
+	c->lineno = i->lineno;
+	return c;
+}
+
+/* Procedure inlineCall replaces the call by a copy of the body
+ * of the callee: the block holding the call is split after it,
+ * the arguments are copied into the renumbered parameters and
+ * every return becomes a copy of the result and a jump to the
+ * rest of the split block
+ */
+static void inlineCall(IrFunc caller, IrInstr call, IrFunc callee) {
+	IrBlock b = call->block;
+	IrBlock cont = newBlock(caller);
+	IrBlock *copy = (IrBlock *)malloc(callee->nblocks * sizeof(IrBlock));
+	IrBlock cb, last;
+	IrInstr i, next;
+	int base = caller->nregs;
+	int frame = 0;
+	int k, j;
+
+	caller->nregs += callee->nregs;
+	if (usesFrame(callee)) {
+		/* the callee's local arrays go below the caller's frame */
+		frame = caller->frameSize;
+		caller->frameSize += callee->frameSize;
+	}
+
+	/* split the block after the call */
+	for (i = call->next; i != NULL; i = next) {
+		next = i->next;
+		removeInstr(i);
+		appendInstr(cont, i);
+	}
+	for (k = 0; k < b->nsucc; ++k) {
+		IrBlock s = b->succ[k];
+		cont->succ[cont->nsucc++] = s;
+		for (j = 0; j < s->npred; ++j)
+			if (s->pred[j] == b) s->pred[j] = cont;
+	}
+	b->nsucc = 0;
+
+	for (cb = callee->entry; cb != NULL; cb = cb->next) {
+		copy[cb->id] = newBlock(caller);
+		copy[cb->id]->cold = cb->cold;
+	}
+	for (k = 0; k < call->nargs; ++k) {
+		i = newInstr(IrCopy, callee->params[k] + base, call->args[k], -1);
+		i->lineno = call->lineno;
+		insertBefore(call, i);
+	}
+	removeInstr(call);
+	i = newInstr(IrJump, -1, -1, -1);
+	i->lineno = call->lineno;
+	appendInstr(b, i);
+	addEdge(b, copy[callee->entry->id]);
+
+	last = b;
+	cont->next = b->next;
+	for (cb = callee->entry; cb != NULL; cb = cb->next) {
+		IrBlock nb = copy[cb->id];
+
+		for (i = cb->first; i != NULL; i = i->next) {
+			if (i->op != IrRet) {
+				appendInstr(nb, cloneInstr(i, base, frame));
+				continue;
+			}
+			if (call->dst >= 0 && i->src[0] >= 0) {
+				IrInstr c = newInstr(IrCopy, call->dst, i->src[0] + base, -1);
+				c->lineno = i->lineno;
+				appendInstr(nb, c);
+			}
+			appendInstr(nb, newInstr(IrJump, -1, -1, -1));
+			addEdge(nb, cont);
+		}
+		for (k = 0; k < cb->nsucc; ++k) addEdge(nb, copy[cb->succ[k]->id]);
+		last->next = nb;
+		last = nb;
+	}
+	last->next = cont;
+
+	free(copy);
+	if (call->args != NULL) free(call->args);
+	free(call);
+}
+
+int inlineCalls(IrProgram prog, int limit) {
+	IrFunc f, callee;
+	IrBlock b;
+	IrInstr i, next;
+	int size, inlined = 0;
+
+	if (limit <= 0) return 0;
+	/* callees are declared before their callers, so by the time
+	 * a function is reached its own calls have been inlined
+	 */
+	for (f = prog->funcs; f != NULL; f = f->next)
+		for (b = f->entry; b != NULL; b = b->next)
+			for (i = b->first; i != NULL; i = next) {
+				next = i->next;
+				if (i->op != IrCall) continue;
+				for (callee = prog->funcs; callee != NULL && callee->sym != i->sym; callee = callee->next);
+				if (callee == NULL || callee == f || !isLeaf(callee)) continue;
+				size = countInstrs(callee);
+				if (size > (ProfileUse ? inlineLimit(callee->name, limit) : limit)) continue;
+				if (TraceOptimize)
+					fprintf(listing, "INLINE %-10s into %-10s at line %4d (%d instructions)\n",
+						callee->name, f->name, i->lineno, size);
+				inlineCall(f, i, callee);
+				inlined++;
+				/* the rest of the block moved to a new block */
+				next = NULL;
+			}
+	return inlined;
+}
@@ -0,0 +1,853 @@
+/* FILE: ir.c */
+/* Lowering of the C-Minus syntax tree to IR */
+
+#include "globals.h"
+#include "symtab.h"
+#include "analyze.h"
+#include "ir.h"
+#include "pgo.h"
+
+/* the function and block currently being generated,
+ * and the last block in layout order
+ */
+static IrFunc curFunc;
+static IrBlock curBlock;
+static IrBlock lastBlock;
+
+/* VarMap binds the symbol of every scalar local and
+ * parameter of the current function to its register
+ */
+#define VARMAP_SIZE 1024
+
+typedef struct VarMapRec {
+	BucketList sym;
+	int reg;
+	struct VarMapRec *next;
+} * VarMap;
+
+static VarMap varMap[VARMAP_SIZE];
+
+static int symHash(BucketList sym) {
+	return (int)(((unsigned long)sym >> 4) % VARMAP_SIZE);
+}
+
+static void bindVar(BucketList sym, int reg) {
+	VarMap v = (VarMap)malloc(sizeof(struct VarMapRec));
+	int h = symHash(sym);
+
+	v->sym = sym;
+	v->reg = reg;
+	v->next = varMap[h];
+	varMap[h] = v;
+}
+
+static int lookupVar(BucketList sym) {
+	VarMap v = varMap[symHash(sym)];
+
+	while (v != NULL && v->sym != sym) v = v->next;
+	return v == NULL ? -1 : v->reg;
+}
+
+static void clearVars(void) {
+	int i;
+
+	for (i = 0; i < VARMAP_SIZE; ++i) {
+		while (varMap[i] != NULL) {
+			VarMap v = varMap[i];
+			varMap[i] = v->next;
+			free(v);
+		}
+	}
+}
+
+static void *irAlloc(size_t size) {
+	void *p = calloc(1, size);
+
+	if (p == NULL) {
+		fprintf(listing, "Out of memory error at line %d\n", lineno);
+		exit(1);
+	}
+	return p;
+}
+
+/* construction helpers */
+
+IrBlock newBlock(IrFunc f) {
+	IrBlock b = (IrBlock)irAlloc(sizeof(struct IrBlockRec));
+
+	b->id = f->nblocks++;
+	b->rpo = -1;
+	return b;
+}
+
+int newReg(IrFunc f) {
+	return f->nregs++;
+}
+
+IrInstr newInstr(IrOp op, int dst, int src0, int src1) {
+	IrInstr i = (IrInstr)irAlloc(sizeof(struct IrInstrRec));
+
+	i->op = op;
+	i->dst = dst;
+	i->src[0] = src0;
+	i->src[1] = src1;
+	return i;
+}
+
+void appendInstr(IrBlock b, IrInstr i) {
+	i->block = b;
+	i->prev = b->last;
+	i->next = NULL;
+	if (b->last == NULL) b->first = i;
+	else b->last->next = i;
+	b->last = i;
+}
+
+void insertBefore(IrInstr pos, IrInstr i) {
+	i->block = pos->block;
+	i->next = pos;
+	i->prev = pos->prev;
+	if (pos->prev == NULL) pos->block->first = i;
+	else pos->prev->next = i;
+	pos->prev = i;
+}
+
+void removeInstr(IrInstr i) {
+	IrBlock b = i->block;
+
+	if (i->prev == NULL) b->first = i->next;
+	else i->prev->next = i->next;
+	if (i->next == NULL) b->last = i->prev;
+	else i->next->prev = i->prev;
+	i->prev = i->next = NULL;
+	i->block = NULL;
+}
+
+void addEdge(IrBlock from, IrBlock to) {
+	from->succ[from->nsucc++] = to;
+	if (to->npred == to->predCap) {
+		to->predCap = to->predCap == 0 ? 2 : to->predCap * 2;
+		to->pred = (IrBlock *)realloc(to->pred, to->predCap * sizeof(IrBlock));
+	}
+	to->pred[to->npred++] = from;
+}
+
+int predIndex(IrBlock b, IrBlock pred) {
+	int i;
+
+	for (i = 0; i < b->npred; ++i)
+		if (b->pred[i] == pred) return i;
+	return -1;
+}
+
+/* Procedure removePred drops the edge pred -> b,
+ * removing the matching operand of every phi in b
+ */
+void removePred(IrBlock b, IrBlock pred) {
+	int k = predIndex(b, pred);
+	int j;
+	IrInstr i;
+
+	if (k < 0) return;
+	for (j = k; j + 1 < b->npred; ++j) b->pred[j] = b->pred[j + 1];
+	b->npred--;
+	for (i = b->first; i != NULL && i->op == IrPhi; i = i->next) {
+		for (j = k; j + 1 < i->nargs; ++j) i->args[j] = i->args[j + 1];
+		i->nargs--;
+	}
+}
+
+int countInstrs(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	int n = 0;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) n++;
+	return n;
+}
+
+int isPure(IrOp op) {
+	switch (op) {
+		case IrConst:
+		case IrCopy:
+		case IrAdd: case IrSub: case IrMul: case IrDiv:
+		case IrLt: case IrLe: case IrGt: case IrGe: case IrEq: case IrNe:
+		case IrGAddr:
+		case IrLAddr:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+/* emit appends an instruction to the current block */
+
+static IrInstr emit(IrOp op, int dst, int src0, int src1, int lineno) {
+	IrInstr i = newInstr(op, dst, src0, src1);
+
+	i->lineno = lineno;
+	appendInstr(curBlock, i);
+	return i;
+}
+
+/* the counters of -profile, added to the program */
+static IrProgram curProgram;
+static IrCounter lastCounter;
+
+/* Procedure count adds the next counter, of kind for the
+ * current function at line, and increments it in the
+ * current block
+ */
+static void count(CountKind kind, int line, int ordinal) {
+	IrCounter c = (IrCounter)irAlloc(sizeof(struct IrCounterRec));
+	IrInstr a, k;
+	int v, sum;
+
+	c->kind = kind;
+	c->name = curFunc->name;
+	c->line = line;
+	c->ordinal = ordinal;
+	c->word = globalDataSize() + curProgram->ncounters++;
+	if (lastCounter == NULL) curProgram->counters = c;
+	else lastCounter->next = c;
+	lastCounter = c;
+
+	a = emit(IrGAddr, newReg(curFunc), -1, -1, line);
+	a->imm = c->word;
+	v = newReg(curFunc);
+	emit(IrLoad, v, a->dst, -1, line);
+	k = emit(IrConst, newReg(curFunc), -1, -1, line);
+	k->imm = 1;
+	sum = newReg(curFunc);
+	emit(IrAdd, sum, v, k->dst, line);
+	emit(IrStore, -1, a->dst, sum, line);
+}
+
+/* the loops and ifs numbered so far with a condition on each
+ * line, while numberConditions runs
+ */
+static int *lineCount = NULL;
+static int lineCountSize = 0;
+
+/* Procedure numberConditions sets attr.val, otherwise unused
+ * in a statement, of each loop and if of t and its siblings
+ * to its ordinal, from 1, among those with a condition on the
+ * same line, in the order of the conditions; with clear set it
+ * forgets the lines instead.  A loop copied by unrollLoop keeps
+ * the ordinal of the loop as written
+ */
+static void numberConditions(TreeNode *t, int clear) {
+	int line, k;
+
+	for (; t != NULL; t = t->sibling) {
+		if (t->nodekind != StmtK) continue;
+		if (t->kind.stmt == SelectionStmtK || t->kind.stmt == IterationStmtK) {
+			line = t->child[3]->lineno;
+			if (line >= lineCountSize) {
+				int size = 2 * line + 64;
+
+				lineCount = (int *)realloc(lineCount, size * sizeof(int));
+				memset(lineCount + lineCountSize, 0, (size - lineCountSize) * sizeof(int));
+				lineCountSize = size;
+			}
+			if (clear) lineCount[line] = 0;
+			else t->attr.val = ++lineCount[line];
+		}
+		for (k = 0; k < MAXCHILDREN; ++k) numberConditions(t->child[k], clear);
+	}
+}
+
+/* markCold marks the blocks laid out from b up to end */
+static void markCold(IrBlock b, IrBlock end) {
+	for (; b != end; b = b->next) b->cold = TRUE;
+}
+
+/* startBlock makes b the current block, falling
+ * through from the current one if it is unterminated
+ */
+static void startBlock(IrBlock b) {
+	IrInstr last = curBlock->last;
+
+	if (last == NULL || (last->op != IrJump && last->op != IrBranch && last->op != IrRet)) {
+		emit(IrJump, -1, -1, -1, 0);
+		addEdge(curBlock, b);
+	}
+	lastBlock->next = b;
+	lastBlock = b;
+	curBlock = b;
+}
+
+static int isArraySym(BucketList sym) {
+	return !strcmp(sym->type, "array");
+}
+
+/* Function globalBase returns the first word of a
+ * global object: analyze.c hands out byte locations
+ * at the end of each object
+ */
+static int globalBase(BucketList sym) {
+	return sym->memloc / 4 - (isArraySym(sym) ? sym->arraySize : 1);
+}
+
+static int genExp(TreeNode *t);
+
+/* Function genBase returns a register holding the base address of an array */
+
+static int genBase(TreeNode *id) {
+	BucketList sym = id->bucket;
+	int r = newReg(curFunc);
+	IrInstr i;
+
+	if (!strcmp(sym->VPF, "Par")) {
+		emit(IrCopy, r, lookupVar(sym), -1, id->lineno);
+		return r;
+	}
+	if (lookupVar(sym) == -2) {
+		i = emit(IrLAddr, r, -1, -1, id->lineno);
+		i->imm = sym->memloc / 4;
+	}
+	else {
+		i = emit(IrGAddr, r, -1, -1, id->lineno);
+		i->imm = globalBase(sym);
+	}
+	i->name = sym->name;
+	i->sym = sym;
+	return r;
+}
+
+/* Function genAddr returns a register holding the address of
+ * a memory variable: an array element or a global scalar
+ */
+static int genAddr(TreeNode *t) {
+	int r;
+
+	if (t->kind.exp == ArrK) {
+		BucketList sym = t->child[5]->bucket;
+		int base = genBase(t->child[5]);
+		int index = genExp(t->child[1]);
+
+		/* the size of an array parameter is not known */
+		if (BoundsCheck && strcmp(sym->VPF, "Par")) {
+			IrInstr i = emit(IrCheck, -1, index, -1, t->lineno);
+			i->imm = sym->arraySize;
+			i->name = sym->name;
+		}
+		r = newReg(curFunc);
+		emit(IrAdd, r, base, index, t->lineno);
+	}
+	else {
+		IrInstr i;
+
+		r = newReg(curFunc);
+		i = emit(IrGAddr, r, -1, -1, t->lineno);
+		i->imm = globalBase(t->bucket);
+		i->name = t->bucket->name;
+		i->sym = t->bucket;
+	}
+	return r;
+}
+
+static IrOp binaryOp(TokenType op) {
+	switch (op) {
+		case PLUS: return IrAdd;
+		case MINUS: return IrSub;
+		case TIMES: return IrMul;
+		case OVER: return IrDiv;
+		case LT: return IrLt;
+		case LE: return IrLe;
+		case GT: return IrGt;
+		case GE: return IrGe;
+		case EQ: return IrEq;
+		default: return IrNe;
+	}
+}
+
+/* Function genExp generates code for an expression and returns its register */
+
+static int genExp(TreeNode *t) {
+	int r = -1;
+
+	switch (t->kind.exp) {
+		case ConstK:
+			{
+				IrInstr i;
+				r = newReg(curFunc);
+				i = emit(IrConst, r, -1, -1, t->lineno);
+				i->imm = t->attr.val;
+			}
+			break;
+		case IdK:
+			{
+				BucketList sym = t->bucket;
+				int v = lookupVar(sym);
+
+				if (isArraySym(sym)) r = genBase(t);
+				else if (v >= 0) {
+					r = newReg(curFunc);
+					emit(IrCopy, r, v, -1, t->lineno);
+				}
+				else {
+					int a = genAddr(t);
+					r = newReg(curFunc);
+					emit(IrLoad, r, a, -1, t->lineno);
+				}
+			}
+			break;
+		case ArrK:
+			{
+				int a = genAddr(t);
+				r = newReg(curFunc);
+				emit(IrLoad, r, a, -1, t->lineno);
+			}
+			break;
+		case LvarK:
+			{
+				TreeNode *var = t->child[0];
+				int v;
+
+				r = genExp(t->child[1]);
+				if (var->kind.exp == IdK && (v = lookupVar(var->bucket)) >= 0)
+					emit(IrCopy, v, r, -1, t->lineno);
+				else
+					emit(IrStore, -1, genAddr(var), r, t->lineno);
+			}
+			break;
+		case ComparisionExpK:
+		case AdditiveExpK:
+		case MultiplicativeExpK:
+			{
+				TreeNode *op = t->child[3];
+				int left = genExp(op->child[2]);
+				int right = genExp(op->child[4]);
+
+				r = newReg(curFunc);
+				emit(binaryOp(op->type), r, left, right, t->lineno);
+			}
+			break;
+		case CallK:
+			{
+				TreeNode *arg;
+				IrInstr i;
+				int n = 0;
+
+				for (arg = t->child[6]; arg != NULL; arg = arg->sibling) n++;
+				i = newInstr(IrCall, -1, -1, -1);
+				i->nargs = n;
+				i->args = (int *)irAlloc((n + 1) * sizeof(int));
+				n = 0;
+				for (arg = t->child[6]; arg != NULL; arg = arg->sibling)
+					i->args[n++] = genExp(arg);
+				r = newReg(curFunc);
+				i->dst = r;
+				i->name = t->child[5]->attr.name;
+				i->sym = t->child[5]->bucket;
+				i->lineno = t->lineno;
+				appendInstr(curBlock, i);
+			}
+			break;
+		default:
+			break;
+	}
+	return r;
+}
+
+static void genLocals(TreeNode *t) {
+	for (; t != NULL; t = t->sibling) {
+		BucketList sym = t->child[1]->bucket;
+
+		/* the body of an unrolled loop is generated more than once */
+		if (lookupVar(sym) != -1) continue;
+		if (t->kind.decl == VarK) bindVar(sym, newReg(curFunc));
+		else bindVar(sym, -2);
+		if (-sym->memloc / 4 > curFunc->frameSize) curFunc->frameSize = -sym->memloc / 4;
+	}
+}
+
+/* the most tree nodes the copies of an unrolled body may take */
+#define UNROLL_BUDGET 160
+
+static int isScalarLocal(TreeNode *t) {
+	return t->nodekind == ExpK && t->kind.exp == IdK && !isArraySym(t->bucket) && lookupVar(t->bucket) >= 0;
+}
+
+static int isOne(TreeNode *t) {
+	return t->nodekind == ExpK && t->kind.exp == ConstK && t->attr.val == 1;
+}
+
+/* Function countedStep returns the assignment iv = iv + 1
+ * that ends the statements of body, or NULL
+ */
+static TreeNode *countedStep(TreeNode *body, BucketList iv) {
+	TreeNode *s = body, *e, *op;
+
+	if (s->nodekind == StmtK && s->kind.stmt == CompoundStmtK) s = s->child[1];
+	if (s == NULL) return NULL;
+	while (s->sibling != NULL) s = s->sibling;
+	if (s->nodekind != StmtK || s->kind.stmt != ExpressionStmtK || (e = s->child[2]) == NULL) return NULL;
+	if (e->kind.exp != LvarK || e->child[0]->kind.exp != IdK || e->child[0]->bucket != iv) return NULL;
+	if (e->child[1]->kind.exp != AdditiveExpK || binaryOp((op = e->child[1]->child[3])->type) != IrAdd) return NULL;
+	if (isScalarLocal(op->child[2]) && op->child[2]->bucket == iv && isOne(op->child[4])) return e;
+	if (isScalarLocal(op->child[4]) && op->child[4]->bucket == iv && isOne(op->child[2])) return e;
+	return NULL;
+}
+
+/* Function bodySize returns the number of nodes of t and its
+ * siblings, or more than UNROLL_BUDGET when they hold a loop or
+ * an assignment to iv or bound other than step; it stops
+ * counting past limit
+ */
+static int bodySize(TreeNode *t, BucketList iv, BucketList bound, TreeNode *step, int limit) {
+	int n = 0, k;
+
+	for (; t != NULL && n <= limit; t = t->sibling) {
+		if (t->nodekind == StmtK && t->kind.stmt == IterationStmtK) return UNROLL_BUDGET + 1;
+		if (t != step && t->nodekind == ExpK && t->kind.exp == LvarK && t->child[0]->kind.exp == IdK &&
+				(t->child[0]->bucket == iv || t->child[0]->bucket == bound))
+			return UNROLL_BUDGET + 1;
+		n++;
+		for (k = 0; k < MAXCHILDREN; ++k)
+			if (t->child[k] != NULL) n += bodySize(t->child[k], iv, bound, step, limit - n);
+	}
+	return n;
+}
+
+static void genStmt(TreeNode *t);
+
+/* Procedure unrollLoop emits a counted loop t, while (i < n)
+ * or while (i <= n) over a scalar local i whose body ends with
+ * i = i + 1 and does not assign i or n otherwise, n being a
+ * constant or a scalar local: the loop runs UnrollFactor copies
+ * of its body per test while that many iterations remain, and
+ * falls through to t itself, generated next, for the rest.
+ * Loops that hold loops or are too large are left alone, as
+ * are those bounded by a constant below 2 * UnrollFactor and
+ * those a profile saw run fewer times than UnrollFactor
+ */
+static void unrollLoop(TreeNode *t) {
+	TreeNode *cond = t->child[3], *op, *bound, *step;
+	IrBlock header, body, exit;
+	IrInstr i;
+	IrOp test;
+	int lim, n, c, k;
+	long runs;
+
+	if (cond->kind.exp != ComparisionExpK) return;
+	op = cond->child[3];
+	bound = op->child[4];
+	test = binaryOp(op->type);
+	if ((test != IrLt && test != IrLe) || !isScalarLocal(op->child[2])) return;
+	if (!isScalarLocal(bound) && !(bound->nodekind == ExpK && bound->kind.exp == ConstK)) return;
+	/* counting up from 0 to a small constant, the copies would
+	 * run at most once and only cost their code
+	 */
+	if (bound->kind.exp == ConstK && bound->attr.val < 2 * UnrollFactor) return;
+	if ((step = countedStep(t->child[4], op->child[2]->bucket)) == NULL) return;
+	if (bodySize(t->child[4], op->child[2]->bucket, bound->kind.exp == IdK ? bound->bucket : NULL, step,
+			UNROLL_BUDGET / UnrollFactor) > UNROLL_BUDGET / UnrollFactor)
+		return;
+	if (ProfileUse && (runs = profileCount(CountIterations, curFunc->name, cond->lineno, t->attr.val)) >= 0 &&
+			runs < UnrollFactor)
+		return;
+
+	header = newBlock(curFunc);
+	body = newBlock(curFunc);
+	exit = newBlock(curFunc);
+	/* lim = n - (UnrollFactor - 1), the last i that leaves
+	 * room for all the copies
+	 */
+	lim = newReg(curFunc);
+	if (bound->kind.exp == ConstK) {
+		i = emit(IrConst, lim, -1, -1, t->lineno);
+		i->imm = bound->attr.val - (UnrollFactor - 1);
+	}
+	else {
+		n = genExp(bound);
+		i = emit(IrConst, newReg(curFunc), -1, -1, t->lineno);
+		i->imm = UnrollFactor - 1;
+		emit(IrSub, lim, n, i->dst, t->lineno);
+		/* none of it if the subtraction wrapped around */
+		c = newReg(curFunc);
+		emit(IrLt, c, lim, n, t->lineno);
+		emit(IrBranch, -1, c, -1, t->lineno);
+		addEdge(curBlock, header);
+		addEdge(curBlock, exit);
+	}
+	startBlock(header);
+	c = newReg(curFunc);
+	emit(test, c, genExp(op->child[2]), lim, t->lineno);
+	emit(IrBranch, -1, c, -1, t->lineno);
+	addEdge(curBlock, body);
+	addEdge(curBlock, exit);
+	startBlock(body);
+	for (k = 0; k < UnrollFactor; ++k) genStmt(t->child[4]);
+	emit(IrJump, -1, -1, -1, t->lineno);
+	addEdge(curBlock, header);
+	startBlock(exit);
+	curFunc->unrolled++;
+}
+
+/* Procedure genStmt generates code for a statement list */
+
+static void genStmt(TreeNode *t) {
+	for (; t != NULL; t = t->sibling) {
+		switch (t->kind.stmt) {
+			case CompoundStmtK:
+				genLocals(t->child[0]);
+				genStmt(t->child[1]);
+				break;
+			case ExpressionStmtK:
+				if (t->child[2] != NULL) genExp(t->child[2]);
+				break;
+			case SelectionStmtK:
+				{
+					IrBlock thenBlock = newBlock(curFunc);
+					/* -profile counts the way around an if without else too */
+					IrBlock elseBlock = t->child[5] != NULL || Profile ? newBlock(curFunc) : NULL;
+					IrBlock join = newBlock(curFunc);
+					int c = genExp(t->child[3]);
+					int line = t->child[3]->lineno;
+					int cold = ProfileUse ? coldSide(curFunc->name, line, t->attr.val) : -1;
+
+					emit(IrBranch, -1, c, -1, t->lineno);
+					addEdge(curBlock, thenBlock);
+					addEdge(curBlock, elseBlock != NULL ? elseBlock : join);
+					startBlock(thenBlock);
+					if (Profile) count(CountThen, line, t->attr.val);
+					genStmt(t->child[4]);
+					if (elseBlock != NULL) {
+						emit(IrJump, -1, -1, -1, t->lineno);
+						addEdge(curBlock, join);
+						startBlock(elseBlock);
+						if (cold == CountThen) markCold(thenBlock, elseBlock);
+						if (Profile) count(CountElse, line, t->attr.val);
+						genStmt(t->child[5]);
+					}
+					startBlock(join);
+					if (elseBlock == NULL && cold == CountThen) markCold(thenBlock, join);
+					else if (elseBlock != NULL && cold == CountElse) markCold(elseBlock, join);
+				}
+				break;
+			case IterationStmtK:
+				/* -profile counts the iterations of the loop as written */
+				if (Optimize && UnrollFactor > 1 && !Profile) unrollLoop(t);
+				{
+					IrBlock header = newBlock(curFunc);
+					IrBlock body = newBlock(curFunc);
+					IrBlock exit = newBlock(curFunc);
+					int c;
+
+					startBlock(header);
+					c = genExp(t->child[3]);
+					emit(IrBranch, -1, c, -1, t->lineno);
+					addEdge(curBlock, body);
+					addEdge(curBlock, exit);
+					startBlock(body);
+					/* counted at the line of the condition; the statement
+					 * has the line where the parser finished the loop
+					 */
+					if (Profile) count(CountIterations, t->child[3]->lineno, t->attr.val);
+					genStmt(t->child[4]);
+					emit(IrJump, -1, -1, -1, t->lineno);
+					addEdge(curBlock, header);
+					startBlock(exit);
+				}
+				break;
+			case ReturnStmtK:
+				{
+					int r = t->child[4] != NULL ? genExp(t->child[4]) : -1;
+
+					emit(IrRet, -1, r, -1, t->lineno);
+					startBlock(newBlock(curFunc));
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/* Procedure sealFunction ends the last block with an
+ * implicit return and drops empty unreachable blocks
+ */
+static void sealFunction(IrFunc f) {
+	IrBlock b, prev = NULL;
+
+	if (curBlock->last == NULL || curBlock->last->op != IrRet) {
+		int r = -1;
+		if (!f->isVoid) {
+			IrInstr i;
+			r = newReg(f);
+			i = emit(IrConst, r, -1, -1, 0);
+			i->imm = 0;
+		}
+		emit(IrRet, -1, r, -1, 0);
+	}
+	for (b = f->entry; b != NULL; b = b->next) {
+		if (b != f->entry && b->npred == 0 && b->first != NULL &&
+				b->first->op == IrJump && b->first->next == NULL) {
+			removePred(b->succ[0], b);
+			prev->next = b->next;
+		}
+		else prev = b;
+	}
+}
+
+static IrFunc genFunction(TreeNode *t) {
+	IrFunc f = (IrFunc)irAlloc(sizeof(struct IrFuncRec));
+	TreeNode *p;
+	int n = 0;
+
+	f->name = t->child[1]->attr.name;
+	f->sym = t->child[1]->bucket;
+	f->isVoid = t->child[0]->type == Void;
+	curFunc = f;
+	clearVars();
+
+	for (p = t->child[2]; p != NULL; p = p->sibling)
+		if (p->kind.decl != ParamVoidK) n++;
+	f->params = (int *)irAlloc((n + 1) * sizeof(int));
+	for (p = t->child[2]; p != NULL; p = p->sibling) {
+		if (p->kind.decl == ParamVoidK) continue;
+		f->params[f->nparams] = newReg(f);
+		bindVar(p->child[1]->bucket, f->params[f->nparams]);
+		f->nparams++;
+	}
+
+	f->entry = curBlock = lastBlock = newBlock(f);
+	if (Profile || ProfileUse) {
+		numberConditions(t->child[3], FALSE);
+		numberConditions(t->child[3], TRUE);
+	}
+	if (Profile) count(CountCalls, 0, 0);
+	genStmt(t->child[3]);
+	sealFunction(f);
+	return f;
+}
+
+IrProgram buildIR(TreeNode *syntaxTree) {
+	IrProgram prog = (IrProgram)irAlloc(sizeof(struct IrProgramRec));
+	IrFunc last = NULL;
+	IrGlobal g, lastGlobal = NULL;
+	TreeNode *t;
+
+	curProgram = prog;
+	lastCounter = NULL;
+	for (t = syntaxTree; t != NULL; t = t->sibling) {
+		if (t->kind.decl == FuncK) {
+			IrFunc f;
+
+			/* functions of other units have no body */
+			if (t->child[3] == NULL) continue;
+			f = genFunction(t);
+			if (last == NULL) prog->funcs = f;
+			else last->next = f;
+			last = f;
+			continue;
+		}
+		g = (IrGlobal)irAlloc(sizeof(struct IrGlobalRec));
+		g->name = t->child[1]->bucket->name;
+		g->base = globalBase(t->child[1]->bucket);
+		g->words = t->child[1]->bucket->memloc / 4 - g->base;
+		if (lastGlobal == NULL) prog->globals = g;
+		else lastGlobal->next = g;
+		lastGlobal = g;
+		if (t->child[1]->bucket->memloc / 4 > prog->globalSize)
+			prog->globalSize = t->child[1]->bucket->memloc / 4;
+	}
+	clearVars();
+	return prog;
+}
+
+char *undefinedFunction(IrProgram prog) {
+	IrFunc f, g;
+	IrBlock b;
+	IrInstr i;
+
+	for (f = prog->funcs; f != NULL; f = f->next)
+		for (b = f->entry; b != NULL; b = b->next)
+			for (i = b->first; i != NULL; i = i->next) {
+				if (i->op != IrCall && i->op != IrTailCall) continue;
+				if (!strcmp(i->name, "input") || !strcmp(i->name, "output")) continue;
+				for (g = prog->funcs; g != NULL && g->sym != i->sym; g = g->next);
+				if (g == NULL) return i->name;
+			}
+	return NULL;
+}
+
+/* printing */
+
+const char *irOpName(IrOp op) {
+	static const char *names[] = {
+		"const", "copy", "add", "sub", "mul", "div",
+		"lt", "le", "gt", "ge", "eq", "ne",
+		"gaddr", "laddr", "load", "store", "check", "call", "tailcall", "phi",
+		"ret", "jump", "br"
+	};
+	return names[op];
+}
+
+static void printInstr(IrInstr i) {
+	int k;
+
+	fprintf(listing, "    ");
+	if (i->dst >= 0) fprintf(listing, "v%d = ", i->dst);
+	fprintf(listing, "%s", irOpName(i->op));
+	switch (i->op) {
+		case IrConst:
+			fprintf(listing, " %d", i->imm);
+			break;
+		case IrGAddr:
+		case IrLAddr:
+			fprintf(listing, " %d", i->imm);
+			if (i->name != NULL) fprintf(listing, " (%s)", i->name);
+			break;
+		case IrCheck:
+			fprintf(listing, " v%d %d (%s)", i->src[0], i->imm, i->name);
+			break;
+		case IrCall:
+		case IrTailCall:
+			fprintf(listing, " %s", i->name);
+			for (k = 0; k < i->nargs; ++k) fprintf(listing, " v%d", i->args[k]);
+			break;
+		case IrPhi:
+			for (k = 0; k < i->nargs; ++k)
+				fprintf(listing, " [B%d v%d]", i->block->pred[k]->id, i->args[k]);
+			break;
+		case IrJump:
+			fprintf(listing, " B%d", i->block->succ[0]->id);
+			break;
+		case IrBranch:
+			fprintf(listing, " v%d B%d B%d", i->src[0], i->block->succ[0]->id, i->block->succ[1]->id);
+			break;
+		default:
+			for (k = 0; k < 2; ++k)
+				if (i->src[k] >= 0) fprintf(listing, " v%d", i->src[k]);
+			break;
+	}
+	fprintf(listing, "\n");
+}
+
+void printIR(IrProgram prog) {
+	IrFunc f;
+	IrBlock b;
+	IrInstr i;
+	int k;
+
+	for (f = prog->funcs; f != NULL; f = f->next) {
+		fprintf(listing, "function %s (", f->name);
+		for (k = 0; k < f->nparams; ++k)
+			fprintf(listing, k == 0 ? "v%d" : ", v%d", f->params[k]);
+		fprintf(listing, ") frame %d\n", f->frameSize);
+		for (b = f->entry; b != NULL; b = b->next) {
+			fprintf(listing, "  B%d:", b->id);
+			if (b->npred > 0) {
+				fprintf(listing, "  ; preds");
+				for (k = 0; k < b->npred; ++k) fprintf(listing, " B%d", b->pred[k]->id);
+			}
+			fprintf(listing, "\n");
+			for (i = b->first; i != NULL; i = i->next) printInstr(i);
+		}
+		fprintf(listing, "\n");
+	}
+}
@@ -0,0 +1,158 @@
+/* FILE: ir.h */
+/* Intermediate representation for the C-Minus compiler */
+/* Each function is a control flow graph of basic blocks */
+/* holding three-address instructions over virtual registers */
+
+#ifndef _IR_H_
+#define _IR_H_
+
+#include "globals.h"
+#include "symtab.h"
+
+/* IrOp enumerates the IR instructions.
+ * Every scalar local and parameter lives in a virtual register;
+ * globals and arrays live in memory and are reached through
+ * IrGAddr (word address in the global area) and
+ * IrLAddr (word offset from the frame pointer).
+ */
+typedef enum {
+	IrConst,	/* dst = imm */
+	IrCopy,		/* dst = src0 */
+	IrAdd, IrSub, IrMul, IrDiv,
+	IrLt, IrLe, IrGt, IrGe, IrEq, IrNe,
+	IrGAddr,	/* dst = address of global word imm */
+	IrLAddr,	/* dst = fp + imm */
+	IrLoad,		/* dst = mem[src0] */
+	IrStore,	/* mem[src0] = src1 */
+	IrCheck,	/* stop unless 0 <= src0 < imm, the size of array name */
+	IrCall,		/* dst = name(args) */
+	IrTailCall,	/* return name(args), reusing the frame */
+	IrPhi,		/* dst = phi(args), one arg per predecessor */
+	IrRet,		/* return src0 (-1 for none) */
+	IrJump,		/* goto succ[0] */
+	IrBranch	/* if src0 != 0 goto succ[0] else goto succ[1] */
+} IrOp;
+
+typedef struct IrInstrRec {
+	IrOp op;
+	int dst;		/* virtual register defined, -1 if none */
+	int src[2];		/* operand registers, -1 if unused */
+	int imm;		/* constant value or address */
+	int nargs;		/* call or phi operands */
+	int *args;
+	char *name;		/* callee of IrCall, symbol of address */
+	BucketList sym;
+	int lineno;
+	struct IrBlockRec *block;
+	struct IrInstrRec *prev;
+	struct IrInstrRec *next;
+} * IrInstr;
+
+typedef struct IrBlockRec {
+	int id;
+	IrInstr first;
+	IrInstr last;
+	int nsucc;
+	struct IrBlockRec *succ[2];
+	int npred;
+	int predCap;
+	struct IrBlockRec **pred;
+
+	/* filled in by computeDominators (ssa.c) */
+	int rpo;		/* reverse postorder number, -1 if unreachable */
+	struct IrBlockRec *idom;
+	int nkids;
+	struct IrBlockRec **kids;	/* dominator tree children */
+
+	struct IrBlockRec *next;	/* layout order */
+	int cold;		/* on the side of an if the profile saw run less */
+} * IrBlock;
+
+typedef struct IrFuncRec {
+	char *name;
+	BucketList sym;
+	int isVoid;
+	int nparams;
+	int *params;		/* registers holding incoming parameters */
+	int nregs;		/* virtual registers allocated so far */
+	int frameSize;		/* words of locals below the frame pointer */
+	int nblocks;
+	IrBlock entry;		/* first block in layout order */
+	int nrpo;
+	IrBlock *rpoOrder;	/* reachable blocks in reverse postorder */
+	int unrolled;		/* counted loops unrolled while lowering */
+	struct IrFuncRec *next;
+} * IrFunc;
+
+/* a global variable taking words of data from base on */
+typedef struct IrGlobalRec {
+	char *name;
+	int base;
+	int words;
+	struct IrGlobalRec *next;
+} * IrGlobal;
+
+/* what a counter of -profile counts: the calls of a function,
+ * the iterations of a loop, or the times either side of an if
+ * ran, the else side of an if without one included
+ */
+typedef enum { CountCalls, CountIterations, CountThen, CountElse } CountKind;
+
+/* a counter of -profile, in a global word after the variables,
+ * of function name and, but for the calls, the line of the
+ * condition of its loop or if and which of the loops and ifs
+ * of the function with a condition on that line it is
+ */
+typedef struct IrCounterRec {
+	CountKind kind;
+	char *name;
+	int line;		/* 0 for the calls */
+	int ordinal;		/* from 1, 0 for the calls */
+	int word;
+	struct IrCounterRec *next;
+} * IrCounter;
+
+typedef struct IrProgramRec {
+	IrFunc funcs;		/* the functions defined, in order */
+	IrGlobal globals;
+	int globalSize;		/* words of global data */
+	IrCounter counters;	/* in order of their words */
+	int ncounters;
+} * IrProgram;
+
+/* Function buildIR lowers an analyzed syntax tree to IR */
+
+IrProgram buildIR(TreeNode *);
+
+/* procedure printIR writes the IR of every function to the listing file */
+
+void printIR(IrProgram);
+
+/* Function undefinedFunction returns the name of a function
+ * the program calls but only declares, or NULL if there is none
+ */
+char *undefinedFunction(IrProgram);
+
+/* construction helpers shared by the optimization passes */
+
+IrBlock newBlock(IrFunc);
+int newReg(IrFunc);
+IrInstr newInstr(IrOp, int dst, int src0, int src1);
+void appendInstr(IrBlock, IrInstr);
+void insertBefore(IrInstr pos, IrInstr);
+void removeInstr(IrInstr);
+void addEdge(IrBlock from, IrBlock to);
+void removePred(IrBlock, IrBlock pred);
+int predIndex(IrBlock, IrBlock pred);
+int countInstrs(IrFunc);
+
+/* Function isPure is TRUE for instructions without side effects
+ * whose result depends only on their operands
+ */
+int isPure(IrOp);
+
+/* Function irOpName returns the mnemonic of an IR operation */
+
+const char *irOpName(IrOp);
+
+#endif
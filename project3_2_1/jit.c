@@ -0,0 +1,451 @@
+/* FILE: jit.c */
+/* In-memory x86-64 code generation for the C-Minus compiler */
+/* Encodes the same code as x86gen.c straight into an */
+/* executable buffer and runs it within the compiler */
+
+#include <sys/mman.h>
+#include "globals.h"
+#include "symtab.h"
+#include "ir.h"
+#include "x86gen.h"
+#include "jit.h"
+
+/* x86-64 register numbers */
+#define RAX 0
+#define RCX 1
+#define RDX 2
+#define RBX 3
+#define RBP 5
+#define RSI 6
+#define RDI 7
+#define R8 8
+#define R9 9
+#define R12 12
+
+/* System V integer argument registers */
+static int argReg[] = { RDI, RSI, RDX, RCX, R8, R9 };
+#define NARGREGS 6
+
+/* the code being generated */
+static unsigned char *buf;
+static int len, cap;
+
+/* Patch records a rel32 field whose target was not yet emitted */
+typedef struct PatchRec {
+	int pos;		/* offset of the rel32 field */
+	IrBlock target;		/* jump to a block, or */
+	int func;		/* call to the function with this memloc */
+	struct PatchRec *next;
+} * Patch;
+
+static Patch blockPatches;
+static Patch callPatches;
+
+static int *blockLoc;		/* code offset of every block */
+static int *funcLoc;		/* code offset of every function by memloc */
+static int *slot;		/* %rbp offset of every register */
+static int arrayFrame;		/* words of local arrays, 0 if none */
+static int arraySlot;		/* slot holding the local array base */
+
+static int *memory;		/* data memory of the running program */
+static void *exec;		/* executable copy of the code */
+static int execSize;
+
+static void byte(int b) {
+	if (len == cap) {
+		cap = cap == 0 ? 4096 : cap * 2;
+		buf = (unsigned char *)realloc(buf, cap);
+	}
+	buf[len++] = (unsigned char)b;
+}
+
+static void word32(int v) {
+	int k;
+
+	for (k = 0; k < 4; ++k) byte((v >> (8 * k)) & 0xff);
+}
+
+static void word64(long v) {
+	int k;
+
+	for (k = 0; k < 8; ++k) byte((int)((v >> (8 * k)) & 0xff));
+}
+
+static void patch32(int pos, int v) {
+	int k;
+
+	for (k = 0; k < 4; ++k) buf[pos + k] = (unsigned char)((v >> (8 * k)) & 0xff);
+}
+
+static void addPatch(Patch *list, int pos, IrBlock target, int func) {
+	Patch p = (Patch)malloc(sizeof(struct PatchRec));
+
+	p->pos = pos;
+	p->target = target;
+	p->func = func;
+	p->next = *list;
+	*list = p;
+}
+
+/* Procedure rbpOp emits an instruction with a reg, disp32(%rbp)
+ * operand: rex is 0x48 for 64-bit operands or 0, op2 is the
+ * second opcode byte or -1
+ */
+static void rbpOp(int rex, int op1, int op2, int reg, int disp) {
+	if (reg >= 8) rex |= 0x44;
+	if (rex != 0) byte(rex);
+	byte(op1);
+	if (op2 >= 0) byte(op2);
+	byte(0x80 | ((reg & 7) << 3) | RBP);
+	word32(disp);
+}
+
+static void load(int reg, int r) {
+	rbpOp(0, 0x8b, -1, reg, slot[r]);
+}
+
+static void store(int reg, int r) {
+	rbpOp(0, 0x89, -1, reg, slot[r]);
+}
+
+static void emitJump(int cond, IrBlock target) {
+	if (cond < 0) byte(0xe9);
+	else {
+		byte(0x0f);
+		byte(cond);
+	}
+	addPatch(&blockPatches, len, target, -1);
+	word32(0);
+}
+
+static void emitCallFunc(int memloc) {
+	byte(0xe8);
+	addPatch(&callPatches, len, NULL, memloc);
+	word32(0);
+}
+
+/* the runtime of jitted programs */
+
+static int jitInput(void) {
+	int x;
+
+	if (scanf("%d", &x) != 1) x = 0;
+	return x;
+}
+
+static void jitOutput(int x) {
+	printf("%d\n", x);
+}
+
+static void jitBounds(int line) {
+	fflush(stdout);
+	fprintf(stderr, "Array index out of bounds at line %d\n", line);
+	exit(2);
+}
+
+static void callRuntime(void *fn) {
+	byte(0x48);
+	byte(0xb8);
+	word64((long)fn);
+	byte(0xff);
+	byte(0xd0);
+}
+
+static void emitCall(IrInstr i) {
+	int k, pushed = i->nargs > NARGREGS ? i->nargs - NARGREGS : 0;
+
+	if (!strcmp(i->name, "input")) {
+		callRuntime((void *)jitInput);
+		return;
+	}
+	if (!strcmp(i->name, "output")) {
+		load(RDI, i->args[0]);
+		callRuntime((void *)jitOutput);
+		return;
+	}
+	if (pushed % 2 == 1) {
+		/* subq $8, %rsp */
+		byte(0x48); byte(0x81); byte(0xec); word32(8);
+	}
+	for (k = i->nargs - 1; k >= NARGREGS; --k) {
+		load(RAX, i->args[k]);
+		byte(0x50);
+	}
+	for (k = 0; k < i->nargs && k < NARGREGS; ++k) load(argReg[k], i->args[k]);
+	emitCallFunc(i->sym->memloc);
+	if (pushed > 0) {
+		/* addq $n, %rsp */
+		byte(0x48); byte(0x81); byte(0xc4); word32(8 * (pushed + pushed % 2));
+	}
+}
+
+static void emitEpilogue(void) {
+	if (arrayFrame > 0) {
+		/* addl $n, %r12d */
+		byte(0x41); byte(0x81); byte(0xc4); word32(arrayFrame);
+	}
+	byte(0xc9);
+}
+
+static int setOp(IrOp op) {
+	switch (op) {
+		case IrLt: return 0x9c;
+		case IrLe: return 0x9e;
+		case IrGt: return 0x9f;
+		case IrGe: return 0x9d;
+		case IrEq: return 0x94;
+		default: return 0x95;
+	}
+}
+
+static void genInstr(IrInstr i) {
+	int k;
+
+	switch (i->op) {
+		case IrConst:
+		case IrGAddr:
+			rbpOp(0, 0xc7, -1, 0, slot[i->dst]);
+			word32(i->imm);
+			break;
+		case IrCopy:
+			load(RAX, i->src[0]);
+			store(RAX, i->dst);
+			break;
+		case IrAdd:
+			load(RAX, i->src[0]);
+			rbpOp(0, 0x03, -1, RAX, slot[i->src[1]]);
+			store(RAX, i->dst);
+			break;
+		case IrSub:
+			load(RAX, i->src[0]);
+			rbpOp(0, 0x2b, -1, RAX, slot[i->src[1]]);
+			store(RAX, i->dst);
+			break;
+		case IrMul:
+			load(RAX, i->src[0]);
+			rbpOp(0, 0x0f, 0xaf, RAX, slot[i->src[1]]);
+			store(RAX, i->dst);
+			break;
+		case IrDiv:
+			load(RAX, i->src[0]);
+			byte(0x99);
+			rbpOp(0, 0xf7, -1, 7, slot[i->src[1]]);
+			store(RAX, i->dst);
+			break;
+		case IrLt: case IrLe: case IrGt: case IrGe: case IrEq: case IrNe:
+			load(RAX, i->src[0]);
+			rbpOp(0, 0x3b, -1, RAX, slot[i->src[1]]);
+			byte(0x0f); byte(setOp(i->op)); byte(0xc0);
+			byte(0x0f); byte(0xb6); byte(0xc0);
+			store(RAX, i->dst);
+			break;
+		case IrLAddr:
+			load(RAX, arraySlot);
+			byte(0x05);
+			word32(i->imm);
+			store(RAX, i->dst);
+			break;
+		case IrLoad:
+			rbpOp(0x48, 0x63, -1, RAX, slot[i->src[0]]);
+			/* movl (%rbx,%rax,4), %eax */
+			byte(0x8b); byte(0x04); byte(0x83);
+			store(RAX, i->dst);
+			break;
+		case IrStore:
+			rbpOp(0x48, 0x63, -1, RAX, slot[i->src[0]]);
+			load(RCX, i->src[1]);
+			/* movl %ecx, (%rbx,%rax,4) */
+			byte(0x89); byte(0x0c); byte(0x83);
+			break;
+		case IrCheck:
+			/* cmpl $size, disp(%rbp); jb over movl $line, %edi and the call */
+			rbpOp(0, 0x81, -1, 7, slot[i->src[0]]);
+			word32(i->imm);
+			byte(0x72); byte(17);
+			byte(0xbf); word32(i->lineno);
+			callRuntime((void *)jitBounds);
+			break;
+		case IrCall:
+			emitCall(i);
+			if (i->dst >= 0) store(RAX, i->dst);
+			break;
+		case IrTailCall:
+			if (i->nargs > NARGREGS) {
+				emitCall(i);
+				emitEpilogue();
+				byte(0xc3);
+				break;
+			}
+			for (k = 0; k < i->nargs; ++k) load(argReg[k], i->args[k]);
+			emitEpilogue();
+			byte(0xe9);
+			addPatch(&callPatches, len, NULL, i->sym->memloc);
+			word32(0);
+			break;
+		case IrRet:
+			if (i->src[0] >= 0) load(RAX, i->src[0]);
+			emitEpilogue();
+			byte(0xc3);
+			break;
+		case IrJump:
+			if (i->block->next != i->block->succ[0]) emitJump(-1, i->block->succ[0]);
+			break;
+		case IrBranch:
+			/* cmpl $0, disp(%rbp) */
+			rbpOp(0, 0x83, -1, 7, slot[i->src[0]]);
+			byte(0);
+			if (i->block->next == i->block->succ[1] && i->block->next != i->block->succ[0]) {
+				emitJump(0x85, i->block->succ[0]);	/* jne */
+				break;
+			}
+			emitJump(0x84, i->block->succ[1]);
+			if (i->block->next != i->block->succ[0]) emitJump(-1, i->block->succ[0]);
+			break;
+		default:
+			break;
+	}
+}
+
+/* Function assignSlots lays out the frame as x86gen.c does */
+
+static int assignSlots(IrFunc f) {
+	int next = 4;
+	IrBlock b;
+	IrInstr i;
+	int k;
+
+	slot = (int *)realloc(slot, (f->nregs + 1) * sizeof(int));
+	for (k = 0; k <= f->nregs; ++k) slot[k] = 0;
+	for (k = 0; k < f->nparams; ++k)
+		slot[f->params[k]] = k < NARGREGS ? -(next += 4) : 16 + 8 * (k - NARGREGS);
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) {
+			if (i->dst >= 0 && slot[i->dst] == 0) slot[i->dst] = -(next += 4);
+			for (k = 0; k < 2; ++k)
+				if (i->src[k] >= 0 && slot[i->src[k]] == 0) slot[i->src[k]] = -(next += 4);
+			for (k = 0; k < i->nargs; ++k)
+				if (slot[i->args[k]] == 0) slot[i->args[k]] = -(next += 4);
+		}
+	arraySlot = f->nregs;
+	slot[arraySlot] = -4;
+	return (next + 15) / 16 * 16;
+}
+
+static void genFunction(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	Patch p;
+	int k, bytes;
+
+	bytes = assignSlots(f);
+	arrayFrame = 0;
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->op == IrLAddr) arrayFrame = f->frameSize;
+	blockLoc = (int *)realloc(blockLoc, f->nblocks * sizeof(int));
+
+	funcLoc[f->sym->memloc] = len;
+	byte(0x55);					/* pushq %rbp */
+	byte(0x48); byte(0x89); byte(0xe5);		/* movq %rsp, %rbp */
+	byte(0x48); byte(0x81); byte(0xec); word32(bytes);	/* subq $n, %rsp */
+	for (k = 0; k < f->nparams && k < NARGREGS; ++k) store(argReg[k], f->params[k]);
+	if (arrayFrame > 0) {
+		rbpOp(0, 0x89, -1, R12, slot[arraySlot]);
+		byte(0x41); byte(0x81); byte(0xec); word32(arrayFrame);	/* subl $n, %r12d */
+	}
+	for (b = f->entry; b != NULL; b = b->next) {
+		blockLoc[b->id] = len;
+		for (i = b->first; i != NULL; i = i->next) genInstr(i);
+	}
+	while (blockPatches != NULL) {
+		p = blockPatches;
+		blockPatches = p->next;
+		patch32(p->pos, blockLoc[p->target->id] - (p->pos + 4));
+		free(p);
+	}
+}
+
+JitEntry jitCompile(IrProgram program) {
+	IrFunc f, mainFunc = NULL;
+	Patch p;
+	int entry, nfuncs = 0;
+
+	len = 0;
+	for (f = program->funcs; f != NULL; f = f->next) {
+		if (f->sym->memloc >= nfuncs) nfuncs = f->sym->memloc + 1;
+		if (!strcmp(f->name, "main")) mainFunc = f;
+	}
+	if (mainFunc == NULL) return NULL;
+	funcLoc = (int *)malloc((nfuncs + 1) * sizeof(int));
+	memory = (int *)calloc(X86_MEMORY_WORDS, sizeof(int));
+	if (memory == NULL) return NULL;
+
+	/* the entry sets up data memory as cmrt_start does */
+	entry = len;
+	byte(0x53);					/* pushq %rbx */
+	byte(0x41); byte(0x54);				/* pushq %r12 */
+	byte(0x48); byte(0x81); byte(0xec); word32(8);	/* subq $8, %rsp */
+	byte(0x48); byte(0xbb); word64((long)memory);	/* movabsq $memory, %rbx */
+	byte(0x41); byte(0xbc); word32(X86_MEMORY_WORDS);	/* movl $n, %r12d */
+	emitCallFunc(mainFunc->sym->memloc);
+	byte(0x48); byte(0x81); byte(0xc4); word32(8);	/* addq $8, %rsp */
+	byte(0x41); byte(0x5c);				/* popq %r12 */
+	byte(0x5b);					/* popq %rbx */
+	byte(0xc3);
+
+	for (f = program->funcs; f != NULL; f = f->next) genFunction(f);
+	while (callPatches != NULL) {
+		p = callPatches;
+		callPatches = p->next;
+		patch32(p->pos, funcLoc[p->func] - (p->pos + 4));
+		free(p);
+	}
+
+	execSize = len;
+	exec = mmap(NULL, execSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (exec == MAP_FAILED) return NULL;
+	memcpy(exec, buf, execSize);
+	if (mprotect(exec, execSize, PROT_READ | PROT_EXEC) != 0) return NULL;
+	return (JitEntry)((char *)exec + entry);
+}
+
+void jitProfile(IrProgram program) {
+	static char *heading[][2] = {
+		{ "calls", "function" }, { "iterations", "loop" }, { "then", "if" }, { "else", "if" }
+	};
+	IrCounter *order = (IrCounter *)malloc((program->ncounters + 1) * sizeof(IrCounter));
+	IrCounter c;
+	int kind, k, n;
+
+	for (kind = CountCalls; kind <= CountElse; ++kind) {
+		n = 0;
+		for (c = program->counters; c != NULL; c = c->next) {
+			if (c->kind != kind) continue;
+			for (k = n++; k > 0 && memory[order[k - 1]->word] < memory[c->word]; --k)
+				order[k] = order[k - 1];
+			order[k] = c;
+		}
+		if (n == 0) continue;
+		fprintf(stderr, "%12s  %s\n", heading[kind][0], heading[kind][1]);
+		for (k = 0; k < n; ++k) {
+			c = order[k];
+			if (kind == CountCalls) fprintf(stderr, "%12d  %s\n", memory[c->word], c->name);
+			else if (c->ordinal > 1) fprintf(stderr, "%12d  %s:%d.%d\n", memory[c->word], c->name, c->line, c->ordinal);
+			else fprintf(stderr, "%12d  %s:%d\n", memory[c->word], c->name, c->line);
+		}
+	}
+	free(order);
+}
+
+int jitCodeSize(void) {
+	return execSize;
+}
+
+void jitRelease(void) {
+	if (exec != NULL) munmap(exec, execSize);
+	exec = NULL;
+	free(memory);
+	memory = NULL;
+	free(funcLoc);
+	funcLoc = NULL;
+}
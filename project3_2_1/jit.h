@@ -0,0 +1,31 @@
+/* FILE: jit.h */
+
+#ifndef _JIT_H_
+#define _JIT_H_
+
+#include "ir.h"
+
+/* JitEntry runs a compiled program */
+typedef void (*JitEntry)(void);
+
+/* Function jitCompile translates the IR of the program to x86-64
+ * machine code in executable memory and returns its entry point,
+ * or NULL if there is no main function or no memory for it
+ */
+JitEntry jitCompile(IrProgram);
+
+/* Procedure jitProfile reports the counters of -profile after
+ * the program ran, like the simulator does
+ */
+
+void jitProfile(IrProgram);
+
+/* Function jitCodeSize returns the bytes of machine code compiled */
+
+int jitCodeSize(void);
+
+/* Procedure jitRelease frees the code and data memory of the program */
+
+void jitRelease(void);
+
+#endif
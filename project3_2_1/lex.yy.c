@@ -523,8 +523,11 @@ char *yytext;
 #include "scan.h"
 /* lexeme of identifier or reserved word */
 char tokenString[MAXTOKENLEN + 1];
+long tokenCount = 0;
+int tokenValue;
+char *tokenName;
 
-#line 528 "lex.yy.c"
+#line 530 "lex.yy.c"
 
 #define INITIAL 0
 #define COMMENT 1
@@ -743,10 +746,10 @@ YY_DECL
 		}
 
 	{
-#line 21 "tiny.l"
+#line 23 "tiny.l"
 
 
-#line 750 "lex.yy.c"
+#line 752 "lex.yy.c"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -805,220 +808,220 @@ do_action:	/* This label is used only to access EOF actions. */
 
 case 1:
 YY_RULE_SETUP
-#line 23 "tiny.l"
+#line 25 "tiny.l"
 { BEGIN(COMMENT); }
 	YY_BREAK
 case 2:
 YY_RULE_SETUP
-#line 24 "tiny.l"
+#line 26 "tiny.l"
 { BEGIN(INITIAL); }
 	YY_BREAK
 case 3:
 YY_RULE_SETUP
-#line 25 "tiny.l"
+#line 27 "tiny.l"
 { /* skip comments */ }
 	YY_BREAK
 case 4:
 /* rule 4 can match eol */
 YY_RULE_SETUP
-#line 26 "tiny.l"
+#line 28 "tiny.l"
 { lineno++; }
 	YY_BREAK
 case YY_STATE_EOF(COMMENT):
-#line 27 "tiny.l"
+#line 29 "tiny.l"
 { BEGIN(INITIAL); return ERROR; }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
-#line 28 "tiny.l"
+#line 30 "tiny.l"
 { return ERROR; }
 	YY_BREAK
 case YY_STATE_EOF(INITIAL):
-#line 29 "tiny.l"
+#line 31 "tiny.l"
 { return ENDFILE; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
-#line 31 "tiny.l"
+#line 33 "tiny.l"
 {return ELSE;}
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
-#line 32 "tiny.l"
+#line 34 "tiny.l"
 {return IF;}
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
-#line 33 "tiny.l"
+#line 35 "tiny.l"
 {return INT;}
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
-#line 34 "tiny.l"
+#line 36 "tiny.l"
 {return RETURN;}
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 35 "tiny.l"
+#line 37 "tiny.l"
 {return VOID;}
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 36 "tiny.l"
+#line 38 "tiny.l"
 {return WHILE;}
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 38 "tiny.l"
+#line 40 "tiny.l"
 {return PLUS;}
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 39 "tiny.l"
+#line 41 "tiny.l"
 {return MINUS;}
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 40 "tiny.l"
+#line 42 "tiny.l"
 {return TIMES;}
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 41 "tiny.l"
+#line 43 "tiny.l"
 {return OVER;}
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 44 "tiny.l"
+#line 46 "tiny.l"
 {return LT;}
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 45 "tiny.l"
+#line 47 "tiny.l"
 {return LE;}
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 46 "tiny.l"
+#line 48 "tiny.l"
 {return GT;}
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
-#line 47 "tiny.l"
+#line 49 "tiny.l"
 {return GE;}
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 48 "tiny.l"
+#line 50 "tiny.l"
 {return EQ;}
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 49 "tiny.l"
+#line 51 "tiny.l"
 {return NE;}
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 52 "tiny.l"
+#line 54 "tiny.l"
 {return ASSIGN;}
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
-#line 53 "tiny.l"
+#line 55 "tiny.l"
 {return SEMI;}
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 54 "tiny.l"
+#line 56 "tiny.l"
 {return COMMA;}
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 56 "tiny.l"
+#line 58 "tiny.l"
 {return LPAREN;}
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
-#line 57 "tiny.l"
+#line 59 "tiny.l"
 {return RPAREN;}
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
-#line 58 "tiny.l"
+#line 60 "tiny.l"
 {return LBRACKET;}
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
-#line 59 "tiny.l"
+#line 61 "tiny.l"
 {return RBRACKET;}
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
-#line 60 "tiny.l"
+#line 62 "tiny.l"
 {return LBRACE;}
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
-#line 61 "tiny.l"
+#line 63 "tiny.l"
 {return RBRACE;}
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
-#line 64 "tiny.l"
+#line 66 "tiny.l"
 {return THEN;}
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
-#line 65 "tiny.l"
+#line 67 "tiny.l"
 {return END;}
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
-#line 66 "tiny.l"
+#line 68 "tiny.l"
 {return REPEAT;}
 	YY_BREAK
 case 34:
 YY_RULE_SETUP
-#line 67 "tiny.l"
+#line 69 "tiny.l"
 {return UNTIL;}
 	YY_BREAK
 case 35:
 YY_RULE_SETUP
-#line 68 "tiny.l"
+#line 70 "tiny.l"
 {return READ;}
 	YY_BREAK
 case 36:
 YY_RULE_SETUP
-#line 69 "tiny.l"
+#line 71 "tiny.l"
 {return WRITE;}
 	YY_BREAK
 case 37:
 YY_RULE_SETUP
-#line 72 "tiny.l"
+#line 74 "tiny.l"
 {return NUM;}
 	YY_BREAK
 case 38:
 YY_RULE_SETUP
-#line 73 "tiny.l"
+#line 75 "tiny.l"
 {return ID;}
 	YY_BREAK
 case 39:
 /* rule 39 can match eol */
 YY_RULE_SETUP
-#line 74 "tiny.l"
+#line 76 "tiny.l"
 {lineno++;}
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 75 "tiny.l"
+#line 77 "tiny.l"
 {/* skip whitespace */}
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 78 "tiny.l"
+#line 80 "tiny.l"
 ECHO;
 	YY_BREAK
-#line 1022 "lex.yy.c"
+#line 1024 "lex.yy.c"
 
 	case YY_END_OF_BUFFER:
 		{
@@ -2017,21 +2020,37 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 78 "tiny.l"
+#line 80 "tiny.l"
 
 
 
+static int firstTime = TRUE;
+static YY_BUFFER_STATE textBuffer = NULL;
+
 TokenType getToken(void)
-{ static int firstTime = TRUE;
-  TokenType currentToken;
+{ TokenType currentToken;
+  int n;
   if (firstTime)
   { firstTime = FALSE;
     lineno++;
-    yyin = source;
+    yyrestart(source);
     yyout = listing;
   }
   currentToken = yylex();
-  strncpy(tokenString,yytext,MAXTOKENLEN);
+  tokenCount++;
+  n = yyleng < MAXTOKENLEN ? yyleng : MAXTOKENLEN;
+  memcpy(tokenString,yytext,n);
+  tokenString[n] = '\0';
+  /* the parser takes numbers and names from here, so the
+   * nodes need no conversion or copy of their own
+   */
+  if (currentToken == NUM)
+  { unsigned v = 0;
+    int k;
+    for (k = 0; k < n; ++k) v = 10 * v + (tokenString[k] - '0');
+    tokenValue = (int)v;
+  }
+  else if (currentToken == ID) tokenName = internString(tokenString,n);
   if (TraceScan) {
 //    fprintf(listing,"\t%d: ",lineno);
     printToken(currentToken,tokenString);
@@ -2039,5 +2058,21 @@ TokenType getToken(void)
   return currentToken;
 }
 
+void scanText(char *text, int line)
+{ if (textBuffer != NULL) yy_delete_buffer(textBuffer);
+  textBuffer = yy_scan_string(text);
+  BEGIN(INITIAL);
+  firstTime = FALSE;
+  lineno = line;
+}
+
+void scanSource(void)
+{ if (textBuffer != NULL) yy_delete_buffer(textBuffer);
+  textBuffer = NULL;
+  BEGIN(INITIAL);
+  firstTime = TRUE;
+  lineno = 0;
+}
+
 
 
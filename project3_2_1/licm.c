@@ -0,0 +1,230 @@
+/* FILE: licm.c */
+/* Natural loop detection and loop-invariant code motion */
+
+#include "globals.h"
+#include "ir.h"
+#include "ssa.h"
+#include "opt.h"
+
+typedef struct LoopRec {
+	IrBlock header;
+	int nblocks;
+	IrBlock *blocks;	/* loop body in reverse postorder */
+	char *member;		/* member[block id] */
+} * Loop;
+
+static Loop *loops;
+static int nloops;
+
+/* Procedure findLoops collects the natural loop of every header
+ * that is the target of a back edge, innermost loops first
+ */
+static void findLoops(IrFunc f) {
+	IrBlock *stack = (IrBlock *)malloc((f->nblocks + 1) * sizeof(IrBlock));
+	int i, k, j;
+
+	nloops = 0;
+	loops = (Loop *)realloc(loops, (f->nrpo + 1) * sizeof(Loop));
+	for (i = 0; i < f->nrpo; ++i) {
+		IrBlock h = f->rpoOrder[i];
+		Loop l = NULL;
+
+		for (k = 0; k < h->npred; ++k) {
+			IrBlock tail = h->pred[k];
+			int sp = 0;
+
+			if (!dominates(h, tail)) continue;
+			if (l == NULL) {
+				l = (Loop)malloc(sizeof(struct LoopRec));
+				l->header = h;
+				l->nblocks = 0;
+				l->member = (char *)calloc(f->nblocks, 1);
+				l->member[h->id] = 1;
+			}
+			if (!l->member[tail->id]) {
+				l->member[tail->id] = 1;
+				stack[sp++] = tail;
+			}
+			while (sp > 0) {
+				IrBlock b = stack[--sp];
+				for (j = 0; j < b->npred; ++j)
+					if (!l->member[b->pred[j]->id]) {
+						l->member[b->pred[j]->id] = 1;
+						stack[sp++] = b->pred[j];
+					}
+			}
+		}
+		if (l == NULL) continue;
+		l->blocks = (IrBlock *)malloc(f->nrpo * sizeof(IrBlock));
+		for (j = 0; j < f->nrpo; ++j)
+			if (l->member[f->rpoOrder[j]->id]) l->blocks[l->nblocks++] = f->rpoOrder[j];
+		loops[nloops++] = l;
+	}
+	free(stack);
+
+	/* a loop nested in another one has fewer blocks */
+	for (i = 1; i < nloops; ++i) {
+		Loop l = loops[i];
+		for (k = i; k > 0 && loops[k - 1]->nblocks > l->nblocks; --k) loops[k] = loops[k - 1];
+		loops[k] = l;
+	}
+}
+
+static void freeLoops(void) {
+	int i;
+
+	for (i = 0; i < nloops; ++i) {
+		free(loops[i]->blocks);
+		free(loops[i]->member);
+		free(loops[i]);
+	}
+	nloops = 0;
+}
+
+/* Procedure makePreheader gives the loop a block that is the
+ * only predecessor of the header from outside the loop and
+ * has the header as its only successor
+ */
+static void makePreheader(IrFunc f, Loop l) {
+	IrBlock h = l->header;
+	IrBlock p = NULL, before;
+	IrBlock *preds;
+	int k, j, nout = 0, nin = 0;
+	IrInstr i;
+
+	for (k = 0; k < h->npred; ++k)
+		if (!l->member[h->pred[k]->id]) {
+			nout++;
+			p = h->pred[k];
+		}
+	if (nout == 1 && p->nsucc == 1) return;
+
+	p = newBlock(f);
+	appendInstr(p, newInstr(IrJump, -1, -1, -1));
+	p->succ[0] = h;
+	p->nsucc = 1;
+	p->predCap = nout;
+	p->pred = (IrBlock *)malloc(nout * sizeof(IrBlock));
+
+	/* split every phi of the header into an outside part
+	 * merged in the preheader and the loop-carried part
+	 */
+	preds = (IrBlock *)malloc((h->npred + 1) * sizeof(IrBlock));
+	for (i = h->first; i != NULL && i->op == IrPhi; i = i->next) {
+		IrInstr outer = newInstr(IrPhi, newReg(f), -1, -1);
+		int *newArgs = (int *)malloc((h->npred + 1) * sizeof(int));
+
+		outer->args = (int *)malloc(nout * sizeof(int));
+		nin = 1;
+		for (k = 0; k < h->npred; ++k) {
+			if (l->member[h->pred[k]->id]) newArgs[nin++] = i->args[k];
+			else outer->args[outer->nargs++] = i->args[k];
+		}
+		for (j = 1; j < outer->nargs && outer->args[j] == outer->args[0]; ++j);
+		if (j == outer->nargs) {
+			newArgs[0] = outer->args[0];
+			free(outer->args);
+			free(outer);
+		}
+		else {
+			newArgs[0] = outer->dst;
+			insertBefore(p->last, outer);
+		}
+		free(i->args);
+		i->args = newArgs;
+		i->nargs = nin;
+	}
+	nin = 1;
+	preds[0] = p;
+	for (k = 0; k < h->npred; ++k) {
+		IrBlock q = h->pred[k];
+
+		if (l->member[q->id]) preds[nin++] = q;
+		else {
+			for (j = 0; j < q->nsucc; ++j)
+				if (q->succ[j] == h) q->succ[j] = p;
+			p->pred[p->npred++] = q;
+		}
+	}
+	free(h->pred);
+	h->pred = preds;
+	h->npred = nin;
+	h->predCap = h->npred + 1;
+
+	/* lay the preheader out just before the header */
+	for (before = f->entry; before->next != h; before = before->next);
+	p->next = h;
+	before->next = p;
+}
+
+/* hoisting state */
+static IrBlock *defBlock;	/* block defining every register */
+
+static int isInvariant(Loop l, IrInstr i, int writesMemory) {
+	int k;
+
+	if (i->op == IrPhi || i->op == IrCopy) return FALSE;
+	if (i->op == IrLoad) {
+		/* loads are only moved from the header, which runs
+		 * whenever the preheader does, and only out of loops
+		 * that do not store, call or check bounds
+		 */
+		if (writesMemory || i->block != l->header) return FALSE;
+	}
+	else if (!isPure(i->op)) return FALSE;
+	if (i->op == IrDiv && i->block != l->header) return FALSE;
+	for (k = 0; k < 2; ++k)
+		if (i->src[k] >= 0 && defBlock[i->src[k]] != NULL && l->member[defBlock[i->src[k]]->id])
+			return FALSE;
+	return TRUE;
+}
+
+static int hoistLoop(Loop l) {
+	IrBlock pre = NULL;
+	IrInstr i, next;
+	int k, changed, writesMemory = FALSE, hoisted = 0;
+
+	for (k = 0; k < l->header->npred; ++k)
+		if (!l->member[l->header->pred[k]->id]) pre = l->header->pred[k];
+	for (k = 0; k < l->nblocks; ++k)
+		for (i = l->blocks[k]->first; i != NULL; i = i->next)
+			if (i->op == IrStore || i->op == IrCall || i->op == IrTailCall || i->op == IrCheck)
+				writesMemory = TRUE;
+	do {
+		changed = FALSE;
+		for (k = 0; k < l->nblocks; ++k)
+			for (i = l->blocks[k]->first; i != NULL; i = next) {
+				next = i->next;
+				if (!isInvariant(l, i, writesMemory)) continue;
+				removeInstr(i);
+				insertBefore(pre->last, i);
+				defBlock[i->dst] = pre;
+				hoisted++;
+				changed = TRUE;
+			}
+	} while (changed);
+	return hoisted;
+}
+
+int hoistInvariants(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	int k, hoisted = 0;
+
+	computeDominators(f);
+	findLoops(f);
+	if (nloops == 0) return 0;
+	for (k = 0; k < nloops; ++k) makePreheader(f, loops[k]);
+	freeLoops();
+
+	computeDominators(f);
+	findLoops(f);
+	defBlock = (IrBlock *)calloc(f->nregs, sizeof(IrBlock));
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->dst >= 0) defBlock[i->dst] = b;
+	for (k = 0; k < nloops; ++k) hoisted += hoistLoop(loops[k]);
+	free(defBlock);
+	freeLoops();
+	return hoisted;
+}
@@ -12,17 +12,28 @@
 
 /* set NO_CODE to TRUE to get a compiler that does not generate code */
 
-#define NO_CODE TRUE
+#define NO_CODE FALSE
 
+#include <time.h>
+#include <sys/resource.h>
+#include <unistd.h>
 #include "util.h"
-#if NO_PARSE
 #include "scan.h"
-#else
+#if !NO_PARSE
 #include "parse.h"
 #if !NO_ANALYZE
 #include "analyze.h"
+#include "incr.h"
+#include "ir.h"
+#include "opt.h"
 #if !NO_CODE
 #include "cgen.h"
+#include "jit.h"
+#include "cache.h"
+#include "server.h"
+#include "ast.h"
+#include "dump.h"
+#include "pgo.h"
 #endif
 #endif
 #endif
@@ -41,20 +52,205 @@ int TraceScan = FALSE;
 int TraceParse = TRUE;
 int TraceAnalyze = TRUE;
 int TraceCode = FALSE;
+int TraceOptimize = TRUE;
+
+int Optimize = FALSE;
+int LoopInvariantMotion = TRUE;
+int TailCalls = TRUE;
+int Peephole = TRUE;
+int InlineLimit = 20;
+int UnrollFactor = 4;
+int BoundsCheck = FALSE;
+int NativeCode = FALSE;
+int BinaryCode = FALSE;
+int SeparateCompile = FALSE;
+int Profile = FALSE;
+int ProfileUse = FALSE;
 
 int Error = FALSE;
 
-main (int argc, char *argv[]) {
+#if !NO_PARSE && !NO_ANALYZE
+/* check the source again after every edit instead of compiling it */
+static int Incremental = FALSE;
+#endif
+
+/* the time of every phase, reported with -time-phases */
+enum { PhaseParse, PhaseAnalyze, PhaseIR, PhaseOptimize, PhaseCode, NPHASES };
+static char *phaseName[NPHASES] = { "parse", "analyze", "ir", "optimize", "codegen" };
+static long phaseUs[NPHASES];
+static long phaseStart;
+static int TimePhases = FALSE;
+
+static long microseconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+/* Procedure endPhase charges the time since the last phase ended to phase */
+static void endPhase(int phase) {
+    long now = microseconds();
+
+    phaseUs[phase] = now - phaseStart;
+    phaseStart = now;
+}
+
+/* Procedure reportPhases prints the size of the source, the time of
+ * every phase and the peak memory of the compiler to stderr
+ */
+static void reportPhases(void) {
+    struct rusage usage;
+    int k;
+
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "PHASES: lines %d, tokens %ld,", lineno, tokenCount);
+    for (k = 0; k < NPHASES; ++k) fprintf(stderr, " %s %ld", phaseName[k], phaseUs[k]);
+    fprintf(stderr, " us, peak %ld KB\n", usage.ru_maxrss);
+}
+
+#if !NO_CODE
+/* run the program from memory instead of writing a code file */
+static int RunInMemory = FALSE;
+static int programStdout = -1;	/* stdout of the program while the compiler's goes to stderr */
+
+/* the compile cache, off unless a directory is given */
+static char *CacheDir = NULL;
+static long CacheMax = 64L * 1024 * 1024;
+static int CacheStats = FALSE;
+static int Cached = FALSE;	/* TRUE when this compilation was looked up in the cache */
+static char **opts = NULL;	/* the options that change the output, part of the cache key */
+static int nopts = 0;
+
+/* write the syntax tree after parsing, or map it back from a .ast source */
+static int EmitAst = FALSE;
+
+/* dump the checked tree and symbol table, as JSON Lines or binary */
+static int Dump = FALSE;
+static DumpFormat DumpAs = DumpJson;
+
+/* answer requests instead of compiling, on stdin or a Unix socket */
+static int Server = FALSE;
+static char *ServerSocket = NULL;
+
+/* Function outputName returns source pgm with its suffix replaced */
+static char *outputName(char *pgm, char *suffix) {
+    int fnlen = strrchr(pgm, '.') - pgm;
+    char *name = (char *)calloc(fnlen + strlen(suffix) + 1, sizeof(char));
+
+    strncpy(name, pgm, fnlen);
+    strcat(name, suffix);
+    return name;
+}
+
+/* Function codeFileName returns the code file of source pgm */
+static char *codeFileName(char *pgm) {
+    if (NativeCode) return outputName(pgm, ".s");
+    if (SeparateCompile) return outputName(pgm, ".tmo");
+    return outputName(pgm, BinaryCode ? ".tmb" : ".tm");
+}
+#endif
+
+/* Function setOption sets the code generation option opt,
+ * returning FALSE if there is no such option
+ */
+static int setOption(char *opt) {
+    if (!strcmp(opt, "-O")) Optimize = TRUE;
+    else if (!strcmp(opt, "-fno-licm")) LoopInvariantMotion = FALSE;
+    else if (!strcmp(opt, "-fno-tail-calls")) TailCalls = FALSE;
+    else if (!strcmp(opt, "-fno-peephole")) Peephole = FALSE;
+    else if (!strncmp(opt, "-finline-limit=", 15)) InlineLimit = atoi(opt + 15);
+    else if (!strncmp(opt, "-funroll-factor=", 16)) UnrollFactor = atoi(opt + 16);
+    else if (!strcmp(opt, "-fbounds-check")) BoundsCheck = TRUE;
+    else if (!strcmp(opt, "-x86-64")) NativeCode = TRUE;
+    else if (!strcmp(opt, "-binary")) BinaryCode = TRUE;
+    else if (!strcmp(opt, "-c")) SeparateCompile = TRUE;
+    else if (!strcmp(opt, "-profile")) Profile = TRUE;
+    else if (!strncmp(opt, "-fprofile-use=", 14)) {
+        if (!readProfile(opt + 14)) {
+            fprintf(stderr, "Unable to read profile %s\n", opt + 14);
+            exit(1);
+        }
+        ProfileUse = TRUE;
+    }
+#if !NO_CODE
+    else if (!strcmp(opt, "-jit")) {
+        /* keep stdout for the program */
+        RunInMemory = TRUE;
+        EchoSource = TraceParse = TraceAnalyze = TraceOptimize = FALSE;
+    }
+#endif
+    else return FALSE;
+#if !NO_CODE
+    opts = (char **)realloc(opts, (nopts + 1) * sizeof(char *));
+    opts[nopts++] = opt;
+#endif
+    return TRUE;
+}
+
+static void usage(char *name) {
+    fprintf(stderr, "usage: %s [-O] [-fno-licm] [-fno-tail-calls] [-fno-peephole] [-finline-limit=N] [-funroll-factor=N] [-fbounds-check] [-x86-64] [-binary] [-c] [-profile] [-fprofile-use=FILE] [-jit] [-incremental] [-cache=DIR] [-cache-max=KB] [-cache-stats] [-server[=SOCKET]] [-ast] [-dump=json|binary] [-time-phases] <filename> \n", name);
+    exit(1);
+}
+
+int main (int argc, char *argv[]) {
     TreeNode *syntaxTree;
-    char pgm[20]; /* source code file name */
+    char pgm[256]; /* source code file name */
+    int arg;
+#if !NO_CODE
+    long start = microseconds();
+    char *codefile = NULL;
+    int astSource, astNodes;
+#endif
 
+    /* a listing to a file or pipe is written in large blocks */
+    if (!isatty(1)) setvbuf(stdout, NULL, _IOFBF, 1 << 16);
 	init();
-    if (argc != 2) {
-        fprintf(stderr, "usage: %s <filename> \n", argv[0]);
-        exit(1);
+    for (arg = 1; arg < argc && argv[arg][0] == '-'; ++arg) {
+        if (setOption(argv[arg])) continue;
+        if (!strcmp(argv[arg], "-time-phases")) TimePhases = TRUE;
+        else
+#if !NO_PARSE && !NO_ANALYZE
+        if (!strcmp(argv[arg], "-incremental")) Incremental = TRUE;
+        else
+#endif
+#if !NO_CODE
+        if (!strncmp(argv[arg], "-cache=", 7)) CacheDir = argv[arg] + 7;
+        else if (!strncmp(argv[arg], "-cache-max=", 11)) CacheMax = atol(argv[arg] + 11) * 1024;
+        else if (!strcmp(argv[arg], "-cache-stats")) CacheStats = TRUE;
+        else if (!strcmp(argv[arg], "-ast")) EmitAst = TRUE;
+        else if (!strcmp(argv[arg], "-dump=json")) Dump = TRUE;
+        else if (!strcmp(argv[arg], "-dump=binary")) {
+            Dump = TRUE;
+            DumpAs = DumpBinary;
+        }
+        else if (!strcmp(argv[arg], "-server")) Server = TRUE;
+        else if (!strncmp(argv[arg], "-server=", 8)) {
+            Server = TRUE;
+            ServerSocket = argv[arg] + 8;
+        }
+        else
+#endif
+        usage(argv[0]);
     }
+#if !NO_CODE
+    if (Server) {
+        /* returns in the child of a compile request */
+        char *file = serve(ServerSocket, setOption);
 
-    strcpy(pgm, argv[1]);
+        if (file == NULL) return 0;
+        if (strlen(file) + 5 > sizeof(pgm)) {
+            fprintf(stderr, "File name %s too long\n", file);
+            exit(1);
+        }
+        strcpy(pgm, file);
+    }
+    else
+#endif
+    if (arg != argc - 1 || strlen(argv[arg]) + 5 > sizeof(pgm))
+        usage(argv[0]);
+    else
+        strcpy(pgm, argv[arg]);
 
     if (strchr(pgm, '.') == NULL)
         strcat(pgm, ".tny");
@@ -65,19 +261,76 @@ main (int argc, char *argv[]) {
         exit(1);
     }
     listing = stdout; /* send listing to screen */
+#if !NO_PARSE && !NO_ANALYZE
+    if (Incremental) {
+        fclose(source);
+        return incremental(pgm);
+    }
+#endif
+#if !NO_CODE
+    if (RunInMemory) {
+        /* the compiler's messages go to stderr, the program's output to stdout */
+        fflush(stdout);
+        programStdout = dup(1);
+        dup2(2, 1);
+    }
+    else if (CacheDir != NULL && !EmitAst && !Dump && !ProfileUse) {
+        /* on a hit the listing and code file are the cached ones */
+        codefile = codeFileName(pgm);
+        cacheOpen(CacheDir, CacheMax);
+        cacheKey(source, opts, nopts, codefile);
+        Cached = TRUE;
+        if (cacheFetch(codefile)) {
+            if (CacheStats) cacheReport();
+            return 0;
+        }
+        cacheBegin();
+    }
+#endif
 //    fprintf(listing, "\nTINY COMPILATION: %s\n", pgm);
 
 #if NO_PARSE
 	fprintf(listing, "\tline number\t%s\t\t%-25s\t\n", "token", "lexeme");
 	fprintf(listing, "---------------------------------------------------------\n");
     while (getToken() != ENDFILE);
+#else
+    phaseStart = microseconds();
+#if !NO_CODE
+    astSource = !strcmp(strrchr(pgm, '.'), ".ast");
+    if (astSource) {
+        long loadStart = microseconds();
+
+        syntaxTree = astRead(source, &astNodes);
+        if (syntaxTree == NULL) exit(1);
+        if (EmitAst) fprintf(stderr, "AST: %d nodes, load %ld us\n", astNodes, microseconds() - loadStart);
+    }
+    else {
+        long parseStart = microseconds(), parsed;
+
+        syntaxTree = parse();
+        parsed = microseconds();
+        if (EmitAst && !Error) {
+            char *astfile = outputName(pgm, ".ast");
+            FILE *f = fopen(astfile, "wb");
+
+            if (f == NULL || (astNodes = astWrite(syntaxTree, f)) < 0) {
+                printf("Unable to write %s\n", astfile);
+                exit(1);
+            }
+            fprintf(stderr, "AST: %d nodes, %ld bytes, parse %ld us, write %ld us\n",
+                astNodes, ftell(f), parsed - parseStart, microseconds() - parsed);
+            fclose(f);
+        }
+    }
 #else
     syntaxTree = parse();
+#endif
     if (TraceParse) {
         fprintf(listing, "\nSyntax tree:\n");
 		printTree(syntaxTree);
     }
 	printf("end\n");
+    endPhase(PhaseParse);
 #if !NO_ANALYZE
     if (!Error) {
         fprintf(listing, "\nBuilding Symbol Table...\n");
@@ -86,25 +339,84 @@ main (int argc, char *argv[]) {
 		//isMainLast();
         typeCheck(syntaxTree);
         fprintf(listing, "\nType Checking Finished\n");
+        endPhase(PhaseAnalyze);
+    }
+#if !NO_CODE
+    if (Dump && !Error) {
+        char *dumpfile = outputName(pgm, DumpAs == DumpBinary ? ".dump" : ".jsonl");
+        FILE *f = fopen(dumpfile, "wb");
+        long dumpStart = microseconds();
+        int nodes;
+
+        if (f == NULL) {
+            printf("Unable to open %s\n", dumpfile);
+            exit(1);
+        }
+        nodes = dumpProgram(syntaxTree, f, DumpAs);
+        fprintf(stderr, "DUMP: %d nodes, %ld bytes, %ld us\n", nodes, ftell(f), microseconds() - dumpStart);
+        fclose(f);
+        phaseStart = microseconds();
     }
+#endif
 #if !NO_CODE
     if (!Error) {
-        char *codefile;
-        int fnlen = strcspn(pgm, ".");
-        
-        codefile = (char *)calloc(fnlen + 4, sizeof(char));
-        strncpy(codefile, pgm, fnlen);
-        strcat(codefile, ".tm");
-        code = fopen(codefile, "w");
+        IrProgram program;
+
+        program = buildIR(syntaxTree);
+        endPhase(PhaseIR);
+        if (Optimize) optimizeIR(program);
+        endPhase(PhaseOptimize);
+        if (!SeparateCompile || RunInMemory) {
+            char *name = undefinedFunction(program);
+
+            if (name != NULL) {
+                fprintf(listing, "ERROR: function %s is declared but not defined\n", name);
+                exit(1);
+            }
+        }
+        if (Profile && (BinaryCode || SeparateCompile)) {
+            /* only a program in text or machine code names its counters */
+            fprintf(listing, "ERROR: -profile needs a whole program in text TM code or x86-64\n");
+            exit(1);
+        }
+        if (RunInMemory) {
+            JitEntry entry = jitCompile(program);
+            long compiled, finished;
+
+            if (entry == NULL) {
+                fprintf(stderr, "Unable to compile %s in memory\n", pgm);
+                exit(1);
+            }
+            fflush(stdout);
+            dup2(programStdout, 1);
+            compiled = microseconds();
+            entry();
+            fflush(stdout);
+            finished = microseconds();
+            if (Profile) jitProfile(program);
+            fprintf(stderr, "JIT: %d bytes of code, compile %ld us, execute %ld us\n",
+                jitCodeSize(), compiled - start, finished - compiled);
+            jitRelease();
+            return 0;
+        }
+        if (codefile == NULL) codefile = codeFileName(pgm);
+        code = fopen(codefile, BinaryCode ? "wb" : "w");
         if (code == NULL) {
             printf("Unable to open %s\n", codefile);
             exit(1);
         }
-        codeGen(syntaxTree, codefile);
+        codeGen(program, codefile);
         fclose(code);
+        endPhase(PhaseCode);
+    }
+    if (Cached) {
+        /* a failed compilation keeps its diagnostics only */
+        cacheStore(Error ? NULL : codefile);
+        if (CacheStats) cacheReport();
     }
 #endif
 #endif
 #endif
+    if (TimePhases) reportPhases();
     return 0;
 }
@@ -0,0 +1,97 @@
+/* FILE: opt.c */
+/* Optimization pass driver */
+
+#include "globals.h"
+#include "ir.h"
+#include "ssa.h"
+#include "opt.h"
+#include "pgo.h"
+
+void optimizeIR(IrProgram prog) {
+	IrFunc f;
+	int before, after, redundant, copies, hoisted, folded, dead, blocks;
+	int totalBefore = 0, totalAfter = 0, totalRedundant = 0, totalHoisted = 0;
+	int totalFolded = 0, totalDead = 0, totalBlocks = 0;
+	int inlined, loops, tails, totalLoops = 0, totalTails = 0;
+	int moved, totalMoved = 0, totalUnrolled = 0;
+	int elided, checks, totalElided = 0, totalChecks = 0;
+
+	if (TraceOptimize) fprintf(listing, "\nOptimizing...\n");
+	/* counted loops were unrolled while lowering */
+	for (f = prog->funcs; f != NULL; f = f->next) {
+		totalUnrolled += f->unrolled;
+		if (TraceOptimize && UnrollFactor > 1 && f->unrolled > 0)
+			fprintf(listing, "UNROLL %-9s %4d counted loops unrolled by %d\n", f->name, f->unrolled, UnrollFactor);
+	}
+	if (TraceOptimize && UnrollFactor > 1)
+		fprintf(listing, "UNROLL total     %4d counted loops unrolled by %d\n", totalUnrolled, UnrollFactor);
+	/* self recursion turned into loops can make a function a leaf
+	 * the inliner accepts, and calls it inlines need no frame
+	 */
+	for (f = prog->funcs; f != NULL && TailCalls; f = f->next) {
+		totalLoops += loops = eliminateTailCalls(f, TRUE);
+		if (TraceOptimize && loops > 0)
+			fprintf(listing, "TAIL %-11s %4d self-recursive tail calls turned into loops\n", f->name, loops);
+	}
+	inlined = inlineCalls(prog, InlineLimit);
+	if (TraceOptimize)
+		fprintf(listing, "INLINE total     %4d call sites inlined (limit %d instructions)\n", inlined, InlineLimit);
+	for (f = prog->funcs; f != NULL && TailCalls; f = f->next) {
+		totalTails += tails = eliminateTailCalls(f, FALSE);
+		if (TraceOptimize && tails > 0)
+			fprintf(listing, "TAIL %-11s %4d tail calls reuse the frame\n", f->name, tails);
+	}
+	if (TraceOptimize)
+		fprintf(listing, "TAIL total       %4d self-recursive tail calls turned into loops, %4d tail calls reuse the frame\n",
+			totalLoops, totalTails);
+	for (f = prog->funcs; f != NULL; f = f->next) {
+		before = countInstrs(f);
+		buildSSA(f);
+		redundant = valueNumber(f, &copies);
+		folded = foldBranches(f);
+		elided = BoundsCheck ? elideBoundsChecks(f, &checks) : (checks = 0);
+		hoisted = LoopInvariantMotion ? hoistInvariants(f) : 0;
+		destroySSA(f);
+		dead = eliminateDeadCode(f, &blocks);
+		after = countInstrs(f);
+		if (TraceOptimize) {
+			fprintf(listing, "GVN %-12s %4d instructions, %4d redundant eliminated, %4d copies propagated, %4d after SSA\n",
+				f->name, before, redundant, copies, after);
+			if (checks > 0)
+				fprintf(listing, "BOUNDS %-9s %4d of %4d bounds checks elided\n", f->name, elided, checks);
+			if (hoisted > 0)
+				fprintf(listing, "LICM %-11s %4d loop-invariant instructions hoisted\n", f->name, hoisted);
+			fprintf(listing, "DCE %-12s %4d constant branches folded, %4d dead instructions, %4d blocks removed\n",
+				f->name, folded, dead, blocks);
+		}
+		totalBefore += before;
+		totalAfter += after;
+		totalRedundant += redundant;
+		totalHoisted += hoisted;
+		totalElided += elided;
+		totalChecks += checks;
+		totalFolded += folded;
+		totalDead += dead;
+		totalBlocks += blocks;
+	}
+	/* last, as the passes keep the layout but not the cold marks
+	 * of the blocks they make
+	 */
+	for (f = prog->funcs; f != NULL && ProfileUse; f = f->next) {
+		totalMoved += moved = layoutBlocks(f);
+		if (TraceOptimize && moved > 0)
+			fprintf(listing, "PGO %-12s %4d cold blocks laid out last\n", f->name, moved);
+	}
+	if (TraceOptimize) {
+		fprintf(listing, "GVN total        %4d instructions, %4d redundant eliminated, %4d after SSA\n",
+			totalBefore, totalRedundant, totalAfter);
+		if (BoundsCheck)
+			fprintf(listing, "BOUNDS total     %4d of %4d bounds checks elided\n", totalElided, totalChecks);
+		fprintf(listing, "LICM total       %4d loop-invariant instructions hoisted\n", totalHoisted);
+		fprintf(listing, "DCE total        %4d constant branches folded, %4d dead instructions, %4d blocks removed\n",
+			totalFolded, totalDead, totalBlocks);
+		if (ProfileUse) fprintf(listing, "PGO total        %4d cold blocks laid out last\n", totalMoved);
+		fprintf(listing, "\nOptimized IR:\n\n");
+		printIR(prog);
+	}
+}
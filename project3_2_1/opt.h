@@ -0,0 +1,66 @@
+/* FILE: opt.h */
+/* IR optimizer for the C-Minus compiler */
+
+#ifndef _OPT_H_
+#define _OPT_H_
+
+#include "ir.h"
+
+/* Procedure optimizeIR runs the optimization passes over every
+ * function of the program and reports their effect to the
+ * listing file when TraceOptimize is set
+ */
+void optimizeIR(IrProgram);
+
+/* Function eliminateTailCalls works on a function before SSA
+ * construction: calls whose result is returned at once become
+ * jumps to the top of the function when they are self-recursive
+ * and, unless selfOnly is set, IrTailCall otherwise; it returns
+ * the number of tail calls eliminated
+ */
+int eliminateTailCalls(IrFunc, int selfOnly);
+
+/* Function inlineCalls replaces calls to leaf functions of at
+ * most limit instructions by copies of their bodies, with a
+ * profile a limit of their own; it returns the number of call
+ * sites inlined
+ */
+int inlineCalls(IrProgram, int limit);
+
+/* Function valueNumber performs dominator-based global value
+ * numbering on a function in SSA form, removing redundant
+ * computations and copies; it returns the number of redundant
+ * computations removed and stores the number of copies
+ * propagated in *copies
+ */
+int valueNumber(IrFunc, int *copies);
+
+/* Function hoistInvariants finds the natural loops of a function
+ * in SSA form, gives each a preheader and moves loop-invariant
+ * computations into it; it returns the number of instructions moved
+ */
+int hoistInvariants(IrFunc);
+
+/* Function elideBoundsChecks computes the range of every
+ * register of a function in SSA form, narrowed by the branches
+ * and checks that dominate its uses, and removes the bounds
+ * checks whose index is proved in range; it returns the number
+ * removed and stores the number there were in *checks
+ */
+int elideBoundsChecks(IrFunc, int *checks);
+
+/* Function foldBranches turns branches on constants of a function
+ * in SSA form into jumps and removes the blocks that become
+ * unreachable; it returns the number of branches folded
+ */
+int foldBranches(IrFunc);
+
+/* Function eliminateDeadCode works on a function out of SSA form:
+ * it drops unreachable blocks, merges straight-line blocks and
+ * removes instructions whose result is not live; it returns the
+ * number of instructions removed and stores the number of blocks
+ * removed in *blocks
+ */
+int eliminateDeadCode(IrFunc, int *blocks);
+
+#endif
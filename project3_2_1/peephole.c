@@ -0,0 +1,281 @@
+/* FILE: peephole.c */
+/* Peephole optimization of the TM code: a table of patterns */
+/* rewrites windows of adjacent instructions, and the */
+/* references to code locations are moved with them */
+
+#include "globals.h"
+#include "code.h"
+#include "peephole.h"
+
+/* passes over the code, bounding chains of jump rewrites */
+#define MAXPASSES 16
+
+static TmInstr *buf;
+static int ninstr;
+
+/* the instruction every jump or pc-relative reference
+ * refers to, -1 if none; label marks the instructions
+ * that are referred to, and dead the removed ones
+ */
+static int *target;
+static int *label;
+static int *dead;
+
+/* code locations kept by the caller */
+static int *keptLoc;
+static int nkept;
+
+/* Function isRef returns TRUE if i refers to a code location
+ * of this unit
+ */
+static int isRef(TmInstr *i) {
+	if (i->op == opLDC) return i->r == pc && i->reloc != RelImport;
+	return i->op > opRRLim && i->s == pc;
+}
+
+static int isJump(TmInstr *i) {
+	return i->op == opLDA && i->r == pc && i->s == pc;
+}
+
+static int isCondJump(TmInstr *i) {
+	return i->op >= opJLT && i->op <= opJNE && i->s == pc;
+}
+
+/* Function endsFlow returns TRUE if control never falls
+ * through i to the next instruction
+ */
+static int endsFlow(TmInstr *i) {
+	return i->op == opHALT || ((i->op == opLD || i->op == opLDA || i->op == opLDC) && i->r == pc);
+}
+
+static int sameSlot(TmInstr *a, TmInstr *b) {
+	return a->r == b->r && a->d == b->d && a->s == b->s && a->s != pc;
+}
+
+/* Function next returns the first live instruction after i */
+static int next(int i) {
+	for (++i; i < ninstr && dead[i]; ++i);
+	return i;
+}
+
+/* Function resolve returns the live instruction control
+ * reaches at location t
+ */
+static int resolve(int t) {
+	return t < ninstr && dead[t] ? next(t) : t;
+}
+
+static void retarget(int i, int t) {
+	target[i] = t;
+	label[resolve(t)] = TRUE;
+}
+
+static void markLabels(void) {
+	int k;
+
+	memset(label, 0, (ninstr + 1) * sizeof(int));
+	label[0] = TRUE;
+	for (k = 0; k < nkept; ++k) label[keptLoc[k]] = TRUE;
+	for (k = 0; k < ninstr; ++k)
+		if (target[k] >= 0) label[target[k]] = TRUE;
+}
+
+/* the patterns: each one looks at the window starting at
+ * the live instruction i and returns TRUE if it rewrote it
+ */
+
+/* ST r,d(s) ; LD r,d(s) keeps r */
+static int storeReload(int i) {
+	int j = next(i);
+
+	if (j >= ninstr || label[j] || buf[i].op != opST || buf[j].op != opLD) return FALSE;
+	if (!sameSlot(&buf[i], &buf[j])) return FALSE;
+	dead[j] = TRUE;
+	return TRUE;
+}
+
+/* LD r,d(s) ; ST r,d(s) stores what is there */
+static int loadStore(int i) {
+	int j = next(i);
+
+	if (j >= ninstr || label[j] || buf[i].op != opLD || buf[j].op != opST) return FALSE;
+	if (!sameSlot(&buf[i], &buf[j]) || buf[i].r == buf[i].s) return FALSE;
+	dead[j] = TRUE;
+	return TRUE;
+}
+
+/* LD r,d(s) ; LD r,d(s) loads the same value twice */
+static int reload(int i) {
+	int j = next(i);
+
+	if (j >= ninstr || label[j] || buf[i].op != opLD || buf[j].op != opLD) return FALSE;
+	if (!sameSlot(&buf[i], &buf[j]) || buf[i].r == buf[i].s) return FALSE;
+	dead[j] = TRUE;
+	return TRUE;
+}
+
+/* a jump to the next instruction does nothing */
+static int jumpNext(int i) {
+	if (!isJump(&buf[i]) && !isCondJump(&buf[i])) return FALSE;
+	if (resolve(target[i]) != next(i)) return FALSE;
+	dead[i] = TRUE;
+	return TRUE;
+}
+
+/* a jump to an unconditional jump goes to its target */
+static int jumpChain(int i) {
+	int t;
+
+	if (!isJump(&buf[i]) && !isCondJump(&buf[i])) return FALSE;
+	t = resolve(target[i]);
+	if (t >= ninstr || !isJump(&buf[t])) return FALSE;
+	if (resolve(target[t]) == t) return FALSE;
+	retarget(i, target[t]);
+	return TRUE;
+}
+
+/* Jcc r,L1 ; LDA pc,L2 ; L1: becomes Jnotcc r,L2 */
+static int branchOver(int i) {
+	int j = next(i);
+
+	if (!isCondJump(&buf[i]) || j >= ninstr || label[j] || !isJump(&buf[j])) return FALSE;
+	if (resolve(target[i]) != next(j) || resolve(target[j]) == j) return FALSE;
+	switch (buf[i].op) {
+		case opJLT: buf[i].op = opJGE; break;
+		case opJLE: buf[i].op = opJGT; break;
+		case opJGT: buf[i].op = opJLE; break;
+		case opJGE: buf[i].op = opJLT; break;
+		case opJEQ: buf[i].op = opJNE; break;
+		default: buf[i].op = opJEQ; break;
+	}
+	retarget(i, target[j]);
+	dead[j] = TRUE;
+	return TRUE;
+}
+
+/* code after a jump that nothing refers to is never run */
+static int unreachable(int i) {
+	int j = next(i);
+
+	if (!endsFlow(&buf[i]) || j >= ninstr || label[j]) return FALSE;
+	dead[j] = TRUE;
+	return TRUE;
+}
+
+typedef struct {
+	char *name;
+	int (*rewrite)(int);
+	int count;		/* windows rewritten */
+} Pattern;
+
+static Pattern patterns[] = {
+	{ "store-reload", storeReload, 0 },
+	{ "load-store", loadStore, 0 },
+	{ "reload", reload, 0 },
+	{ "jump-next", jumpNext, 0 },
+	{ "jump-chain", jumpChain, 0 },
+	{ "branch-over", branchOver, 0 },
+	{ "unreachable", unreachable, 0 }
+};
+
+#define NPATTERNS ((int)(sizeof(patterns) / sizeof(patterns[0])))
+
+/* Function join returns the concatenation of the comment
+ * lines a and b, freeing both
+ */
+static char *join(char *a, char *b) {
+	char *s;
+
+	if (a == NULL) return b;
+	if (b == NULL) return a;
+	s = (char *)malloc(strlen(a) + strlen(b) + 1);
+	strcpy(s, a);
+	strcat(s, b);
+	free(a);
+	free(b);
+	return s;
+}
+
+/* Function compact drops the dead instructions, moving their
+ * comments to the next one and the references to the new
+ * locations, and returns the number of instructions left
+ */
+static int compact(void) {
+	int *newLoc = (int *)malloc((ninstr + 1) * sizeof(int));
+	char *pending = NULL;
+	int k, m = 0;
+
+	for (k = 0; k <= ninstr; ++k) {
+		newLoc[k] = m;
+		if (k < ninstr && dead[k]) {
+			pending = join(pending, buf[k].before);
+			free(buf[k].comment);
+			buf[k].op = -1;
+			buf[k].comment = buf[k].before = NULL;
+			dead[k] = FALSE;
+			continue;
+		}
+		buf[k].before = join(pending, buf[k].before);
+		pending = NULL;
+		if (m != k) {
+			buf[m] = buf[k];
+			target[m] = target[k];
+			buf[k].op = -1;
+			buf[k].comment = buf[k].before = NULL;
+		}
+		m++;
+	}
+	for (k = 0; k < m - 1; ++k)
+		if (target[k] >= 0) target[k] = newLoc[target[k]];
+	target[m - 1] = -1;
+	for (k = 0; k < nkept; ++k) keptLoc[k] = newLoc[keptLoc[k]];
+	free(newLoc);
+	return m - 1;
+}
+
+int peephole(TmInstr *instrs, int n, int *locs, int nlocs) {
+	int k, p, pass, changed;
+
+	buf = instrs;
+	ninstr = n;
+	keptLoc = locs;
+	nkept = nlocs;
+	target = (int *)malloc((n + 1) * sizeof(int));
+	label = (int *)malloc((n + 1) * sizeof(int));
+	dead = (int *)calloc(n + 1, sizeof(int));
+	for (k = 0; k <= n; ++k) {
+		target[k] = -1;
+		if (k == n || buf[k].op < 0 || !isRef(&buf[k])) continue;
+		target[k] = buf[k].op == opLDC ? buf[k].d : k + 1 + buf[k].d;
+		if (target[k] < 0 || target[k] > n) target[k] = -1;
+	}
+	for (p = 0; p < NPATTERNS; ++p) patterns[p].count = 0;
+
+	for (pass = 0, changed = TRUE; changed && pass < MAXPASSES; ++pass) {
+		changed = FALSE;
+		markLabels();
+		for (k = 0; k < ninstr; ++k)
+			for (p = 0; p < NPATTERNS && !dead[k]; ++p)
+				if (patterns[p].rewrite(k)) {
+					patterns[p].count++;
+					changed = TRUE;
+				}
+		ninstr = compact();
+	}
+
+	/* back from locations to displacements */
+	for (k = 0; k < ninstr; ++k)
+		if (target[k] >= 0)
+			buf[k].d = buf[k].op == opLDC ? target[k] : target[k] - (k + 1);
+
+	if (TraceOptimize) {
+		for (p = 0; p < NPATTERNS; ++p)
+			if (patterns[p].count > 0)
+				fprintf(listing, "PEEPHOLE %-12s %4d windows\n", patterns[p].name, patterns[p].count);
+		fprintf(listing, "PEEPHOLE: %d -> %d TM instructions\n", n, ninstr);
+	}
+	free(target);
+	free(label);
+	free(dead);
+	return ninstr;
+}
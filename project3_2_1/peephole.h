@@ -0,0 +1,18 @@
+/* FILE: peephole.h */
+/* Peephole optimization of the buffered TM code */
+
+#ifndef _PEEPHOLE_H_
+#define _PEEPHOLE_H_
+
+#include "code.h"
+
+/* Function peephole rewrites the n instructions of instrs in
+ * place and returns the number left; instrs[n] holds the
+ * comments after the last instruction, and the nlocs code
+ * locations of locs move with the code.  The rewritten
+ * windows of every pattern are reported to the listing
+ * file when TraceOptimize is set
+ */
+int peephole(TmInstr *instrs, int n, int *locs, int nlocs);
+
+#endif
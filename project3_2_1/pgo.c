@@ -0,0 +1,140 @@
+/* FILE: pgo.c */
+/* Profile-guided optimization: the counts of a profile are */
+/* kept in a hash table by kind, function, line and ordinal */
+
+#include "globals.h"
+#include "util.h"
+#include "ir.h"
+#include "pgo.h"
+
+#define SIZE 211
+#define SHIFT 4
+
+/* the headings of the sections of a report, as the runtimes
+ * print them, in the order of CountKind
+ */
+static char *heading[][2] = {
+	{ "calls", "function" }, { "iterations", "loop" }, { "then", "if" }, { "else", "if" }
+};
+
+typedef struct CountRec {
+	CountKind kind;
+	char *name;
+	int line, ordinal;
+	long count;
+	struct CountRec *next;
+} * Count;
+
+static Count table[SIZE];
+static long maxCalls = 0;
+
+static int hash(char *name, int line, int ordinal) {
+	int h = line * 31 + ordinal;
+
+	for (; *name != '\0'; ++name) h = ((h << SHIFT) + *name) % SIZE;
+	return (h % SIZE + SIZE) % SIZE;
+}
+
+static Count lookup(CountKind kind, char *name, int line, int ordinal) {
+	Count c = table[hash(name, line, ordinal)];
+
+	while (c != NULL && (c->kind != kind || c->line != line || c->ordinal != ordinal || strcmp(c->name, name)))
+		c = c->next;
+	return c;
+}
+
+static void add(CountKind kind, char *name, int line, int ordinal, long n) {
+	Count c = lookup(kind, name, line, ordinal);
+
+	if (c == NULL) {
+		int h = hash(name, line, ordinal);
+
+		c = (Count)calloc(1, sizeof(struct CountRec));
+		c->kind = kind;
+		c->name = copyString(name);
+		c->line = line;
+		c->ordinal = ordinal;
+		c->next = table[h];
+		table[h] = c;
+	}
+	c->count += n;
+	if (kind == CountCalls && c->count > maxCalls) maxCalls = c->count;
+}
+
+int readProfile(char *file) {
+	FILE *f = fopen(file, "r");
+	char text[1024], first[1024], second[1024], *colon, *dot;
+	int kind = -1, k, line, ordinal;
+	long n;
+
+	if (f == NULL) return FALSE;
+	while (fgets(text, sizeof(text), f) != NULL) {
+		if (sscanf(text, "%ld %1023s", &n, first) == 2) {
+			if (kind < 0) continue;
+			line = ordinal = 0;
+			colon = strrchr(first, ':');
+			if (kind != CountCalls) {
+				/* name:line for the first loop or if on the line,
+				 * name:line.ordinal for the others
+				 */
+				if (colon == NULL || (line = atoi(colon + 1)) <= 0) continue;
+				ordinal = (dot = strchr(colon, '.')) != NULL ? atoi(dot + 1) : 1;
+				if (ordinal <= 0) continue;
+				*colon = '\0';
+			}
+			add((CountKind)kind, first, line, ordinal, n);
+		}
+		else if (sscanf(text, "%1023s %1023s", first, second) == 2) {
+			/* a heading starts a section; anything else ends it */
+			kind = -1;
+			for (k = 0; k < 4; ++k)
+				if (!strcmp(first, heading[k][0]) && !strcmp(second, heading[k][1])) kind = k;
+		}
+		else kind = -1;
+	}
+	fclose(f);
+	return TRUE;
+}
+
+long profileCount(CountKind kind, char *name, int line, int ordinal) {
+	Count c = lookup(kind, name, line, ordinal);
+
+	return c == NULL ? -1 : c->count;
+}
+
+int inlineLimit(char *callee, int limit) {
+	long calls = profileCount(CountCalls, callee, 0, 0);
+
+	if (calls == 0) return 0;
+	if (calls > 0 && calls * 16 >= maxCalls) return 4 * limit;
+	return limit;
+}
+
+int coldSide(char *name, int line, int ordinal) {
+	long then = profileCount(CountThen, name, line, ordinal);
+	long other = profileCount(CountElse, name, line, ordinal);
+
+	if (then < 0 || other < 0 || then == other) return -1;
+	return then < other ? CountThen : CountElse;
+}
+
+int layoutBlocks(IrFunc f) {
+	IrBlock b, prev = NULL, cold = NULL, lastCold = NULL;
+	int moved = 0;
+
+	/* the entry stays first */
+	for (b = f->entry; b != NULL; b = b->next) {
+		if (!b->cold || b == f->entry) {
+			if (prev != NULL) prev->next = b;
+			prev = b;
+			continue;
+		}
+		if (lastCold == NULL) cold = b;
+		else lastCold->next = b;
+		lastCold = b;
+		moved++;
+	}
+	if (lastCold != NULL) lastCold->next = NULL;
+	prev->next = cold;
+	return moved;
+}
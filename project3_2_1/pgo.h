@@ -0,0 +1,43 @@
+/* FILE: pgo.h */
+/* Profile-guided optimization of the C-Minus compiler: */
+/* the counts a program compiled with -profile reports */
+/* steer the inliner and the layout of the blocks */
+
+#ifndef _PGO_H_
+#define _PGO_H_
+
+#include "ir.h"
+
+/* Function readProfile reads a file of the reports that runs
+ * of a program compiled with -profile wrote to stderr, summing
+ * the counts of as many runs as it holds; lines of anything
+ * else are skipped.  It returns FALSE if the file cannot be read
+ */
+int readProfile(char *file);
+
+/* Function profileCount returns the count of kind for function
+ * name and the line and ordinal of a loop or if, 0 and 0 for
+ * the calls, or -1 if the profile has none
+ */
+long profileCount(CountKind kind, char *name, int line, int ordinal);
+
+/* Function inlineLimit returns the largest size of callee to
+ * inline given limit: 0 for a function that was never called
+ * and four times limit for a hot one, which was called at
+ * least a sixteenth as often as the most called one
+ */
+int inlineLimit(char *callee, int limit);
+
+/* Function coldSide returns CountThen or CountElse, the side
+ * of the if at line and ordinal of function name that ran less
+ * often, or -1 if the profile does not tell
+ */
+int coldSide(char *name, int line, int ordinal);
+
+/* Function layoutBlocks moves the cold blocks of f after all
+ * the others, so the hot path of every if falls through; it
+ * returns the number of blocks moved
+ */
+int layoutBlocks(IrFunc f);
+
+#endif
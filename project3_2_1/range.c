@@ -0,0 +1,222 @@
+/* FILE: range.c */
+/* Value range analysis and bounds check elimination */
+
+#include <limits.h>
+#include "globals.h"
+#include "ir.h"
+#include "ssa.h"
+#include "opt.h"
+
+/* how far up the dominator tree conditions are looked for */
+#define MAXDEPTH 32
+
+/* the changes of a phi before its range is widened */
+#define WIDEN 3
+
+/* the range of every register, empty (lo > hi) while no
+ * definition of it has been seen; bounds are kept within
+ * int, and an operation that may wrap gives the full range
+ */
+static long *lo, *hi;
+static int *changes;
+static IrInstr *def;
+
+static int fits(long l, long h) {
+	return l >= INT_MIN && h <= INT_MAX;
+}
+
+/* Procedure refine narrows [*l, *h], the range of register r,
+ * by what holds of r on entry to block b: the conditions of the
+ * branches the dominators of b are reached from and, when at is
+ * not NULL, the checks on r that run before instruction at of b
+ */
+static void refine(int r, IrBlock b, IrInstr at, long *l, long *h) {
+	IrBlock p;
+	IrInstr i, c;
+	IrOp op;
+	int depth, y;
+
+	for (depth = 0; b != NULL && depth < MAXDEPTH; ++depth, b = b->idom) {
+		if (at != NULL) {
+			for (i = at->block == b ? at->prev : b->last; i != NULL; i = i->prev)
+				if (i->op == IrCheck && i->src[0] == r) {
+					if (*l < 0) *l = 0;
+					if (*h > i->imm - 1) *h = i->imm - 1;
+				}
+		}
+		if (b->npred != 1 || (p = b->pred[0])->last == NULL || p->last->op != IrBranch) continue;
+		if (p->succ[0] == p->succ[1] || (c = def[p->last->src[0]]) == NULL) continue;
+		if (c->op < IrLt || c->op > IrNe) continue;
+		op = c->op;
+		if (c->src[0] == r) y = c->src[1];
+		else if (c->src[1] == r) {
+			y = c->src[0];
+			op = op == IrLt ? IrGt : op == IrLe ? IrGe : op == IrGt ? IrLt : op == IrGe ? IrLe : op;
+		}
+		else continue;
+		if (lo[y] > hi[y]) continue;
+		if (b == p->succ[1]) {
+			/* the condition is false on this side */
+			switch (op) {
+				case IrLt: op = IrGe; break;
+				case IrLe: op = IrGt; break;
+				case IrGt: op = IrLe; break;
+				case IrGe: op = IrLt; break;
+				case IrEq: op = IrNe; break;
+				default: op = IrEq; break;
+			}
+		}
+		switch (op) {
+			case IrLt: if (*h > hi[y] - 1) *h = hi[y] - 1; break;
+			case IrLe: if (*h > hi[y]) *h = hi[y]; break;
+			case IrGt: if (*l < lo[y] + 1) *l = lo[y] + 1; break;
+			case IrGe: if (*l < lo[y]) *l = lo[y]; break;
+			case IrEq:
+				if (*l < lo[y]) *l = lo[y];
+				if (*h > hi[y]) *h = hi[y];
+				break;
+			default:
+				if (lo[y] == hi[y] && *l == lo[y]) (*l)++;
+				if (lo[y] == hi[y] && *h == hi[y]) (*h)--;
+				break;
+		}
+	}
+}
+
+/* Procedure rangeAt gives the range of register r in block b */
+
+static void rangeAt(int r, IrBlock b, long *l, long *h) {
+	*l = lo[r];
+	*h = hi[r];
+	if (*l <= *h) refine(r, b, NULL, l, h);
+}
+
+/* Function evaluate computes the range of the result of i from
+ * those of its operands and returns TRUE if it changed
+ */
+static int evaluate(IrInstr i) {
+	long l = INT_MIN, h = INT_MAX, l1, h1, l2, h2;
+	int k;
+
+	switch (i->op) {
+		case IrConst:
+			l = h = i->imm;
+			break;
+		case IrCopy:
+			rangeAt(i->src[0], i->block, &l, &h);
+			break;
+		case IrAdd: case IrSub: case IrMul: case IrDiv:
+			rangeAt(i->src[0], i->block, &l1, &h1);
+			rangeAt(i->src[1], i->block, &l2, &h2);
+			if (l1 > h1 || l2 > h2) {
+				l = 1;
+				h = 0;
+			}
+			else if (i->op == IrAdd && fits(l1 + l2, h1 + h2)) {
+				l = l1 + l2;
+				h = h1 + h2;
+			}
+			else if (i->op == IrSub && fits(l1 - h2, h1 - l2)) {
+				l = l1 - h2;
+				h = h1 - l2;
+			}
+			else if (i->op == IrMul && l1 >= 0 && l2 >= 0 && fits(l1 * l2, h1 * h2)) {
+				l = l1 * l2;
+				h = h1 * h2;
+			}
+			else if (i->op == IrDiv && l1 >= 0 && l2 > 0) {
+				l = l1 / h2;
+				h = h1 / l2;
+			}
+			break;
+		case IrLt: case IrLe: case IrGt: case IrGe: case IrEq: case IrNe:
+			l = 0;
+			h = 1;
+			break;
+		case IrPhi:
+			l = 1;
+			h = 0;
+			for (k = 0; k < i->nargs; ++k) {
+				/* as it leaves the predecessor */
+				rangeAt(i->args[k], i->block->pred[k], &l1, &h1);
+				if (l1 > h1) continue;
+				if (l > h) {
+					l = l1;
+					h = h1;
+				}
+				if (l1 < l) l = l1;
+				if (h1 > h) h = h1;
+			}
+			break;
+		default:
+			break;
+	}
+	if (l == lo[i->dst] && h == hi[i->dst]) return FALSE;
+	if (i->op == IrPhi && lo[i->dst] <= hi[i->dst] && ++changes[i->dst] > WIDEN) {
+		/* a loop counting up or down: give up the bound that moves */
+		if (l < lo[i->dst]) l = INT_MIN;
+		else l = lo[i->dst];
+		if (h > hi[i->dst]) h = INT_MAX;
+		else h = hi[i->dst];
+		if (l == lo[i->dst] && h == hi[i->dst]) return FALSE;
+	}
+	lo[i->dst] = l;
+	hi[i->dst] = h;
+	return TRUE;
+}
+
+int elideBoundsChecks(IrFunc f, int *checks) {
+	IrBlock b;
+	IrInstr i, next;
+	long l, h;
+	int k, changed, elided = 0;
+
+	*checks = 0;
+	lo = (long *)malloc(f->nregs * sizeof(long));
+	hi = (long *)malloc(f->nregs * sizeof(long));
+	changes = (int *)calloc(f->nregs, sizeof(int));
+	def = (IrInstr *)calloc(f->nregs, sizeof(IrInstr));
+	for (k = 0; k < f->nregs; ++k) {
+		lo[k] = 1;
+		hi[k] = 0;
+	}
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) {
+			if (i->dst >= 0) def[i->dst] = i;
+			if (i->op == IrCheck) (*checks)++;
+		}
+	/* parameters, and locals read before they are set, may
+	 * hold anything
+	 */
+	for (k = 0; k < f->nregs; ++k)
+		if (def[k] == NULL) {
+			lo[k] = INT_MIN;
+			hi[k] = INT_MAX;
+		}
+	if (*checks == 0) changed = FALSE;
+	else do {
+		changed = FALSE;
+		for (k = 0; k < f->nrpo; ++k)
+			for (i = f->rpoOrder[k]->first; i != NULL; i = i->next)
+				if (i->dst >= 0 && evaluate(i)) changed = TRUE;
+	} while (changed);
+
+	for (k = 0; k < f->nrpo && *checks > 0; ++k)
+		for (i = f->rpoOrder[k]->first; i != NULL; i = next) {
+			next = i->next;
+			if (i->op != IrCheck) continue;
+			l = lo[i->src[0]];
+			h = hi[i->src[0]];
+			if (l <= h) refine(i->src[0], i->block, i, &l, &h);
+			if (l <= h && l >= 0 && h < i->imm) {
+				removeInstr(i);
+				free(i);
+				elided++;
+			}
+		}
+	free(lo);
+	free(hi);
+	free(changes);
+	free(def);
+	return elided;
+}
@@ -11,8 +11,29 @@
 
 extern char tokenString[MAXTOKENLEN + 1];
 
+/* tokenValue is the value of the last NUM token and tokenName
+ * the name of the last ID token, interned by internString
+ */
+
+extern int tokenValue;
+extern char *tokenName;
+
+/* tokenCount is the number of tokens getToken returned */
+
+extern long tokenCount;
+
 /* function getToken returns the next token in source file */
 
 TokenType getToken(void);
 
+/* Procedure scanText makes getToken read the string text
+ * instead of the source file, counting lines from line
+ */
+void scanText(char *text, int line);
+
+/* Procedure scanSource makes getToken read the source file
+ * from its start again
+ */
+void scanSource(void);
+
 #endif
@@ -0,0 +1,530 @@
+/* FILE: server.c */
+/* Compile server of the C-Minus compiler: JSON requests */
+/* over stdin or a Unix socket are answered from the state */
+/* the compiler keeps between them, the declarations of the */
+/* last document, the symbol tables and the tree nodes */
+
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "symtab.h"
+#include "incr.h"
+#include "server.h"
+
+#define MAXMEMBERS 16
+
+/* the members of the request object: value is the decoded
+ * string, or the text of any other value
+ */
+typedef struct {
+	char *key;
+	char *value;
+	int isString;
+} Member;
+
+static Member members[MAXMEMBERS];
+static int nmembers = 0;
+
+/* the path of the document incr.c keeps */
+static char *document = NULL;
+
+/* the output of compile requests */
+static int captureFd = -1;
+
+/* the tracing flags the compiler started with, for compile
+ * requests to list as a compilation would
+ */
+static int echoSource, traceParse, traceAnalyze, traceOptimize;
+
+/* latencies of the requests answered, in microseconds */
+static long *latency = NULL;
+static int nlatency = 0, latencyCap = 0;
+
+static long microseconds(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+static void skipSpace(char **p) {
+	while (isspace((unsigned char)**p)) (*p)++;
+}
+
+static int hexValue(char c) {
+	return isdigit((unsigned char)c) ? c - '0' : tolower((unsigned char)c) - 'a' + 10;
+}
+
+/* Function hex4 returns the value of the four hex digits at
+ * s, -1 if there are not four
+ */
+static long hex4(char *s) {
+	long c = 0;
+	int k;
+
+	for (k = 0; k < 4; ++k) {
+		if (!isxdigit((unsigned char)s[k])) return -1;
+		c = 16 * c + hexValue(s[k]);
+	}
+	return c;
+}
+
+/* Function parseString decodes the JSON string at *p and
+ * leaves *p after it; it returns NULL for a \u escape that
+ * is not four hex digits, a lone surrogate or a NUL
+ */
+static char *parseString(char **p) {
+	char *s = *p + 1;
+	char *out = (char *)malloc(strlen(s) + 1), *o = out;
+	long c, low;
+
+	while (*s != '\0' && *s != '"') {
+		if (*s != '\\' || s[1] == '\0') {
+			*o++ = *s++;
+			continue;
+		}
+		switch (*++s) {
+			case 'n': *o++ = '\n'; break;
+			case 't': *o++ = '\t'; break;
+			case 'r': *o++ = '\r'; break;
+			case 'b': *o++ = '\b'; break;
+			case 'f': *o++ = '\f'; break;
+			case 'u':
+				if ((c = hex4(s + 1)) <= 0 || (c >= 0xDC00 && c <= 0xDFFF)) {
+					free(out);
+					return NULL;
+				}
+				s += 4;
+				if (c >= 0xD800 && c <= 0xDBFF) {
+					/* a high surrogate needs the low one after it */
+					if (s[1] != '\\' || s[2] != 'u' || (low = hex4(s + 3)) < 0xDC00 || low > 0xDFFF) {
+						free(out);
+						return NULL;
+					}
+					s += 6;
+					c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				}
+				if (c < 0x80) *o++ = c;
+				else if (c < 0x800) {
+					*o++ = 0xC0 | (c >> 6);
+					*o++ = 0x80 | (c & 0x3F);
+				}
+				else if (c < 0x10000) {
+					*o++ = 0xE0 | (c >> 12);
+					*o++ = 0x80 | ((c >> 6) & 0x3F);
+					*o++ = 0x80 | (c & 0x3F);
+				}
+				else {
+					*o++ = 0xF0 | (c >> 18);
+					*o++ = 0x80 | ((c >> 12) & 0x3F);
+					*o++ = 0x80 | ((c >> 6) & 0x3F);
+					*o++ = 0x80 | (c & 0x3F);
+				}
+				break;
+			default: *o++ = *s; break;
+		}
+		s++;
+	}
+	*o = '\0';
+	*p = *s != '\0' ? s + 1 : s;
+	return out;
+}
+
+/* Procedure skipValue moves *p past a value other than a
+ * string, nested objects and arrays included
+ */
+static void skipValue(char **p) {
+	char *s = *p;
+	int depth = 0;
+
+	while (*s != '\0') {
+		if (*s == '"') {
+			char *string = parseString(&s);
+
+			if (string == NULL) {
+				/* the caller finds no end to the value */
+				s += strlen(s);
+				break;
+			}
+			free(string);
+			continue;
+		}
+		if (*s == '{' || *s == '[') depth++;
+		else if (*s == '}' || *s == ']') {
+			if (depth == 0) break;
+			depth--;
+		}
+		else if (*s == ',' && depth == 0) break;
+		s++;
+	}
+	*p = s;
+}
+
+static void clearMembers(void) {
+	int k;
+
+	for (k = 0; k < nmembers; ++k) {
+		free(members[k].key);
+		free(members[k].value);
+	}
+	nmembers = 0;
+}
+
+/* Function parseRequest reads the members of the object on
+ * line, returning FALSE if it is not one
+ */
+static int parseRequest(char *line) {
+	char *p = line, *start, *key, *value;
+	int isString;
+
+	clearMembers();
+	skipSpace(&p);
+	if (*p++ != '{') return FALSE;
+	for (;;) {
+		skipSpace(&p);
+		if (*p == '}') return TRUE;
+		if (*p != '"') return FALSE;
+		if ((key = parseString(&p)) == NULL) return FALSE;
+		skipSpace(&p);
+		if (*p++ != ':') {
+			free(key);
+			return FALSE;
+		}
+		skipSpace(&p);
+		if ((isString = *p == '"')) {
+			if ((value = parseString(&p)) == NULL) {
+				free(key);
+				return FALSE;
+			}
+		}
+		else {
+			start = p;
+			skipValue(&p);
+			while (p > start && isspace((unsigned char)p[-1])) p--;
+			value = (char *)malloc(p - start + 1);
+			memcpy(value, start, p - start);
+			value[p - start] = '\0';
+			skipSpace(&p);
+		}
+		if (nmembers < MAXMEMBERS) {
+			members[nmembers].key = key;
+			members[nmembers].value = value;
+			members[nmembers++].isString = isString;
+		}
+		else {
+			free(key);
+			free(value);
+		}
+		skipSpace(&p);
+		if (*p == ',') p++;
+		else if (*p != '}') return FALSE;
+	}
+}
+
+static Member *member(char *key) {
+	int k;
+
+	for (k = 0; k < nmembers; ++k)
+		if (!strcmp(members[k].key, key)) return &members[k];
+	return NULL;
+}
+
+static void putString(FILE *out, char *s) {
+	fputc('"', out);
+	for (; *s != '\0'; ++s) {
+		unsigned char c = *s;
+
+		if (c == '"' || c == '\\') fprintf(out, "\\%c", c);
+		else if (c == '\n') fputs("\\n", out);
+		else if (c == '\t') fputs("\\t", out);
+		else if (c < 0x20) fprintf(out, "\\u%04x", c);
+		else fputc(c, out);
+	}
+	fputc('"', out);
+}
+
+/* Procedure beginReply starts the answer with the id of the
+ * request
+ */
+static void beginReply(FILE *out) {
+	Member *id = member("id");
+
+	fputs("{\"id\":", out);
+	if (id == NULL) fputs("null", out);
+	else if (id->isString) putString(out, id->value);
+	else fputs(id->value, out);
+}
+
+static void replyError(FILE *out, char *message) {
+	beginReply(out);
+	fputs(",\"error\":", out);
+	putString(out, message);
+	fputs("}\n", out);
+}
+
+/* the reply being written by the callbacks of incr.c */
+static FILE *reply;
+static int firstItem;
+
+static void replyDiagnostic(int line, char *message) {
+	fprintf(reply, "%s{\"line\":%d,\"message\":", firstItem ? "" : ",", line);
+	putString(reply, message);
+	fputc('}', reply);
+	firstItem = FALSE;
+}
+
+static void replySymbol(TreeNode *t) {
+	char *kind;
+
+	switch (t->kind.decl) {
+		case FuncK: kind = "function"; break;
+		case VarArrK: kind = "array"; break;
+		case VarK: kind = "variable"; break;
+		default: return;
+	}
+	fprintf(reply, "%s{\"name\":", firstItem ? "" : ",");
+	putString(reply, t->child[1]->attr.name);
+	fprintf(reply, ",\"kind\":\"%s\",\"type\":\"%s\",\"line\":%d", kind,
+		t->child[0]->type == Void ? "void" : "int", t->child[1]->lineno);
+	if (t->kind.decl == VarArrK) fprintf(reply, ",\"size\":%d", t->child[4]->attr.val);
+	if (t->kind.decl == FuncK) fprintf(reply, ",\"defined\":%s", t->child[3] != NULL ? "true" : "false");
+	fputc('}', reply);
+	firstItem = FALSE;
+}
+
+static void check(FILE *out, long start) {
+	Member *path = member("path"), *text = member("text");
+	char *name, *source;
+	int errors, parsed, checked;
+
+	if (path == NULL && text == NULL) {
+		replyError(out, "check needs a path or a text");
+		return;
+	}
+	name = path != NULL ? path->value : "-";
+	if (document == NULL || strcmp(document, name)) {
+		/* another document: drop the declarations kept, then
+		 * the symbols and the names they all point to
+		 */
+		incrReset();
+		init();
+		internReset();
+		free(document);
+		document = copyString(name);
+	}
+	source = text != NULL ? copyString(text->value) : readFile(name);
+	if (source == NULL) {
+		replyError(out, "cannot read the file");
+		return;
+	}
+	errors = incrUpdate(source, &parsed, &checked);
+	free(source);
+	beginReply(out);
+	fprintf(out, ",\"errors\":%d,\"declarations\":%d,\"parsed\":%d,\"checked\":%d,\"diagnostics\":[",
+		errors, incrDeclarations(), parsed, checked);
+	reply = out;
+	firstItem = TRUE;
+	incrDiagnostics(replyDiagnostic);
+	fputs("],\"symbols\":[", out);
+	firstItem = TRUE;
+	incrSymbols(replySymbol);
+	fprintf(out, "],\"us\":%ld}\n", microseconds() - start);
+}
+
+/* Function compile forks a child that returns the path of
+ * the source to compile; the server waits for it and
+ * answers its exit status and output
+ */
+static char *compile(FILE *out, long start, int (*setOption)(char *)) {
+	Member *path = member("path"), *options = member("options");
+	char *output, *opt;
+	off_t n;
+	int status;
+	pid_t pid;
+
+	if (path == NULL) {
+		replyError(out, "compile needs a path");
+		return NULL;
+	}
+	if (ftruncate(captureFd, 0) != 0 || lseek(captureFd, 0, SEEK_SET) != 0) {
+		replyError(out, "cannot capture the output");
+		return NULL;
+	}
+	fflush(NULL);
+	if ((pid = fork()) < 0) {
+		replyError(out, "cannot fork");
+		return NULL;
+	}
+	if (pid == 0) {
+		dup2(captureFd, 1);
+		dup2(captureFd, 2);
+		EchoSource = echoSource;
+		TraceParse = traceParse;
+		TraceAnalyze = traceAnalyze;
+		TraceOptimize = traceOptimize;
+		if (options != NULL)
+			for (opt = strtok(options->value, " \t"); opt != NULL; opt = strtok(NULL, " \t"))
+				if (!setOption(opt)) {
+					printf("unknown option %s\n", opt);
+					exit(1);
+				}
+		/* the tables and scanner start over for the source */
+		init();
+		scanSource();
+		Error = FALSE;
+		return copyString(path->value);
+	}
+	waitpid(pid, &status, 0);
+	n = lseek(captureFd, 0, SEEK_END);
+	output = (char *)malloc(n + 1);
+	if (pread(captureFd, output, n, 0) != n) n = 0;
+	output[n] = '\0';
+	beginReply(out);
+	fprintf(out, ",\"status\":%d,\"output\":", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+	putString(out, output);
+	fprintf(out, ",\"us\":%ld}\n", microseconds() - start);
+	free(output);
+	return NULL;
+}
+
+static int byValue(const void *a, const void *b) {
+	long x = *(const long *)a, y = *(const long *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Function percentile returns the latency p percent of the
+ * requests answered took at most, by nearest rank
+ */
+static long percentile(long *sorted, int n, int p) {
+	int rank = (p * n + 99) / 100;
+
+	return n > 0 ? sorted[rank > 0 ? rank - 1 : 0] : 0;
+}
+
+static void latencies(FILE *out, char *format) {
+	long *sorted = (long *)malloc((nlatency + 1) * sizeof(long));
+
+	memcpy(sorted, latency, nlatency * sizeof(long));
+	qsort(sorted, nlatency, sizeof(long), byValue);
+	fprintf(out, format, nlatency, percentile(sorted, nlatency, 50), percentile(sorted, nlatency, 90),
+		percentile(sorted, nlatency, 99), nlatency > 0 ? sorted[nlatency - 1] : 0L);
+	free(sorted);
+}
+
+/* Function handle answers one request; it returns the path
+ * to compile in the child of a compile request
+ */
+static char *handle(char *line, FILE *out, int *stop, int (*setOption)(char *)) {
+	long start = microseconds();
+	Member *method;
+	char *file = NULL;
+
+	if (!parseRequest(line)) {
+		clearMembers();
+		replyError(out, "bad request");
+		return NULL;
+	}
+	if ((method = member("method")) == NULL) replyError(out, "no method");
+	else if (!strcmp(method->value, "check")) check(out, start);
+	else if (!strcmp(method->value, "compile")) file = compile(out, start, setOption);
+	else if (!strcmp(method->value, "stats")) {
+		beginReply(out);
+		latencies(out, ",\"requests\":%d,\"p50\":%ld,\"p90\":%ld,\"p99\":%ld,\"max\":%ld}\n");
+	}
+	else if (!strcmp(method->value, "shutdown")) {
+		beginReply(out);
+		fputs(",\"shutdown\":true}\n", out);
+		*stop = TRUE;
+	}
+	else replyError(out, "unknown method");
+	if (nlatency == latencyCap) {
+		latencyCap = latencyCap > 0 ? 2 * latencyCap : 256;
+		latency = (long *)realloc(latency, latencyCap * sizeof(long));
+	}
+	latency[nlatency++] = microseconds() - start;
+	return file;
+}
+
+/* Function session answers the requests of in on out until
+ * its end or a shutdown
+ */
+static char *session(FILE *in, FILE *out, int *stop, int (*setOption)(char *)) {
+	char *line = NULL, *file = NULL;
+	size_t cap = 0;
+
+	while (!*stop && getline(&line, &cap, in) > 0) {
+		if ((file = handle(line, out, stop, setOption)) != NULL) break;
+		fflush(out);
+	}
+	free(line);
+	return file;
+}
+
+static int listenOn(char *path) {
+	struct sockaddr_un addr;
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd < 0) return -1;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		close(fd);
+		return -1;
+	}
+	strcpy(addr.sun_path, path);
+	unlink(path);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+char *serve(char *socketPath, int (*setOption)(char *)) {
+	FILE *capture = tmpfile();
+	int stop = FALSE, fd, conn;
+	char *file = NULL;
+
+	if (capture == NULL) {
+		fprintf(stderr, "Unable to capture the output of compilations\n");
+		return NULL;
+	}
+	captureFd = fileno(capture);
+	listing = stdout;
+	echoSource = EchoSource;
+	traceParse = TraceParse;
+	traceAnalyze = TraceAnalyze;
+	traceOptimize = TraceOptimize;
+	EchoSource = TraceScan = TraceParse = TraceAnalyze = TraceOptimize = FALSE;
+	if (socketPath == NULL) file = session(stdin, stdout, &stop, setOption);
+	else if ((fd = listenOn(socketPath)) < 0) {
+		fprintf(stderr, "Unable to listen on %s\n", socketPath);
+		return NULL;
+	}
+	else {
+		while (!stop && file == NULL) {
+			FILE *in, *out;
+
+			if ((conn = accept(fd, NULL, NULL)) < 0) continue;
+			in = fdopen(conn, "r");
+			out = fdopen(dup(conn), "w");
+			file = session(in, out, &stop, setOption);
+			if (file == NULL) {
+				fclose(in);
+				fclose(out);
+			}
+		}
+		if (file == NULL) {
+			close(fd);
+			unlink(socketPath);
+		}
+	}
+	if (file == NULL) latencies(stderr, "SERVER: %d requests, p50 %ld us, p90 %ld us, p99 %ld us, max %ld us\n");
+	return file;
+}
@@ -0,0 +1,27 @@
+/* FILE: server.h */
+/* Compile server of the C-Minus compiler */
+
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+/* Function serve answers JSON requests, one per line, read
+ * from stdin or, if socketPath is not NULL, from connections
+ * to a Unix socket bound there:
+ *
+ *   {"id":1,"method":"check","path":"f.c","text":"..."}
+ *   {"id":2,"method":"compile","path":"f.c","options":"-O"}
+ *   {"id":3,"method":"stats"}
+ *   {"id":4,"method":"shutdown"}
+ *
+ * check answers the diagnostics and top-level symbols of the
+ * text, or of the file at path without one, keeping the
+ * declarations of the last document checked between requests;
+ * stats answers latency percentiles.  compile continues in a
+ * child process: serve returns the path there, with the
+ * options set by setOption and the output captured, for the
+ * caller to compile as usual.  In the server itself serve
+ * returns NULL at shutdown or the end of stdin
+ */
+char *serve(char *socketPath, int (*setOption)(char *));
+
+#endif
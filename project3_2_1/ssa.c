@@ -0,0 +1,370 @@
+/* FILE: ssa.c */
+/* Dominator tree, SSA construction and destruction */
+
+#include "globals.h"
+#include "ir.h"
+#include "ssa.h"
+
+/* PtrList is a growable array of pointers */
+
+typedef struct {
+	int n;
+	int cap;
+	void **item;
+} PtrList;
+
+static void listPush(PtrList *l, void *p) {
+	if (l->n == l->cap) {
+		l->cap = l->cap == 0 ? 4 : l->cap * 2;
+		l->item = (void **)realloc(l->item, l->cap * sizeof(void *));
+	}
+	l->item[l->n++] = p;
+}
+
+/* Function postorder returns the blocks reachable from the entry in postorder */
+static IrBlock *postorder(IrFunc f, int *count) {
+	IrBlock *order = (IrBlock *)malloc(f->nblocks * sizeof(IrBlock));
+	IrBlock *stack = (IrBlock *)malloc(f->nblocks * sizeof(IrBlock));
+	int *next = (int *)calloc(f->nblocks, sizeof(int));
+	char *seen = (char *)calloc(f->nblocks, 1);
+	int sp = 0, n = 0;
+
+	stack[sp++] = f->entry;
+	seen[f->entry->id] = 1;
+	while (sp > 0) {
+		IrBlock b = stack[sp - 1];
+
+		if (next[b->id] < b->nsucc) {
+			IrBlock s = b->succ[next[b->id]++];
+			if (!seen[s->id]) {
+				seen[s->id] = 1;
+				stack[sp++] = s;
+			}
+		}
+		else {
+			order[n++] = b;
+			sp--;
+		}
+	}
+	free(stack);
+	free(next);
+	free(seen);
+	*count = n;
+	return order;
+}
+
+static IrBlock intersect(IrBlock a, IrBlock b) {
+	while (a != b) {
+		while (a->rpo > b->rpo) a = a->idom;
+		while (b->rpo > a->rpo) b = b->idom;
+	}
+	return a;
+}
+
+void computeDominators(IrFunc f) {
+	IrBlock b, prev;
+	int n, i, k, changed;
+	IrBlock *order = postorder(f, &n);
+
+	for (b = f->entry; b != NULL; b = b->next) {
+		b->rpo = -1;
+		b->idom = NULL;
+		b->nkids = 0;
+	}
+	free(f->rpoOrder);
+	f->rpoOrder = (IrBlock *)malloc(n * sizeof(IrBlock));
+	for (i = 0; i < n; ++i) {
+		f->rpoOrder[i] = order[n - 1 - i];
+		f->rpoOrder[i]->rpo = i;
+	}
+	free(order);
+	f->nrpo = n;
+
+	/* unlink unreachable blocks */
+	prev = NULL;
+	for (b = f->entry; b != NULL; b = b->next) {
+		if (b->rpo < 0) {
+			for (k = 0; k < b->nsucc; ++k) removePred(b->succ[k], b);
+			b->nsucc = 0;
+			prev->next = b->next;
+		}
+		else prev = b;
+	}
+
+	f->entry->idom = f->entry;
+	do {
+		changed = FALSE;
+		for (i = 1; i < n; ++i) {
+			IrBlock newIdom = NULL;
+
+			b = f->rpoOrder[i];
+			for (k = 0; k < b->npred; ++k) {
+				IrBlock p = b->pred[k];
+				if (p->idom == NULL) continue;
+				newIdom = newIdom == NULL ? p : intersect(p, newIdom);
+			}
+			if (b->idom != newIdom) {
+				b->idom = newIdom;
+				changed = TRUE;
+			}
+		}
+	} while (changed);
+
+	for (i = 1; i < n; ++i) f->rpoOrder[i]->idom->nkids++;
+	for (i = 0; i < n; ++i) {
+		b = f->rpoOrder[i];
+		free(b->kids);
+		b->kids = (IrBlock *)malloc((b->nkids + 1) * sizeof(IrBlock));
+		b->nkids = 0;
+	}
+	for (i = 1; i < n; ++i) {
+		b = f->rpoOrder[i];
+		b->idom->kids[b->idom->nkids++] = b;
+	}
+	f->entry->idom = NULL;
+}
+
+int dominates(IrBlock a, IrBlock b) {
+	while (b != NULL && b->rpo > a->rpo) b = b->idom;
+	return a == b;
+}
+
+/* Procedure dominanceFrontiers fills df[rpo] for every block */
+
+static PtrList *dominanceFrontiers(IrFunc f, int n) {
+	PtrList *df = (PtrList *)calloc(n, sizeof(PtrList));
+	int i, k;
+
+	for (i = 0; i < n; ++i) {
+		IrBlock b = f->rpoOrder[i];
+
+		if (b->npred < 2) continue;
+		for (k = 0; k < b->npred; ++k) {
+			IrBlock runner = b->pred[k];
+
+			while (runner != b->idom) {
+				PtrList *l = &df[runner->rpo];
+				if (l->n == 0 || l->item[l->n - 1] != b) listPush(l, b);
+				runner = runner->idom;
+			}
+		}
+	}
+	return df;
+}
+
+/* renaming state: a stack of names for every original register */
+static int **nameStack;
+static int *nameDepth;
+static int *nameCap;
+static int *undefReg;
+static int *logRegs;
+static int logTop, logCap;
+static IrFunc renFunc;
+
+static void pushName(int v, int name) {
+	if (nameDepth[v] == nameCap[v]) {
+		nameCap[v] = nameCap[v] == 0 ? 4 : nameCap[v] * 2;
+		nameStack[v] = (int *)realloc(nameStack[v], nameCap[v] * sizeof(int));
+	}
+	nameStack[v][nameDepth[v]++] = name;
+	if (logTop == logCap) {
+		logCap = logCap == 0 ? 64 : logCap * 2;
+		logRegs = (int *)realloc(logRegs, logCap * sizeof(int));
+	}
+	logRegs[logTop++] = v;
+}
+
+/* Function currentName returns the reaching definition of v;
+ * reads of never assigned locals see the constant 0
+ */
+static int currentName(int v) {
+	if (nameDepth[v] > 0) return nameStack[v][nameDepth[v] - 1];
+	if (undefReg[v] < 0) {
+		IrInstr i = newInstr(IrConst, newReg(renFunc), -1, -1);
+		i->imm = 0;
+		if (renFunc->entry->first == NULL) appendInstr(renFunc->entry, i);
+		else insertBefore(renFunc->entry->first, i);
+		undefReg[v] = i->dst;
+	}
+	return undefReg[v];
+}
+
+static void renameBlock(IrBlock b, int nregs) {
+	int mark = logTop;
+	IrInstr i;
+	int k;
+
+	for (i = b->first; i != NULL; i = i->next) {
+		if (i->op != IrPhi) {
+			for (k = 0; k < 2; ++k)
+				if (i->src[k] >= 0 && i->src[k] < nregs) i->src[k] = currentName(i->src[k]);
+			for (k = 0; k < i->nargs; ++k)
+				if (i->args[k] < nregs) i->args[k] = currentName(i->args[k]);
+		}
+		if (i->dst >= 0 && i->dst < nregs) {
+			int name = newReg(renFunc);
+			pushName(i->dst, name);
+			i->dst = name;
+		}
+	}
+	for (k = 0; k < b->nsucc; ++k) {
+		IrBlock s = b->succ[k];
+		int p = predIndex(s, b);
+
+		for (i = s->first; i != NULL && i->op == IrPhi; i = i->next)
+			i->args[p] = currentName(i->imm);
+	}
+	for (k = 0; k < b->nkids; ++k) renameBlock(b->kids[k], nregs);
+	while (logTop > mark) nameDepth[logRegs[--logTop]]--;
+}
+
+void buildSSA(IrFunc f) {
+	int nregs = f->nregs;
+	int n, i, k;
+	PtrList *df;
+	PtrList *defs = (PtrList *)calloc(nregs, sizeof(PtrList));
+	char *global = (char *)calloc(nregs, 1);
+	int *killed = (int *)malloc(nregs * sizeof(int));
+	int *hasPhi, *inWork;
+	IrBlock *work;
+	IrInstr ins;
+
+	computeDominators(f);
+	n = f->nrpo;
+	df = dominanceFrontiers(f, n);
+
+	/* find registers used before being defined in some block */
+	for (i = 0; i < nregs; ++i) killed[i] = -1;
+	for (i = 0; i < f->nparams; ++i) listPush(&defs[f->params[i]], f->entry);
+	for (i = 0; i < n; ++i) {
+		IrBlock b = f->rpoOrder[i];
+
+		for (ins = b->first; ins != NULL; ins = ins->next) {
+			for (k = 0; k < 2; ++k)
+				if (ins->src[k] >= 0 && killed[ins->src[k]] != i) global[ins->src[k]] = 1;
+			for (k = 0; k < ins->nargs; ++k)
+				if (killed[ins->args[k]] != i) global[ins->args[k]] = 1;
+			if (ins->dst >= 0) {
+				if (killed[ins->dst] != i) listPush(&defs[ins->dst], b);
+				killed[ins->dst] = i;
+			}
+		}
+	}
+
+	/* place phi functions */
+	hasPhi = (int *)malloc(n * sizeof(int));
+	inWork = (int *)malloc(n * sizeof(int));
+	work = (IrBlock *)malloc(n * sizeof(IrBlock));
+	for (i = 0; i < n; ++i) hasPhi[i] = inWork[i] = -1;
+	for (i = 0; i < nregs; ++i) {
+		int top = 0;
+
+		if (!global[i] || defs[i].n < 1) continue;
+		for (k = 0; k < defs[i].n; ++k) {
+			IrBlock b = (IrBlock)defs[i].item[k];
+			if (b->rpo >= 0 && inWork[b->rpo] != i) {
+				inWork[b->rpo] = i;
+				work[top++] = b;
+			}
+		}
+		while (top > 0) {
+			IrBlock b = work[--top];
+			PtrList *l = &df[b->rpo];
+
+			for (k = 0; k < l->n; ++k) {
+				IrBlock y = (IrBlock)l->item[k];
+
+				if (hasPhi[y->rpo] == i) continue;
+				hasPhi[y->rpo] = i;
+				ins = newInstr(IrPhi, i, -1, -1);
+				ins->imm = i;
+				ins->nargs = y->npred;
+				ins->args = (int *)malloc((y->npred + 1) * sizeof(int));
+				if (y->first == NULL) appendInstr(y, ins);
+				else insertBefore(y->first, ins);
+				if (inWork[y->rpo] != i) {
+					inWork[y->rpo] = i;
+					work[top++] = y;
+				}
+			}
+		}
+	}
+
+	/* rename along the dominator tree */
+	renFunc = f;
+	nameStack = (int **)calloc(nregs, sizeof(int *));
+	nameDepth = (int *)calloc(nregs, sizeof(int));
+	nameCap = (int *)calloc(nregs, sizeof(int));
+	undefReg = (int *)malloc(nregs * sizeof(int));
+	for (i = 0; i < nregs; ++i) undefReg[i] = -1;
+	for (i = 0; i < f->nparams; ++i) pushName(f->params[i], f->params[i]);
+	logTop = 0;
+	renameBlock(f->entry, nregs);
+
+	for (i = 0; i < nregs; ++i) {
+		free(nameStack[i]);
+		free(defs[i].item);
+	}
+	for (i = 0; i < n; ++i) free(df[i].item);
+	free(nameStack);
+	free(nameDepth);
+	free(nameCap);
+	free(undefReg);
+	free(df);
+	free(defs);
+	free(global);
+	free(killed);
+	free(hasPhi);
+	free(inWork);
+	free(work);
+}
+
+/* Function splitEdge inserts an empty block on the edge p -> s */
+
+static IrBlock splitEdge(IrFunc f, IrBlock p, IrBlock s) {
+	IrBlock m = newBlock(f);
+	IrInstr j = newInstr(IrJump, -1, -1, -1);
+	int k;
+
+	for (k = 0; k < p->nsucc; ++k)
+		if (p->succ[k] == s) {
+			p->succ[k] = m;
+			break;
+		}
+	m->pred = (IrBlock *)malloc(sizeof(IrBlock));
+	m->pred[0] = p;
+	m->npred = m->predCap = 1;
+	m->succ[0] = s;
+	m->nsucc = 1;
+	s->pred[predIndex(s, p)] = m;
+	appendInstr(m, j);
+	m->next = p->next;
+	p->next = m;
+	return m;
+}
+
+void destroySSA(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	int k;
+
+	for (b = f->entry; b != NULL; b = b->next) {
+		if (b->first == NULL || b->first->op != IrPhi) continue;
+		for (k = 0; k < b->npred; ++k)
+			if (b->pred[k]->nsucc > 1) splitEdge(f, b->pred[k], b);
+		for (i = b->first; i != NULL && i->op == IrPhi; i = i->next) {
+			int t = newReg(f);
+
+			for (k = 0; k < b->npred; ++k) {
+				IrBlock p = b->pred[k];
+				IrInstr c = newInstr(IrCopy, t, i->args[k], -1);
+				insertBefore(p->last, c);
+			}
+			i->op = IrCopy;
+			i->src[0] = t;
+			i->nargs = 0;
+			free(i->args);
+			i->args = NULL;
+		}
+	}
+}
@@ -0,0 +1,31 @@
+/* FILE: ssa.h */
+/* Dominator tree and static single assignment form */
+
+#ifndef _SSA_H_
+#define _SSA_H_
+
+#include "ir.h"
+
+/* Procedure computeDominators removes unreachable blocks,
+ * numbers the remaining ones in reverse postorder and builds
+ * the dominator tree (Cooper, Harvey and Kennedy)
+ */
+void computeDominators(IrFunc);
+
+/* Function dominates returns TRUE if block a dominates block b */
+
+int dominates(IrBlock a, IrBlock b);
+
+/* Procedure buildSSA puts a function into semi-pruned SSA form:
+ * phi functions are placed on the iterated dominance frontier
+ * of the definitions of every register used across blocks
+ * and all registers are renamed along the dominator tree
+ */
+void buildSSA(IrFunc);
+
+/* Procedure destroySSA replaces phi functions by copies
+ * on the incoming edges, splitting critical edges
+ */
+void destroySSA(IrFunc);
+
+#endif
@@ -11,7 +11,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "globals.h"
 #include "symtab.h"
+#include "analyze.h"
+#include "util.h"
 
 /* SIZE is the size of the hash table */
 #define SIZE 211
@@ -45,6 +48,8 @@ static BucketList hashTable[SIZE];
 
 typedef struct HashRec {
  BucketList hashTable[SIZE];
+ unsigned char occupied[SIZE];	/* the indices of the nonempty buckets, ascending */
+ int noccupied;
  int scopeNum;
  struct HashRec *next;
  struct HashRec *before;
@@ -52,15 +57,94 @@ typedef struct HashRec {
 
 int currentScopeNum = 0;
 
-HashList head;
+HashList head = NULL;
 HashList curTable;
 
+/* the last global declaration visible, -1 for all */
+static int visibleOrder = -1;
+
+int lineno_lookup (char * name, HashList now);
+
+/* the tables of dropped scopes, reused for new ones */
+static HashList freeTables = NULL;
+
+/* the symbols inserted since init */
+static int nsymbols = 0;
+
+static void clearTable(HashList t) {
+ int i, k;
+ for (k = 0; k < t->noccupied; ++k) {
+  i = t->occupied[k];
+  while (t->hashTable[i] != NULL) {
+   BucketList l = t->hashTable[i];
+   t->hashTable[i] = l->next;
+   while (l->lines != NULL) {
+    LineList n = l->lines->next;
+    free(l->lines);
+    l->lines = n;
+   }
+   free(l);
+  }
+ }
+ t->noccupied = 0;
+}
+
+/* Procedure linkBucket puts bucket l at the front of the
+ * chain h of table t, keeping the nonempty chains
+ * in order
+ */
+static void linkBucket(HashList t, int h, BucketList l) {
+ int k;
+ if (t->hashTable[h] == NULL) {
+  for (k = t->noccupied++; k > 0 && t->occupied[k - 1] > h; --k)
+   t->occupied[k] = t->occupied[k - 1];
+  t->occupied[k] = h;
+ }
+ l->next = t->hashTable[h];
+ t->hashTable[h] = l;
+}
+
+static HashList newTable(void) {
+ HashList t = freeTables;
+ if (t == NULL) return (HashList)calloc(1, sizeof(struct HashRec));
+ freeTables = t->next;
+ t->next = t->before = NULL;
+ return t;
+}
+
+static void dropTables(HashList t) {
+ while (t != NULL) {
+  HashList next = t->next;
+  clearTable(t);
+  t->next = freeTables;
+  freeTables = t;
+  t = next;
+ }
+}
+
 void init() {
- head = (HashList)malloc(sizeof(struct HashRec));
+ if (head != NULL) {
+  dropTables(head->next);
+  clearTable(head);
+ }
+ else head = newTable();
  head->scopeNum = 0;
  head->next = NULL;
  head->before = NULL;
  curTable = head;
+ currentScopeNum = 0;
+ nsymbols = 0;
+}
+
+void st_setVisible(int order) {
+ visibleOrder = order;
+}
+
+void st_dropScopes(void) {
+ dropTables(head->next);
+ head->next = NULL;
+ curTable = head;
+ currentScopeNum = 0;
 }
 
 void set_curTable_head(){
@@ -89,7 +173,7 @@ void scopeDown() {
 void st_createHashTable(int isTypeCheck) {
 
  if(isTypeCheck == 0){
- 	 HashList new = (HashList)malloc(sizeof(struct HashRec));
+ 	 HashList new = newTable();
   	 curTable->next = new;
   	 new->before = curTable;
   	 new->next = NULL;
@@ -109,6 +193,7 @@ void lineno_insert(char *name, int lineno) {
 			int h = hash(name);
 			if (lineno_lookup(name, now) != -1) {
 				BucketList l = now->hashTable[h];
+				while (strcmp(name, l->name) != 0) l = l->next;
 				LineList t = l->lines;
 				
 				while (t->next != NULL) t = t->next;
@@ -126,9 +211,8 @@ void lineno_insert(char *name, int lineno) {
 		//	printf("lineno_scopenum: %d\n", now->scopeNum);
 	}
 	if (now == NULL) {
-	 printf("hellossss\n");
 	 	printf("ERROR in line %d : %s not exist\n", lineno, name);
-		exit(1);
+		semanticError();
 		// handling exception
 	}
 
@@ -148,11 +232,12 @@ int lineno_lookup (char * name, HashList now){
 	while ((l != NULL) && (strcmp(name,l->name) != 0)){
   		l = l->next;
 	}
+	if (l != NULL && now == head && visibleOrder >= 0 && l->order > visibleOrder) return -1;
  	if (l == NULL) return -1;
  	else return l->lines->lineno;
 }
 
-void st_insert( char * name, int lineno, int loc, char *type, int arraySize, char *VPF ){ 
+BucketList st_insert( char * name, int lineno, int loc, char *type, int arraySize, char *VPF ){ 
 	int h = hash(name);
 	
 	BucketList l;
@@ -167,7 +252,7 @@ void st_insert( char * name, int lineno, int loc, char *type, int arraySize, cha
 		l = l->next;
 	if (l == NULL) /* variable not yet in table */
 	{ l = (BucketList) malloc(sizeof(struct BucketListRec));
-	 l->name = name;
+	 l->name = internString(name, strlen(name));
 	 l->lines = (LineList) malloc(sizeof(struct LineListRec));
 	 l->lines->lineno = lineno;
 	 l->memloc = loc;
@@ -175,21 +260,17 @@ void st_insert( char * name, int lineno, int loc, char *type, int arraySize, cha
 	 strncpy(l->type, type, strlen(type) + 1);
 	 l->arraySize = arraySize;
 	 strncpy(l->VPF, VPF, strlen(VPF) + 1);
+	 l->order = 0;
+	 l->id = nsymbols++;
 
 	 l->lines->next = NULL;
-	 if(currentScopeNum == 0){
-	   l->next = head->hashTable[h];
-	   head->hashTable[h] = l;
-	 }
-	 else{
-		l->next = curTable->hashTable[h];
-		curTable->hashTable[h] = l;
-	 }
+	 linkBucket(currentScopeNum == 0 ? head : curTable, h, l);
 	}
 	else /* found in table, so just add line number */
 	{ 
 	 printf("ERROR in symtab.c\n");
 	}
+	return l;
 } /* st_insert */
 
 /* Function st_lookup returns the memory 
@@ -198,7 +279,7 @@ void st_insert( char * name, int lineno, int loc, char *type, int arraySize, cha
 int st_lookup ( char * name )
 { int h = hash(name);
  BucketList l =  curTable->hashTable[h];
-  printf("st_lookup name: %s, scopeNum: %d\n", name, curTable->scopeNum);
+  if (TraceAnalyze) printf("st_lookup name: %s, scopeNum: %d\n", name, curTable->scopeNum);
  while ((l != NULL) && (strcmp(name,l->name) != 0)){
   l = l->next;
  }
@@ -236,13 +317,42 @@ BucketList st_bucket_lookup(char *name) {
 
 			if (lineno_lookup(name, now) != -1) {
 				BucketList l = now->hashTable[h];
+				while (strcmp(name, l->name) != 0) l = l->next;
 				return l;
 			}
 			else curScopeNum--;
 		}
 		now = now->before;
 	}
+	return NULL;
+}
 
+/* Procedure printTable prints the symbols of table
+ * now, chain by chain in the order of the hash table,
+ * one call for each
+ */
+static void printTable(FILE * listing, HashList now)
+{ int k;
+ for (k = 0; k < now->noccupied; ++k)
+ { BucketList l;
+  for (l = now->hashTable[now->occupied[k]]; l != NULL; l = l->next)
+  { LineList t;
+   if (!strcmp(l->type, "array"))
+    fprintf(listing, "%-4s %-5d  %-3d  %-5s  %-5s  %-7d  %-4s  ",
+     l->name, now->scopeNum, l->memloc, l->VPF, "Array", l->arraySize, l->type);
+   else
+    fprintf(listing, "%-4s %-5d  %-3d  %-5s  %-5s  %-7s  %-4s  ",
+     l->name, now->scopeNum, l->memloc, l->VPF, "No", "-", l->type);
+   for (t = l->lines; t != NULL; t = t->next)
+    fprintf(listing, "%4d ", t->lineno);
+   putc('\n', listing);
+  }
+ }
+}
+
+static void printHeader(FILE * listing)
+{ fputs("Name  Scope  Loc  V/P/F  Array?  ArrSize  Type  Line Numbers\n", listing);
+ fputs("------------------------------------------------------------\n", listing);
 }
 
 /* Procedure printSymTab prints a formatted 
@@ -250,115 +360,33 @@ BucketList st_bucket_lookup(char *name) {
  * to the listing file
  */
 void printSymTab(FILE * listing)
-{ int i;
- fprintf(listing,"Name  Scope  Loc  V/P/F  Array?  ArrSize  Type  Line Numbers\n");
- fprintf(listing,"------------------------------------------------------------\n");
- HashList temp = head;
- while (temp != NULL) {
-  for (i=0;i<SIZE;++i)
-  { if (temp->hashTable[i] != NULL)
-   { BucketList l = temp->hashTable[i];
-	while (l != NULL)
-	{ LineList t = l->lines;
-	 fprintf(listing,"%-4s ",l->name);
-	 fprintf(listing,"%-5d  ",temp->scopeNum);
-	 fprintf(listing,"%-3d  ",l->memloc);
-	 fprintf(listing,"%-5s  ",l->VPF);
-
-	 if(!strcmp(l->type, "array")){
-	 	fprintf(listing,"%-5s  ", "Array" );
-	 	fprintf(listing,"%-7d  ", l->arraySize);
-	 }
-	 else{
-	 	fprintf(listing,"%-5s  ", "No" );
-	 	fprintf(listing,"%-7s  ", "-");
-	 }
-	 fprintf(listing,"%-4s  ",l->type);
-	 while (t != NULL)
-	 { fprintf(listing,"%4d ",t->lineno);
-	  t = t->next;
-	 }
-	 fprintf(listing,"\n");
-	 l = l->next;
-	}
-   }
-  }
-  temp = temp->next;
-  printf("\n\n");
+{ HashList temp;
+ printHeader(listing);
+ for (temp = head; temp != NULL; temp = temp->next) {
+  printTable(listing, temp);
+  fputs("\n\n", listing);
  }
 } /* printSymTab */
 
 void printSymTabHead(FILE * listing, HashList now)
-{ int i;
-
- fprintf(listing,"Name  Scope  Loc  V/P/F  Array?  ArrSize  Type  Line Numbers\n");
- fprintf(listing,"------------------------------------------------------------\n");
- HashList temp = now;
-  for (i=0;i<SIZE;++i)
-  { if (temp->hashTable[i] != NULL)
-   { BucketList l = temp->hashTable[i];
-	while (l != NULL)
-	{ LineList t = l->lines;
-	 fprintf(listing,"%-4s ",l->name);
-	 fprintf(listing,"%-5d  ",temp->scopeNum);
-	 fprintf(listing,"%-3d  ",l->memloc);
-	 fprintf(listing,"%-5s  ",l->VPF);
-
-	 if(!strcmp(l->type, "array")){
-	 	fprintf(listing,"%-5s  ", "Array" );
-	 	fprintf(listing,"%-7d  ", l->arraySize);
-	 }
-	 else{
-	 	fprintf(listing,"%-5s  ", "No" );
-	 	fprintf(listing,"%-7s  ", "-");
-	 }
-	 fprintf(listing,"%-4s  ",l->type);
-	 while (t != NULL)
-	 { fprintf(listing,"%4d ",t->lineno);
-	  t = t->next;
-	 }
-	 fprintf(listing,"\n");
-	 l = l->next;
-	}
-   }
-  }
-} /* printSymTab */
+{ printHeader(listing);
+ printTable(listing, now);
+} /* printSymTabHead */
 
 void printSymTabCur(FILE * listing)
-{ int i;
-
- fprintf(listing,"Name  Scope  Loc  V/P/F  Array?  ArrSize  Type  Line Numbers\n");
- fprintf(listing,"------------------------------------------------------------\n");
- HashList temp = curTable;
-  for (i=0;i<SIZE;++i)
-  { if (temp->hashTable[i] != NULL)
-   { BucketList l = temp->hashTable[i];
-	while (l != NULL)
-	{ LineList t = l->lines;
-	 fprintf(listing,"%-4s ",l->name);
-	 fprintf(listing,"%-5d  ",temp->scopeNum);
-	 fprintf(listing,"%-3d  ",l->memloc);
-	 fprintf(listing,"%-5s  ",l->VPF);
-
-	 if(!strcmp(l->type, "array")){
-	 	fprintf(listing,"%-5s  ", "Array" );
-	 	fprintf(listing,"%-7d  ", l->arraySize);
-	 }
-	 else{
-	 	fprintf(listing,"%-5s  ", "No" );
-	 	fprintf(listing,"%-7s  ", "-");
-	 }
-	 fprintf(listing,"%-4s  ",l->type);
-	 while (t != NULL)
-	 { fprintf(listing,"%4d ",t->lineno);
-	  t = t->next;
-	 }
-	 fprintf(listing,"\n");
-	 l = l->next;
-	}
-   }
-  }
-} /* printSymTab */
+{ printHeader(listing);
+ printTable(listing, curTable);
+} /* printSymTabCur */
+
+void st_walk(void (*visit)(BucketList l, int scope))
+{ HashList temp;
+ int k;
+ BucketList l;
+ for (temp = head; temp != NULL; temp = temp->next)
+  for (k = 0; k < temp->noccupied; ++k)
+   for (l = temp->hashTable[temp->occupied[k]]; l != NULL; l = l->next)
+    visit(l, temp->scopeNum);
+} /* st_walk */
 
 void isMainLast()
 {
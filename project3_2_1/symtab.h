@@ -27,16 +27,43 @@ typedef struct BucketListRec
  char type[10];
  int arraySize;
  char VPF[10];
+ int order; /* position of a global declaration */
+ int id; /* number in order of insertion, for dumps */
  struct BucketListRec * next;
 } * BucketList;
 
 
+/* Procedure init starts with an empty global
+ * scope, reusing the tables of an earlier one
+ */
+void init();
+void set_curTable_head();
 void scopeUp();
 void scopeDown();
 int scopeCheck();
-void st_createHashTable();
+void st_createHashTable(int isTypeCheck);
+
+/* Function st_insert returns the bucket of the
+ * newly inserted symbol so that callers can
+ * bind declarations to their symbol
+ */
+BucketList st_insert( char * name, int lineno, int loc, char *type, int arraySize, char *VPF);
+
+/* Procedure lineno_insert records a reference
+ * to name in the innermost visible scope
+ */
+void lineno_insert(char *name, int lineno);
+
+/* Procedure st_dropScopes forgets the local
+ * scopes, keeping the global one
+ */
+void st_dropScopes(void);
 
-void st_insert( char * name, int lineno, int loc, char *type, int arraySize, char *VPF);
+/* Procedure st_setVisible hides the global
+ * declarations after position order from
+ * lookups, -1 shows all of them
+ */
+void st_setVisible(int order);
 
 /* Function st_lookup returns the memory 
  * location of a variable or -1 if not found
@@ -45,10 +72,23 @@ int st_lookup ( char * name );
 int st_function_lookup (char *name);
 char * st_functionType_lookup (char *name);
 
+/* Function st_bucket_lookup returns the bucket of
+ * name in the innermost visible scope or NULL
+ */
+BucketList st_bucket_lookup(char *name);
+
 /* Procedure printSymTab prints a formatted 
  * listing of the symbol table contents 
  * to the listing file
  */
 void printSymTab(FILE * listing);
+void printSymTabCur(FILE * listing);
+
+/* Procedure st_walk calls visit with every
+ * symbol and the number of its scope, in the
+ * order of printSymTab
+ */
+void st_walk(void (*visit)(BucketList l, int scope));
+void isMainLast();
 
 #endif
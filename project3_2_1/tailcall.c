@@ -0,0 +1,89 @@
+/* FILE: tailcall.c */
+/* Tail call elimination: self-recursive tail calls become */
+/* loops, other tail calls reuse the frame of the caller */
+
+#include "globals.h"
+#include "ir.h"
+#include "opt.h"
+
+/* Function tailReturn returns the return instruction that
+ * directly follows the call, possibly through jumps to blocks
+ * holding just that return, or NULL if the call is not in
+ * tail position
+ */
+static IrInstr tailReturn(IrFunc f, IrInstr call) {
+	IrInstr i = call->next;
+	int hops = 0;
+
+	while (i != NULL && i->op == IrJump && hops++ < f->nblocks)
+		i = i->block->succ[0]->first;
+	if (i == NULL || i->op != IrRet) return NULL;
+	if (i->src[0] >= 0 && i->src[0] != call->dst) return NULL;
+	if (i->src[0] < 0 && !f->isVoid) return NULL;
+	return i;
+}
+
+/* Procedure cutAfter removes the instructions after i
+ * and the outgoing edges of its block
+ */
+static void cutAfter(IrInstr i) {
+	IrBlock b = i->block;
+	int k;
+
+	while (b->last != i) removeInstr(b->last);
+	for (k = 0; k < b->nsucc; ++k) removePred(b->succ[k], b);
+	b->nsucc = 0;
+}
+
+int eliminateTailCalls(IrFunc f, int selfOnly) {
+	IrBlock b, body = NULL;
+	IrInstr i, c;
+	int k, tails = 0;
+
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) {
+			if (i->op != IrCall || tailReturn(f, i) == NULL) continue;
+			if (!strcmp(i->name, "input") || !strcmp(i->name, "output")) continue;
+			if (selfOnly && i->sym != f->sym) continue;
+			cutAfter(i);
+			tails++;
+			if (i->sym != f->sym) {
+				/* the code generator reuses the frame */
+				i->op = IrTailCall;
+				i->dst = -1;
+				continue;
+			}
+
+			/* a self-recursive call: the arguments go to the
+			 * parameters and control returns to the top of the
+			 * function, behind a fresh entry block
+			 */
+			if (body == NULL) {
+				body = f->entry;
+				f->entry = newBlock(f);
+				f->entry->next = body;
+				appendInstr(f->entry, newInstr(IrJump, -1, -1, -1));
+				addEdge(f->entry, body);
+			}
+			for (k = 0; k < i->nargs; ++k) {
+				c = newInstr(IrCopy, newReg(f), i->args[k], -1);
+				c->lineno = i->lineno;
+				insertBefore(i, c);
+				i->args[k] = c->dst;
+			}
+			for (k = 0; k < i->nargs; ++k) {
+				c = newInstr(IrCopy, f->params[k], i->args[k], -1);
+				c->lineno = i->lineno;
+				insertBefore(i, c);
+			}
+			i->op = IrJump;
+			i->dst = -1;
+			i->nargs = 0;
+			free(i->args);
+			i->args = NULL;
+			i->name = NULL;
+			i->sym = NULL;
+			addEdge(b, body);
+		}
+	return tails;
+}
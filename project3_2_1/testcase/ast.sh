@@ -0,0 +1,53 @@
+#!/bin/sh
+# Syntax tree loader test: writes the tree of a small program
+# with -ast, then forges and truncates copies of it and checks
+# that each one is rejected with an error, not compiled and
+# not crashed on.
+#
+# usage: ast.sh
+
+here=$(dirname "$0")
+compiler=$here/../project3_2
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+cat > "$work/t.c" <<'EOF'
+int f(int n) { return n + 1; }
+void main(void) { output(f(input())); }
+EOF
+$compiler -ast "$work/t.c" > /dev/null 2>&1 || { echo "FAIL: -ast"; exit 1; }
+
+# the header is 16 bytes, a record 8 links and 7 fields of
+# 4 bytes; record 0 is the FuncK of f
+record=60
+kind=$((16 + 8 * 4 + 3 * 4))
+
+# Procedure put writes the 4-byte value given as octal escapes
+# at byte offset $2 of a fresh copy $3 of the tree
+put() {
+	cp "$work/t.ast" "$work/$3.ast"
+	printf "$1" | dd of="$work/$3.ast" bs=1 seek="$2" conv=notrunc 2> /dev/null
+}
+
+put '\143\0\0\0' $kind badkind
+put '\7\0\0\0' $((kind - 4)) badnodekind
+cp "$work/t.ast" "$work/nochildren.ast"
+for k in 0 1 2 3 4 5 6 7; do
+	printf '\377\377\377\377' | dd of="$work/nochildren.ast" bs=1 seek=$((16 + k * 4)) conv=notrunc 2> /dev/null
+done
+head -c $(($(wc -c < "$work/t.ast") - 1)) "$work/t.ast" > "$work/truncated.ast"
+head -c $((16 + record / 2)) "$work/t.ast" > "$work/halfrecord.ast"
+
+fail=0
+$compiler "$work/t.ast" > "$work/out" 2>&1 || { echo "FAIL: t.ast"; fail=1; }
+for t in badkind badnodekind nochildren truncated halfrecord; do
+	$compiler "$work/$t.ast" > "$work/out" 2>&1
+	rc=$?
+	if [ $rc -ne 1 ] || ! grep -q "^Bad syntax tree\|^Truncated syntax tree" "$work/out"; then
+		echo "FAIL: $t.ast (exit $rc)"
+		fail=1
+	fi
+done
+[ $fail -eq 0 ] && echo "ast: ok"
+exit $fail
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Output test: compiles with -O every test case that has a .out
+# file next to it, runs it in the simulator and checks that it
+# ends normally and prints the .out file.  test8 recurses far
+# deeper than the TM stack and only fits with its tail calls
+# turned into loops.
+#
+# usage: expect.sh
+
+here=$(dirname "$0")
+compiler=$here/../project3_2
+tm=$here/../tm
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+fail=0
+for out in "$here"/*.out; do
+	t=$(basename "$out" .out)
+	cp "$here/$t.c" "$work/"
+	if ! $compiler -O "$work/$t.c" > /dev/null 2>&1; then
+		echo "FAIL: $t.c does not compile"
+		fail=1
+		continue
+	fi
+	if ! $tm "$work/$t.tm" < /dev/null > "$work/$t.got" 2> "$work/$t.err" || ! cmp -s "$out" "$work/$t.got"; then
+		echo "FAIL: $t.c: $(tr '\n' ' ' < "$work/$t.got")$(cat "$work/$t.err")"
+		fail=1
+	fi
+done
+[ $fail -eq 0 ] && echo "expect: ok"
+exit $fail
@@ -0,0 +1,33 @@
+/* Tail recursion far deeper than the TM stack:
+ * sum and count recurse once per step, gcd and
+ * scale end in tail calls to other functions
+ */
+
+int sum(int n, int acc) {
+	if (n == 0) return acc;
+	return sum(n - 1, acc + n);
+}
+
+void count(int n) {
+	if (n == 0) output(0);
+	else count(n - 1);
+}
+
+int gcd(int a, int b) {
+	if (b == 0) return a;
+	return gcd(b, a - a / b * b);
+}
+
+int scale(int x, int y, int z) {
+	return gcd(x * y, z);
+}
+
+int twice(int n) {
+	return scale(n, 2, 36);
+}
+
+void main(void) {
+	output(sum(50000, 0));
+	count(100000);
+	output(twice(27));
+}
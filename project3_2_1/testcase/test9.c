@@ -0,0 +1,22 @@
+/* Mutual recursion through a prototype:
+ * odd is called by even before its definition,
+ * which completes the declaration above it
+ */
+
+int odd(int n);
+
+int even(int n) {
+	if (n == 0) return 1;
+	return odd(n - 1);
+}
+
+int odd(int n) {
+	if (n == 0) return 0;
+	return even(n - 1);
+}
+
+void main(void) {
+	output(even(10));
+	output(odd(7));
+	output(even(7));
+}
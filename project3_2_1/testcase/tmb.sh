@@ -0,0 +1,37 @@
+#!/bin/sh
+# Binary code test: compiles the benchmark programs and the
+# test cases that run to an end to TM text and to TM binary,
+# with and without -O, and checks that the simulator lists the
+# same instructions for both and that both runs give the same
+# output.
+#
+# usage: tmb.sh
+
+here=$(dirname "$0")
+compiler=$here/../project3_2
+tm=$here/../tm
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+cp "$here"/../bench/*.c "$here"/test8.c "$here"/test9.c "$work"/
+fail=0
+for f in "$work"/*.c; do
+	p=${f%.c}
+	for opt in "" -O; do
+		$compiler $opt "$f" > /dev/null 2>&1 || { echo "FAIL: $(basename $f) $opt"; fail=1; continue; }
+		$compiler $opt -binary "$f" > /dev/null 2>&1 || { echo "FAIL: $(basename $f) $opt -binary"; fail=1; continue; }
+		if ! $tm -l "$p.tm" > "$p.l1" 2>&1 || ! $tm -l "$p.tmb" > "$p.l2" 2>&1 || ! cmp -s "$p.l1" "$p.l2"; then
+			echo "FAIL: $(basename $f) $opt listings differ"
+			fail=1
+		fi
+		$tm "$p.tm" < /dev/null > "$p.o1" 2>&1
+		$tm "$p.tmb" < /dev/null > "$p.o2" 2>&1
+		if ! cmp -s "$p.o1" "$p.o2"; then
+			echo "FAIL: $(basename $f) $opt runs differ"
+			fail=1
+		fi
+	done
+done
+[ $fail -eq 0 ] && echo "tmb: ok"
+exit $fail
@@ -0,0 +1,481 @@
+/* FILE: tm.c */
+/* TM machine simulator for the C-Minus compiler */
+/* Runs a .tm code file, or binary code from a .tmb file, */
+/* to completion, optionally counting the executed */
+/* instructions, and reports the profile of code */
+/* compiled with -profile */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tmb.h"
+
+#define IADDR_SIZE 65536 /* increase for large programs */
+#define DADDR_SIZE 65536 /* increase for large programs */
+#define NO_REGS 8
+#define PC_REG 7
+
+#define LINESIZE 1024
+#define WORDSIZE 20
+
+typedef enum {
+	opclRR,		/* reg operands r,s,t */
+	opclRM,		/* reg r, mem d+s */
+	opclRA		/* reg r, int d+s */
+} OPCLASS;
+
+typedef enum {
+	/* RR instructions */
+	opHALT, opIN, opOUT, opADD, opSUB, opMUL, opDIV,
+	opRRLim,
+	/* RM instructions */
+	opLD, opST,
+	opRMLim,
+	/* RA instructions */
+	opLDA, opLDC, opJLT, opJLE, opJGT, opJGE, opJEQ, opJNE,
+	opRALim
+} OPCODE;
+
+typedef enum {
+	srOKAY, srHALT, srIMEM_ERR, srDMEM_ERR, srZERODIVIDE, srBOUNDS, srOVERFLOW
+} STEPRESULT;
+
+typedef struct {
+	int iop;
+	int iarg1;
+	int iarg2;
+	int iarg3;
+} INSTRUCTION;
+
+static int iloc = 0;
+static int traceflag = 0;
+static int countflag = 0;
+
+static INSTRUCTION iMem[IADDR_SIZE];
+
+/* binary code runs from the mapped file instead of iMem */
+static TmbInstr *image = NULL;
+static INSTRUCTION fetched;
+static int dMem[DADDR_SIZE];
+static int reg[NO_REGS];
+
+static char *opCodeTab[] = {
+	"HALT", "IN", "OUT", "ADD", "SUB", "MUL", "DIV", "????",
+	"LD", "ST", "????",
+	"LDA", "LDC", "JLT", "JLE", "JGT", "JGE", "JEQ", "JNE", "????"
+};
+
+static char *stepResultTab[] = {
+	"OK", "Halted", "Instruction Memory Fault",
+	"Data Memory Fault", "Division by 0", "Array index out of bounds",
+	"Division overflow"
+};
+
+/* the counters of -profile: words of data memory and what
+ * they count, the calls of a function, or the iterations of
+ * one of its loops or the runs of either side of an if, at
+ * a line
+ */
+typedef struct {
+	int word;
+	int kind;	/* an index into countHeading */
+	int line;
+	int ordinal;	/* among the loops and ifs on the line, from 1 */
+	char *name;
+} COUNTER;
+
+static char *countHeading[][2] = {
+	{ "calls", "function" }, { "iterations", "loop" }, { "then", "if" }, { "else", "if" }
+};
+#define NKINDS 4
+
+static COUNTER *counter = NULL;
+static int ncounters = 0;
+
+static char in_Line[LINESIZE];
+static int lineLen;
+static int inCol;
+static int num;
+static char word[WORDSIZE];
+static char ch;
+
+static int opClass(int c) {
+	if (c <= opRRLim) return opclRR;
+	else if (c <= opRMLim) return opclRM;
+	else return opclRA;
+}
+
+static void getCh(void) {
+	if (++inCol < lineLen) ch = in_Line[inCol];
+	else ch = ' ';
+}
+
+static int nonBlank(void) {
+	while (inCol < lineLen && in_Line[inCol] == ' ') inCol++;
+	if (inCol < lineLen) {
+		ch = in_Line[inCol];
+		return 1;
+	}
+	ch = ' ';
+	return 0;
+}
+
+static int getNum(void) {
+	int sign = 1;
+	int ok = 0;
+
+	num = 0;
+	if (nonBlank() && (ch == '+' || ch == '-')) {
+		if (ch == '-') sign = -1;
+		getCh();
+	}
+	while (isdigit(ch)) {
+		ok = 1;
+		num = num * 10 + (ch - '0');
+		getCh();
+	}
+	num = num * sign;
+	return ok;
+}
+
+static int getWord(void) {
+	int length = 0;
+
+	if (nonBlank()) {
+		while (isalnum(ch)) {
+			if (length < WORDSIZE - 1) word[length++] = ch;
+			getCh();
+		}
+		word[length] = '\0';
+	}
+	return length != 0;
+}
+
+static int skipCh(char c) {
+	if (nonBlank() && ch == c) {
+		getCh();
+		return 1;
+	}
+	return 0;
+}
+
+static int error(char *msg, int lineNo, int instNo) {
+	if (lineNo > 0) fprintf(stderr, "Line %d", lineNo);
+	else fprintf(stderr, "Binary code");
+	if (instNo >= 0) fprintf(stderr, " (Instruction %d)", instNo);
+	fprintf(stderr, "   %s\n", msg);
+	return 0;
+}
+
+static void resetMachine(void) {
+	int loc, regNo;
+
+	for (regNo = 0; regNo < NO_REGS; regNo++) reg[regNo] = 0;
+	dMem[0] = DADDR_SIZE - 1;
+	for (loc = 1; loc < DADDR_SIZE; loc++) dMem[loc] = 0;
+}
+
+/* Function mapBinary maps binary code written with -binary
+ * and checks every instruction once, so that stepTM can run
+ * the records in place
+ */
+static int mapBinary(FILE *pgm) {
+	struct stat st;
+	TmbHeader *h;
+	TmbInstr *b;
+	int loc;
+
+	if (fstat(fileno(pgm), &st) < 0 || st.st_size < (off_t)sizeof(TmbHeader))
+		return error("Truncated binary code", 0, -1);
+	h = (TmbHeader *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(pgm), 0);
+	if (h == MAP_FAILED) return error("Unable to map binary code", 0, -1);
+	if (h->ninstr < 0 || h->ninstr > IADDR_SIZE ||
+			st.st_size != (off_t)(sizeof(TmbHeader) + h->ninstr * sizeof(TmbInstr)))
+		return error("Bad binary code size", 0, -1);
+	if (h->dataWords < 0 || h->dataWords >= DADDR_SIZE)
+		return error("Global data too large", 0, -1);
+	if (h->entry < 0 || (h->entry >= h->ninstr && h->ninstr > 0))
+		return error("Bad entry point", 0, h->entry);
+	b = (TmbInstr *)(h + 1);
+	for (loc = 0; loc < h->ninstr; loc++) {
+		if (b[loc].op >= opRALim || b[loc].op == opRRLim || b[loc].op == opRMLim)
+			return error("Illegal opcode", 0, loc);
+		if (b[loc].r >= NO_REGS || b[loc].s >= NO_REGS || b[loc].t >= NO_REGS)
+			return error("Bad register", 0, loc);
+	}
+	resetMachine();
+	image = b;
+	iloc = h->ninstr;
+	return 1;
+}
+
+/* Function readInstructions loads the code file into iMem */
+
+static int readInstructions(FILE *pgm) {
+	int op, arg1, arg2, arg3;
+	int loc, lineNo = 0;
+
+	resetMachine();
+	for (loc = 0; loc < IADDR_SIZE; loc++) {
+		iMem[loc].iop = opHALT;
+		iMem[loc].iarg1 = 0;
+		iMem[loc].iarg2 = 0;
+		iMem[loc].iarg3 = 0;
+	}
+	while (fgets(in_Line, LINESIZE - 2, pgm) != NULL) {
+		inCol = 0;
+		lineNo++;
+		lineLen = strlen(in_Line) - 1;
+		if (in_Line[lineLen] == '\n') in_Line[lineLen] = '\0';
+		else {
+			int c;
+			/* drop the rest of an overlong line (a long comment) */
+			while ((c = fgetc(pgm)) != EOF && c != '\n');
+			in_Line[++lineLen] = '\0';
+		}
+		if (!strncmp(in_Line, "* profile ", 10)) {
+			char name[LINESIZE];
+			COUNTER *c;
+
+			counter = (COUNTER *)realloc(counter, (ncounters + 1) * sizeof(COUNTER));
+			c = &counter[ncounters];
+			c->ordinal = 1;
+			if (sscanf(in_Line + 10, "%d %d %s %d %d", &c->word, &c->kind, name, &c->line, &c->ordinal) < 4 ||
+					c->word < 0 || c->word >= DADDR_SIZE || c->kind < 0 || c->kind >= NKINDS)
+				return error("Bad profile counter", lineNo, -1);
+			c->name = strdup(name);
+			ncounters++;
+		}
+		else if (nonBlank() && in_Line[inCol] != '*') {
+			if (!getNum()) return error("Bad location", lineNo, -1);
+			loc = num;
+			if (loc < 0 || loc >= IADDR_SIZE) return error("Location too large", lineNo, loc);
+			if (loc + 1 > iloc) iloc = loc + 1;
+			if (!skipCh(':')) return error("Missing colon", lineNo, loc);
+			if (!getWord()) return error("Missing opcode", lineNo, loc);
+			op = opHALT;
+			while (op < opRALim && strncmp(opCodeTab[op], word, 4) != 0) op++;
+			if (strncmp(opCodeTab[op], word, 4) != 0) return error("Illegal opcode", lineNo, loc);
+			switch (opClass(op)) {
+				case opclRR:
+					if (!getNum() || num < 0 || num >= NO_REGS) return error("Bad first register", lineNo, loc);
+					arg1 = num;
+					if (!skipCh(',')) return error("Missing comma", lineNo, loc);
+					if (!getNum() || num < 0 || num >= NO_REGS) return error("Bad second register", lineNo, loc);
+					arg2 = num;
+					if (!skipCh(',')) return error("Missing comma", lineNo, loc);
+					if (!getNum() || num < 0 || num >= NO_REGS) return error("Bad third register", lineNo, loc);
+					arg3 = num;
+					break;
+				default:
+					if (!getNum() || num < 0 || num >= NO_REGS) return error("Bad first register", lineNo, loc);
+					arg1 = num;
+					if (!skipCh(',')) return error("Missing comma", lineNo, loc);
+					if (!getNum()) return error("Bad displacement", lineNo, loc);
+					arg2 = num;
+					if (!skipCh('(') && !skipCh(',')) return error("Missing LParen", lineNo, loc);
+					if (!getNum() || num < 0 || num >= NO_REGS) return error("Bad second register", lineNo, loc);
+					arg3 = num;
+					break;
+			}
+			iMem[loc].iop = op;
+			iMem[loc].iarg1 = arg1;
+			iMem[loc].iarg2 = arg2;
+			iMem[loc].iarg3 = arg3;
+		}
+	}
+	return 1;
+}
+
+/* Function fetch returns the instruction at pc */
+static INSTRUCTION *fetch(int pc) {
+	TmbInstr *b;
+
+	if (image == NULL) return &iMem[pc];
+	/* locations past the code hold HALT, like in iMem */
+	memset(&fetched, 0, sizeof(fetched));
+	if (pc >= iloc) return &fetched;
+	b = &image[pc];
+	fetched.iop = b->op;
+	fetched.iarg1 = b->r;
+	if (opClass(b->op) == opclRR) {
+		fetched.iarg2 = b->s;
+		fetched.iarg3 = b->t;
+	}
+	else {
+		fetched.iarg2 = b->d;
+		fetched.iarg3 = b->s;
+	}
+	return &fetched;
+}
+
+/* Procedure listInstructions prints the loaded code in the
+ * text format of the compiler, without comments
+ */
+static void listInstructions(void) {
+	INSTRUCTION *i;
+	int loc;
+
+	for (loc = 0; loc < iloc; loc++) {
+		i = fetch(loc);
+		if (opClass(i->iop) == opclRR)
+			printf("%3d:  %5s  %d,%d,%d \n", loc, opCodeTab[i->iop], i->iarg1, i->iarg2, i->iarg3);
+		else
+			printf("%3d:  %5s  %d,%d(%d) \n", loc, opCodeTab[i->iop], i->iarg1, i->iarg2, i->iarg3);
+	}
+}
+
+static STEPRESULT stepTM(void) {
+	INSTRUCTION *currentinstruction;
+	int pc;
+	int r, s, t, m;
+
+	pc = reg[PC_REG];
+	if (pc < 0 || pc >= IADDR_SIZE) return srIMEM_ERR;
+	reg[PC_REG] = pc + 1;
+	currentinstruction = fetch(pc);
+	r = currentinstruction->iarg1;
+	s = currentinstruction->iarg2;
+	t = currentinstruction->iarg3;
+	if (traceflag)
+		fprintf(stderr, "%5d: %5s %d,%d,%d\n", pc, opCodeTab[currentinstruction->iop], r, s, t);
+	switch (opClass(currentinstruction->iop)) {
+		case opclRR:
+			break;
+		case opclRM:
+			s = currentinstruction->iarg3;
+			m = currentinstruction->iarg2 + reg[s];
+			if (m < 0 || m >= DADDR_SIZE) return srDMEM_ERR;
+			break;
+		case opclRA:
+			s = currentinstruction->iarg3;
+			m = currentinstruction->iarg2 + reg[s];
+			break;
+	}
+
+	switch (currentinstruction->iop) {
+		/* RR instructions */
+		case opHALT:
+			/* HALT 1 is a failed bounds check, the line in ac */
+			return r == 1 ? srBOUNDS : srHALT;
+		case opIN:
+			if (scanf("%d", &num) != 1) num = 0;
+			reg[r] = num;
+			break;
+		case opOUT:
+			printf("%d\n", reg[r]);
+			break;
+		/* sums and products wrap around */
+		case opADD: reg[r] = (int)((unsigned)reg[s] + (unsigned)reg[t]); break;
+		case opSUB: reg[r] = (int)((unsigned)reg[s] - (unsigned)reg[t]); break;
+		case opMUL: reg[r] = (int)((unsigned)reg[s] * (unsigned)reg[t]); break;
+		case opDIV:
+			/* the quotient of INT_MIN / -1 does not fit */
+			if (reg[t] == 0) return srZERODIVIDE;
+			if (reg[s] == INT_MIN && reg[t] == -1) return srOVERFLOW;
+			reg[r] = reg[s] / reg[t];
+			break;
+
+		/* RM instructions */
+		case opLD: reg[r] = dMem[m]; break;
+		case opST: dMem[m] = reg[r]; break;
+
+		/* RA instructions */
+		case opLDA: reg[r] = m; break;
+		case opLDC: reg[r] = currentinstruction->iarg2; break;
+		case opJLT: if (reg[r] < 0) reg[PC_REG] = m; break;
+		case opJLE: if (reg[r] <= 0) reg[PC_REG] = m; break;
+		case opJGT: if (reg[r] > 0) reg[PC_REG] = m; break;
+		case opJGE: if (reg[r] >= 0) reg[PC_REG] = m; break;
+		case opJEQ: if (reg[r] == 0) reg[PC_REG] = m; break;
+		case opJNE: if (reg[r] != 0) reg[PC_REG] = m; break;
+	}
+	return srOKAY;
+}
+
+/* Procedure printProfile reports the counters on stderr,
+ * like the call counts of gprof: a section for every kind,
+ * the calls of the functions, then the iterations of the
+ * loops and the runs of either side of the ifs, each the
+ * most frequent first
+ */
+static void printProfile(void) {
+	int *order = (int *)malloc((ncounters + 1) * sizeof(int));
+	int kind, k, j, n;
+
+	for (kind = 0; kind < NKINDS; ++kind) {
+		n = 0;
+		for (k = 0; k < ncounters; ++k) {
+			if (counter[k].kind != kind) continue;
+			for (j = n++; j > 0 && dMem[counter[order[j - 1]].word] < dMem[counter[k].word]; --j)
+				order[j] = order[j - 1];
+			order[j] = k;
+		}
+		if (n == 0) continue;
+		fprintf(stderr, "%12s  %s\n", countHeading[kind][0], countHeading[kind][1]);
+		for (k = 0; k < n; ++k) {
+			COUNTER *c = &counter[order[k]];
+
+			if (kind == 0) fprintf(stderr, "%12d  %s\n", dMem[c->word], c->name);
+			else if (c->ordinal > 1) fprintf(stderr, "%12d  %s:%d.%d\n", dMem[c->word], c->name, c->line, c->ordinal);
+			else fprintf(stderr, "%12d  %s:%d\n", dMem[c->word], c->name, c->line);
+		}
+	}
+	free(order);
+}
+
+int main(int argc, char *argv[]) {
+	FILE *pgm;
+	STEPRESULT stepResult;
+	long long stepcnt = 0;
+	int arg, listflag = 0;
+	char magic[4];
+
+	for (arg = 1; arg < argc && argv[arg][0] == '-'; ++arg) {
+		if (!strcmp(argv[arg], "-t")) traceflag = 1;
+		else if (!strcmp(argv[arg], "-c")) countflag = 1;
+		else if (!strcmp(argv[arg], "-l")) listflag = 1;
+		else break;
+	}
+	if (arg != argc - 1) {
+		fprintf(stderr, "usage: %s [-t] [-c] [-l] <filename>\n", argv[0]);
+		exit(1);
+	}
+	pgm = fopen(argv[arg], "r");
+	if (pgm == NULL) {
+		fprintf(stderr, "file '%s' not found\n", argv[arg]);
+		exit(1);
+	}
+	if (fread(magic, 1, 4, pgm) == 4 && !memcmp(magic, TMB_MAGIC, 4)) {
+		if (!mapBinary(pgm)) exit(1);
+	}
+	else {
+		rewind(pgm);
+		if (!readInstructions(pgm)) exit(1);
+	}
+	fclose(pgm);
+	if (listflag) {
+		listInstructions();
+		return 0;
+	}
+
+	do {
+		stepResult = stepTM();
+		stepcnt++;
+	} while (stepResult == srOKAY);
+
+	/* the output comes first when both go to one file */
+	fflush(stdout);
+	if (stepResult == srBOUNDS)
+		fprintf(stderr, "%s at line %d\n", stepResultTab[stepResult], reg[0]);
+	else if (stepResult != srHALT)
+		fprintf(stderr, "%s at instruction %d\n", stepResultTab[stepResult], reg[PC_REG] - 1);
+	if (countflag)
+		fprintf(stderr, "Executed %lld instructions (%d loaded)\n", stepcnt, iloc);
+	if (ncounters > 0) printProfile();
+	return stepResult == srHALT ? 0 : 2;
+}
@@ -0,0 +1,34 @@
+/* FILE: tmb.h */
+/* Compact binary TM code, written by the C-Minus compiler */
+/* and read by the TM simulator */
+
+#ifndef _TMB_H_
+#define _TMB_H_
+
+#include <stdint.h>
+
+#define TMB_MAGIC "TMB1"
+
+/* the file starts with a header and holds ninstr
+ * fixed-width instruction records after it, in the
+ * byte order of the machine that wrote it; dataWords
+ * is the size of the global data at the bottom of data
+ * memory and entry the code location of main, which the
+ * prelude at location 0 calls
+ */
+typedef struct {
+	char magic[4];
+	int32_t ninstr;
+	int32_t dataWords;
+	int32_t entry;
+} TmbHeader;
+
+/* RO instructions use r,s,t and RM and RA instructions
+ * r,d(s); op is the simulator's opcode number
+ */
+typedef struct {
+	uint8_t op, r, s, t;
+	int32_t d;
+} TmbInstr;
+
+#endif
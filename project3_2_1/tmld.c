@@ -0,0 +1,295 @@
+/* FILE: tmld.c */
+/* TM linker for the C-Minus compiler: combines the object */
+/* files of units compiled with -c into one TM program */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "code.h"
+#include "tmb.h"
+
+#define LINESIZE 1024
+#define NAMESIZE 64
+#define MAXCODE 65536	/* the code memory of tm */
+
+static char *opName[] = {
+	"HALT", "IN", "OUT", "ADD", "SUB", "MUL", "DIV", "????",
+	"LD", "ST", "????",
+	"LDA", "LDC", "JLT", "JLE", "JGT", "JGE", "JEQ", "JNE", "????"
+};
+
+static char *relocName[] = { "", "code", "data", "import" };
+
+/* a function or global: for a function loc is its code
+ * location, for a global the first word and words its size
+ */
+typedef struct {
+	char name[NAMESIZE];
+	int loc;
+	int words;
+	char *file;
+} Symbol;
+
+typedef struct {
+	int loc;
+	int kind;		/* a TmReloc */
+	char name[NAMESIZE];
+} Reloc;
+
+typedef struct {
+	char *file;
+	int base;		/* linked location of its location 0 */
+	int ninstr;
+	TmInstr *code;
+	int nglobals;
+	Symbol *globals;	/* loc is the word in the unit */
+	int nrelocs;
+	Reloc *relocs;
+} Unit;
+
+static Unit *units;
+static int nunits;
+
+/* the symbols of the program, linked locations */
+static Symbol *funcs, *globals;
+static int nfuncs, nglobals;
+static int dataWords = 0;
+
+static void fail(char *file, char *msg, char *name) {
+	fprintf(stderr, "tmld: %s: %s", file, msg);
+	if (name != NULL) fprintf(stderr, " %s", name);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static Symbol *lookup(Symbol *table, int n, char *name) {
+	int k;
+
+	for (k = 0; k < n; ++k)
+		if (!strcmp(table[k].name, name)) return &table[k];
+	return NULL;
+}
+
+static Symbol *addSymbol(Symbol **table, int *n, char *name, int loc, int words, char *file) {
+	Symbol *s;
+
+	*table = (Symbol *)realloc(*table, (*n + 1) * sizeof(Symbol));
+	s = &(*table)[(*n)++];
+	strncpy(s->name, name, NAMESIZE - 1);
+	s->name[NAMESIZE - 1] = '\0';
+	s->loc = loc;
+	s->words = words;
+	s->file = file;
+	return s;
+}
+
+static int lookupOp(char *op) {
+	int k;
+
+	for (k = 0; k < opRALim; ++k)
+		if (!strcmp(opName[k], op)) return k;
+	return -1;
+}
+
+/* Procedure readUnit reads an object file written by the
+ * compiler with -c: directives, then the instructions
+ */
+static void readUnit(Unit *u, char *file) {
+	FILE *f = fopen(file, "r");
+	char line[LINESIZE], op[8], name[NAMESIZE], kind[8], sep;
+	int loc, a, b, c, k, cap = 0;
+
+	if (f == NULL) fail(file, "cannot open", NULL);
+	memset(u, 0, sizeof(Unit));
+	u->file = file;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (line[0] == '*' || line[0] == '\n') continue;
+		if (sscanf(line, ".global %63s %d %d", name, &a, &b) == 3) {
+			u->globals = (Symbol *)realloc(u->globals, (u->nglobals + 1) * sizeof(Symbol));
+			strcpy(u->globals[u->nglobals].name, name);
+			u->globals[u->nglobals].loc = a;
+			u->globals[u->nglobals++].words = b;
+		}
+		else if (sscanf(line, ".function %63s %d", name, &a) == 2) {
+			if (lookup(funcs, nfuncs, name) != NULL)
+				fail(file, "duplicate function", name);
+			addSymbol(&funcs, &nfuncs, name, a, 0, file);
+		}
+		else if (sscanf(line, ".reloc %d %7s", &a, kind) == 2) {
+			u->relocs = (Reloc *)realloc(u->relocs, (u->nrelocs + 1) * sizeof(Reloc));
+			for (k = RelCode; k <= RelImport && strcmp(relocName[k], kind); ++k);
+			if (k > RelImport) fail(file, "bad relocation", kind);
+			u->relocs[u->nrelocs].loc = a;
+			u->relocs[u->nrelocs].kind = k;
+			if (k == RelCode || sscanf(line, ".reloc %*d %*s %63s", u->relocs[u->nrelocs].name) != 1)
+				u->relocs[u->nrelocs].name[0] = '\0';
+			u->nrelocs++;
+		}
+		else if (line[0] == '.') continue;
+		else if (sscanf(line, "%d: %7s %d,%d%c%d", &loc, op, &a, &b, &sep, &c) == 6) {
+			TmInstr *i;
+
+			if (loc < 0 || loc >= MAXCODE) fail(file, "bad location", NULL);
+			if (loc >= cap) {
+				int old = cap;
+				cap = cap > 0 ? cap : 256;
+				while (cap <= loc) cap *= 2;
+				u->code = (TmInstr *)realloc(u->code, cap * sizeof(TmInstr));
+				memset(u->code + old, 0, (cap - old) * sizeof(TmInstr));
+			}
+			i = &u->code[loc];
+			if ((i->op = lookupOp(op)) < 0) fail(file, "illegal opcode", op);
+			i->r = a;
+			if (i->op < opRRLim) {
+				i->s = b;
+				i->t = c;
+			}
+			else {
+				i->d = b;
+				i->s = c;
+			}
+			if (loc + 1 > u->ninstr) u->ninstr = loc + 1;
+		}
+		else fail(file, "bad line", line);
+	}
+	fclose(f);
+}
+
+/* Procedure relocate moves the code of a unit to its place
+ * in the program and fills in the references to functions
+ * and globals
+ */
+static void relocate(Unit *u) {
+	Symbol *s, *g;
+	int k;
+
+	for (k = 0; k < u->nrelocs; ++k) {
+		Reloc *r = &u->relocs[k];
+		TmInstr *i;
+
+		if (r->loc < 0 || r->loc >= u->ninstr) fail(u->file, "bad relocation", NULL);
+		i = &u->code[r->loc];
+		switch (r->kind) {
+			case RelCode:
+				i->d += u->base;
+				break;
+			case RelData:
+				if ((s = lookup(u->globals, u->nglobals, r->name)) == NULL)
+					fail(u->file, "undeclared global", r->name);
+				g = lookup(globals, nglobals, r->name);
+				i->d += g->loc - s->loc;
+				break;
+			default:
+				if ((s = lookup(funcs, nfuncs, r->name)) == NULL)
+					fail(u->file, "undefined reference to", r->name);
+				i->d = s->loc;
+				break;
+		}
+	}
+}
+
+/* the prelude of cgen.c with its call to main */
+static TmInstr prelude[] = {
+	{ opLD, sp, ac, 0, 0 },
+	{ opST, ac, ac, 0, 0 },
+	{ opLDC, gp, ac, 0, 0 },
+	{ opLDA, fp, sp, 0, 0 },
+	{ opST, fp, sp, 0, 0 },
+	{ opLDA, fp, sp, 0, 0 },
+	{ opLDA, ac, pc, 0, 1 },
+	{ opLDC, pc, 0, 0, 0 },		/* main */
+	{ opHALT, 0, 0, 0, 0 }
+};
+
+#define PRELUDE ((int)(sizeof(prelude) / sizeof(prelude[0])))
+
+static void writeText(FILE *out, TmInstr *i, int loc) {
+	if (i->op < opRRLim) fprintf(out, "%3d:  %5s  %d,%d,%d \n", loc, opName[i->op], i->r, i->s, i->t);
+	else fprintf(out, "%3d:  %5s  %d,%d(%d) \n", loc, opName[i->op], i->r, i->d, i->s);
+}
+
+static void writeRecord(FILE *out, TmInstr *i) {
+	TmbInstr b;
+
+	b.op = i->op;
+	b.r = i->r;
+	b.s = i->s;
+	b.t = i->t;
+	b.d = i->d;
+	fwrite(&b, sizeof(b), 1, out);
+}
+
+int main(int argc, char *argv[]) {
+	char *outfile = "a.tm";
+	int binary = 0;
+	int arg, k, n, loc;
+	Symbol *mainSym, *g;
+	FILE *out;
+
+	for (arg = 1; arg < argc && argv[arg][0] == '-'; ++arg) {
+		if (!strcmp(argv[arg], "-binary")) binary = 1;
+		else if (!strcmp(argv[arg], "-o") && arg + 1 < argc) outfile = argv[++arg];
+		else break;
+	}
+	if (arg >= argc || argv[arg][0] == '-') {
+		fprintf(stderr, "usage: %s [-binary] [-o file] <object> ...\n", argv[0]);
+		exit(1);
+	}
+
+	/* lay the units out after the prelude */
+	nunits = argc - arg;
+	units = (Unit *)calloc(nunits, sizeof(Unit));
+	loc = PRELUDE;
+	for (k = 0; k < nunits; ++k) {
+		int first = nfuncs;
+
+		readUnit(&units[k], argv[arg + k]);
+		units[k].base = loc;
+		for (n = first; n < nfuncs; ++n) funcs[n].loc += loc;
+		loc += units[k].ninstr;
+	}
+
+	/* globals of the same name in several units are one
+	 * object, like common symbols in C
+	 */
+	for (k = 0; k < nunits; ++k)
+		for (n = 0; n < units[k].nglobals; ++n) {
+			Symbol *s = &units[k].globals[n];
+
+			if ((g = lookup(globals, nglobals, s->name)) == NULL) {
+				addSymbol(&globals, &nglobals, s->name, dataWords, s->words, units[k].file);
+				dataWords += s->words;
+			}
+			else if (g->words != s->words)
+				fail(units[k].file, "size differs from the first declaration of", s->name);
+		}
+
+	if ((mainSym = lookup(funcs, nfuncs, "main")) == NULL) fail(outfile, "no function", "main");
+	prelude[PRELUDE - 2].d = mainSym->loc;
+	for (k = 0; k < nunits; ++k) relocate(&units[k]);
+
+	out = fopen(outfile, binary ? "wb" : "w");
+	if (out == NULL) fail(outfile, "cannot create", NULL);
+	if (binary) {
+		TmbHeader h;
+
+		memcpy(h.magic, TMB_MAGIC, 4);
+		h.ninstr = loc;
+		h.dataWords = dataWords;
+		h.entry = mainSym->loc;
+		fwrite(&h, sizeof(h), 1, out);
+		for (k = 0; k < PRELUDE; ++k) writeRecord(out, &prelude[k]);
+		for (k = 0; k < nunits; ++k)
+			for (n = 0; n < units[k].ninstr; ++n) writeRecord(out, &units[k].code[n]);
+	}
+	else {
+		fprintf(out, "* C-Minus program linked by tmld\n");
+		for (k = 0; k < PRELUDE; ++k) writeText(out, &prelude[k], k);
+		for (k = 0; k < nunits; ++k) {
+			fprintf(out, "* unit %s\n", units[k].file);
+			for (n = 0; n < units[k].ninstr; ++n) writeText(out, &units[k].code[n], units[k].base + n);
+		}
+	}
+	fclose(out);
+	return 0;
+}
@@ -11,9 +11,9 @@ void printToken(TokenType token, const char* tokenString) {
 
  fprintf(listing,"\t%d\t\t", lineno);
   switch (token) {
-    case IF: fprintf(listing, "IF\t\tif\n"); break;
+    case IF: fputs("IF\t\tif\n", listing); break;
     case THEN:
-    case ELSE: fprintf(listing, "ELSE\t\telse\n"); break;
+    case ELSE: fputs("ELSE\t\telse\n", listing); break;
     case END:
     case REPEAT:
     case UNTIL:
@@ -23,34 +23,34 @@ void printToken(TokenType token, const char* tokenString) {
       break;
     //case ASSIGN: fprintf(listing, ":=\n"); break;
 	
-	case INT: fprintf(listing, "INT\t\tint\n"); break;
-	case VOID: fprintf(listing, "VOID\t\tvoid\n"); break;
- 	case WHILE: fprintf(listing, "WHILE\t\twhile\n"); break;
+	case INT: fputs("INT\t\tint\n", listing); break;
+	case VOID: fputs("VOID\t\tvoid\n", listing); break;
+ 	case WHILE: fputs("WHILE\t\twhile\n", listing); break;
 
-    case LT: fprintf(listing, "<\t\t<\n"); break;
-    case EQ: fprintf(listing, "=\t\t=\n"); break;
+    case LT: fputs("<\t\t<\n", listing); break;
+    case EQ: fputs("=\t\t=\n", listing); break;
 	
 	//case LTEQ: fprintf(listing, "<=\t\t<=\n"); break;
 	//case RTEQ: fprintf(listing, ">=\t\t>=\n"); break;
 	//case EQEQ: fprintf(listing, "==\t\t==\n"); break;
 	//case RT: fprintf(listing, ">\t\t>\n"); break;
     
-	case LPAREN: fprintf(listing, "(\t\t(\n"); break;
-    case RPAREN: fprintf(listing, ")\t\t)\n"); break;
-	case LBRACE: fprintf(listing, "{\t\t{\n"); break;
-	case RBRACE: fprintf(listing, "}\t\t}\n"); break;
-	case LBRACKET: fprintf(listing, "[\t\t[\n"); break;
-	case RBRACKET: fprintf(listing, "]\t\t]\n"); break;
-    case SEMI: fprintf(listing, ";\t\t;\n"); break;
+	case LPAREN: fputs("(\t\t(\n", listing); break;
+    case RPAREN: fputs(")\t\t)\n", listing); break;
+	case LBRACE: fputs("{\t\t{\n", listing); break;
+	case RBRACE: fputs("}\t\t}\n", listing); break;
+	case LBRACKET: fputs("[\t\t[\n", listing); break;
+	case RBRACKET: fputs("]\t\t]\n", listing); break;
+    case SEMI: fputs(";\t\t;\n", listing); break;
     
-	case PLUS: fprintf(listing, "+\t\t+\n"); break;
-    case MINUS: fprintf(listing, "-\t\t-\n"); break;
-    case TIMES: fprintf(listing, "*\t\t*\n"); break;
-    case OVER: fprintf(listing, "/\t\t/\n"); break;
+	case PLUS: fputs("+\t\t+\n", listing); break;
+    case MINUS: fputs("-\t\t-\n", listing); break;
+    case TIMES: fputs("*\t\t*\n", listing); break;
+    case OVER: fputs("/\t\t/\n", listing); break;
 	
-	case COMMA: fprintf(listing, ",\t\t,\n"); break;
-	case RETURN: fprintf(listing, "RETURN\t\treturn\n"); break;
-    case ENDFILE: fprintf(listing, "EOF\n"); break;
+	case COMMA: fputs(",\t\t,\n", listing); break;
+	case RETURN: fputs("RETURN\t\treturn\n", listing); break;
+    case ENDFILE: fputs("EOF\n", listing); break;
     case NUM:
       fprintf(listing, "NUM\t\t%s\n", tokenString);
       break;
@@ -65,10 +65,51 @@ void printToken(TokenType token, const char* tokenString) {
   }
 }
 
+/* tree nodes are allocated in blocks and freed to a list
+ * they are taken from again, so a compiler that keeps
+ * running reuses the nodes of the trees it drops
+ */
+#define NODEBLOCK 1024
+
+static TreeNode *freeNodes = NULL;
+
+static TreeNode *allocNode(void) {
+  TreeNode *t;
+  int i;
+
+  if (freeNodes == NULL) {
+    TreeNode *block = (TreeNode *)malloc(NODEBLOCK * sizeof(TreeNode));
+
+    if (block == NULL) return NULL;
+    for (i = NODEBLOCK - 1; i >= 0; --i) {
+      block[i].sibling = freeNodes;
+      freeNodes = &block[i];
+    }
+  }
+  t = freeNodes;
+  freeNodes = t->sibling;
+  /* the fields a kind of node leaves unset are zero */
+  memset(t, 0, sizeof(TreeNode));
+  return t;
+}
+
+void freeTree(TreeNode *t) {
+  TreeNode *next;
+  int i;
+
+  while (t != NULL) {
+    for (i = 0; i < MAXCHILDREN; ++i) freeTree(t->child[i]);
+    next = t->sibling;
+    t->sibling = freeNodes;
+    freeNodes = t;
+    t = next;
+  }
+}
+
 /* Function newStmtNode creates a new statement node for syntax tree construction */
 
 TreeNode *newStmtNode(StmtKind kind) {
-  TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+  TreeNode *t = allocNode();
   int i;
 
   if (t == NULL) {
@@ -80,6 +121,7 @@ TreeNode *newStmtNode(StmtKind kind) {
     t->nodekind = StmtK;
     t->kind.stmt = kind;
     t->lineno = lineno;
+    t->bucket = NULL;
   }
   
   return t;
@@ -88,7 +130,7 @@ TreeNode *newStmtNode(StmtKind kind) {
 /* Function newExpNode creates a new expression node for syntax tree construction */
 
 TreeNode *newExpNode(ExpKind kind) {
-  TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+  TreeNode *t = allocNode();
   int i;
 
   if (t == NULL) {
@@ -100,6 +142,7 @@ TreeNode *newExpNode(ExpKind kind) {
     t->nodekind = ExpK;
     t->kind.exp = kind;
     t->lineno = lineno;
+    t->bucket = NULL;
     t->type = Void;
   }
 
@@ -109,7 +152,7 @@ TreeNode *newExpNode(ExpKind kind) {
 /* Declare part */
 
 TreeNode *newDeclNode(DeclKind kind) {
-	TreeNode *t = (TreeNode *)malloc(sizeof(TreeNode));
+	TreeNode *t = allocNode();
 	int i;
 
 	if (t == NULL) fprintf(listing, "Out of memory error at line %d\n", lineno);
@@ -119,6 +162,7 @@ TreeNode *newDeclNode(DeclKind kind) {
 		t->nodekind = DeclK;
 		t->kind.decl = kind;
 		t->lineno = lineno;
+		t->bucket = NULL;
 	}
 	return t;
 }
@@ -379,18 +423,20 @@ TreeNode *newArrayNode(TreeNode *_id, TreeNode *expression) {
 	return new;
 }
 
-TreeNode *newIdNode(char *tokenString) {
+/* the name is interned, and the value converted by the scanner */
+
+TreeNode *newIdNode(char *name) {
 	TreeNode *new = newExpNode(IdK);
 	
-	new->attr.name = copyString(tokenString);
+	new->attr.name = name;
 
 	return new;
 }
 
-TreeNode *newConstNode(char *num) {
+TreeNode *newConstNode(int val) {
 	TreeNode *new = newExpNode(ConstK);
 
-	new->attr.val = atoi(num);
+	new->attr.val = val;
 
 	return new;
 }
@@ -410,6 +456,75 @@ char *copyString (char *s) {
   return t;
 }
 
+/* the interned strings, each allocated along with its text */
+typedef struct InternRec {
+	struct InternRec *next;
+	char text[1];
+} * Intern;
+
+static Intern *internTable = NULL;
+static int internSize = 0;
+static int internCount = 0;
+
+static unsigned internHash(const char *s, int n) {
+	unsigned h = 0;
+	int i;
+
+	for (i = 0; i < n; ++i) h = h * 31 + (unsigned char)s[i];
+	return h;
+}
+
+char *internString(const char *s, int n) {
+	Intern p, next;
+	unsigned h;
+	int i;
+
+	if (internCount >= internSize) {
+		/* double the table, keeping chains short */
+		Intern *old = internTable;
+		int oldSize = internSize;
+
+		internSize = internSize == 0 ? 1024 : 2 * internSize;
+		internTable = (Intern *)calloc(internSize, sizeof(Intern));
+		for (i = 0; i < oldSize; ++i)
+			for (p = old[i]; p != NULL; p = next) {
+				next = p->next;
+				h = internHash(p->text, strlen(p->text)) % internSize;
+				p->next = internTable[h];
+				internTable[h] = p;
+			}
+		free(old);
+	}
+	h = internHash(s, n) % internSize;
+	for (p = internTable[h]; p != NULL; p = p->next)
+		if (!strncmp(p->text, s, n) && p->text[n] == '\0') return p->text;
+	p = (Intern)malloc(sizeof(struct InternRec) + n);
+	if (p == NULL) {
+		fprintf(listing, "Out of memory error at line %d\n", lineno);
+		exit(1);
+	}
+	memcpy(p->text, s, n);
+	p->text[n] = '\0';
+	p->next = internTable[h];
+	internTable[h] = p;
+	internCount++;
+	return p->text;
+}
+
+void internReset(void) {
+	Intern p, next;
+	int i;
+
+	for (i = 0; i < internSize; ++i)
+		for (p = internTable[i]; p != NULL; p = next) {
+			next = p->next;
+			free(p);
+		}
+	free(internTable);
+	internTable = NULL;
+	internSize = internCount = 0;
+}
+
 /* Variable indentno is used by printTree to store current number of spaces to indent */
 
 static indentno = 0;
@@ -419,12 +534,16 @@ static indentno = 0;
 #define INDENT indentno += 2
 #define UNINDENT indentno -= 2
 
-/* printSpaces indents by printing spaces */
+/* printSpaces indents by writing the spaces in blocks */
 
 static void printSpaces (void) {
-  int i;
+  static const char spaces[] = "                                                                ";
+  int n, i;
 
-  for (i = 0; i < indentno; ++i) fprintf(listing, " ");
+  for (i = indentno; i > 0; i -= n) {
+    n = i < (int)sizeof(spaces) - 1 ? i : (int)sizeof(spaces) - 1;
+    fwrite(spaces, 1, n, listing);
+  }
 }
 
 /* procedure printTree prints a syntax tree to the listing file using indentation to indicate subtrees */
@@ -437,13 +556,13 @@ void printTree (TreeNode *tree) {
     if (tree->nodekind == StmtK) {
       switch (tree->kind.stmt) {
         case IfK:
-          fprintf(listing, "If\n");
+          fputs("If\n", listing);
           break;
 		case WhileK:
-		  fprintf(listing, "While\n");
+		  fputs("While\n", listing);
 		  break;
         case RepeatK:
-          fprintf(listing, "Repeat\n");
+          fputs("Repeat\n", listing);
           break;
         case AssignK:
           fprintf(listing, "Assign to: %s\n", tree->attr.name);
@@ -452,43 +571,43 @@ void printTree (TreeNode *tree) {
           fprintf(listing, "READ: %s\n", tree->attr.name);
           break;
         case WriteK:
-          fprintf(listing, "Write\n");
+          fputs("Write\n", listing);
           break;
         case CompoundStmtK:
-          fprintf(listing, "Compound statement\n");
+          fputs("Compound statement\n", listing);
 		  printTree(tree->child[0]);
 		  printTree(tree->child[1]);
           break;
         case ExpressionStmtK:
-          fprintf(listing, "Expression statement\n");
+          fputs("Expression statement\n", listing);
 		  printTree(tree->child[2]);
           break;
         case SelectionStmtK:
-          fprintf(listing, "Selection statement\n");
+          fputs("Selection statement\n", listing);
 		  printTree(tree->child[6]);
 		  printTree(tree->child[3]);
 		  printTree(tree->child[4]);
 		  printTree(tree->child[5]);
           break;
         case IterationStmtK:
-          fprintf(listing, "Iteration statement\n");
+          fputs("Iteration statement\n", listing);
 		  printTree(tree->child[6]);
 		  printTree(tree->child[3]);
 		  printTree(tree->child[4]);
           break;
         case ReturnStmtK:
-          fprintf(listing, "Return\n");
+          fputs("Return\n", listing);
 		  printTree(tree->child[4]);
           break;
         default:
-          fprintf(listing, "Unknown ExpNode kind\n");
+          fputs("Unknown ExpNode kind\n", listing);
           break;
       }
     }
     else if (tree->nodekind == ExpK) {
       switch (tree->kind.exp) {
         case OpK:
-          fprintf(listing, "O: ");
+          fputs("O: ", listing);
           printToken(tree->attr.op, "\0");
           break;
         case ConstK:
@@ -498,25 +617,25 @@ void printTree (TreeNode *tree) {
           fprintf(listing, "ID: %s\n", tree->attr.name);
           break;
 		case ArrK:
-		  fprintf(listing, "Array\n");
+		  fputs("Array\n", listing);
 		  printTree(tree->child[5]);
 		  printTree(tree->child[1]);
 		  break;
 		case LvarK:
-		  fprintf(listing, "OP : =\n");
+		  fputs("OP : =\n", listing);
 		  printTree(tree->child[0]);
 		  printTree(tree->child[1]);
 		  break;
 		case ComparisionExpK:
-		  fprintf(listing, "ComparisionK\n");
+		  fputs("ComparisionK\n", listing);
 		  printTree(tree->child[3]);
 		  break;
 		case AdditiveExpK:
-		  fprintf(listing, "AdditiveExpK : \n");
+		  fputs("AdditiveExpK : \n", listing);
 		  printTree(tree->child[3]);
 		  break;
 		case MultiplicativeExpK:
-		  fprintf(listing, "MultiplicativeExpK\n");
+		  fputs("MultiplicativeExpK\n", listing);
 		  printTree(tree->child[3]);
 		  break;
 		case CallK:
@@ -526,36 +645,36 @@ void printTree (TreeNode *tree) {
 		  	printTree(tree->child[6]);
 		  break;
         default:
-          fprintf(listing, "Unknown ExpNode kind\n");
+          fputs("Unknown ExpNode kind\n", listing);
           break;
       }
     }
 	else if (tree->nodekind == DeclK) {
 		switch (tree->kind.decl) {
 			case VarK:
-          	 fprintf(listing, "VarK\n");
+          	 fputs("VarK\n", listing);
 			 printTree(tree->child[1]);
 			 printTree(tree->child[0]);
 			 break;
 			case VarArrK:
-          	 fprintf(listing, "VarArrK\n");
+          	 fputs("VarArrK\n", listing);
 			 printTree(tree->child[1]);
 			 printTree(tree->child[0]);
 			 printTree(tree->child[4]);
 			 break;
 			case ParamK:
-          	 fprintf(listing, "Parameter : %s\n", tree->child[1]->attr.val);
+          	 fprintf(listing, "Parameter : %s\n", tree->child[1]->attr.name);
 			 printTree(tree->child[0]);
 			 break;
 			case ParamArrK:
-          	 fprintf(listing, "Parameter Array : %s\n", tree->child[1]->attr.val);
+          	 fprintf(listing, "Parameter Array : %s\n", tree->child[1]->attr.name);
 			 printTree(tree->child[0]);
 			 break;
 			case ParamVoidK:
-          	 fprintf(listing, "Parameter : (null)\n");
+          	 fputs("Parameter : (null)\n", listing);
 			 break;
 			case FuncK:
-          	 fprintf(listing, "Function : %s\n", tree->child[1]->attr.val);
+          	 fprintf(listing, "Function : %s\n", tree->child[1]->attr.name);
 			 printTree(tree->child[0]);
 			 printTree(tree->child[2]);
 			 printTree(tree->child[3]);
@@ -563,77 +682,77 @@ void printTree (TreeNode *tree) {
 			case TypeK:
 			 switch (tree->type) {
 			 	case Integer:
-          	 	 fprintf(listing, "Type = Int\n");
+          	 	 fputs("Type = Int\n", listing);
 				 break;
 				case Void:
-          	 	 fprintf(listing, "Type = Void\n");
+          	 	 fputs("Type = Void\n", listing);
 				 break;
 				case LT:
-          	 	 fprintf(listing, "Op : <\n");
+          	 	 fputs("Op : <\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case LE:
-          	 	 fprintf(listing, "Op : <=\n");
+          	 	 fputs("Op : <=\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case GT:
-          	 	 fprintf(listing, "Op : >\n");
+          	 	 fputs("Op : >\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case GE:
-				 fprintf(listing, "Op : >=\n");
+				 fputs("Op : >=\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case EQ:
-				 fprintf(listing, "Op : ==\n");
+				 fputs("Op : ==\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case NE:
-				 fprintf(listing, "Op : !=\n");
+				 fputs("Op : !=\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case PLUS:
-				 fprintf(listing, "Op : +\n");
-				 fprintf(listing, "hererererrerere\n");
+				 fputs("Op : +\n", listing);
+				 fputs("hererererrerere\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case MINUS:
-				 fprintf(listing, "Op : -\n");
+				 fputs("Op : -\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case TIMES:
-				 fprintf(listing, "Op : *\n");
+				 fputs("Op : *\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case OVER:
-				 fprintf(listing, "Op : /\n");
+				 fputs("Op : /\n", listing);
 				 printTree(tree->child[2]);
 				 printTree(tree->child[4]);
 				 break;
 				case ASSIGN:
-				 fprintf(listing, "Op : =\n");
+				 fputs("Op : =\n", listing);
 				 printTree(tree->child[0]);
 				 printTree(tree->child[1]);
 				defualt:
-				 fprintf(listing, "Unknown Type\n");
+				 fputs("Unknown Type\n", listing);
 				 break;
 			 }
 			 break;
 			default:
-			 fprintf(listing, "Unknown DeclNode kind\n");
+			 fputs("Unknown DeclNode kind\n", listing);
 			 break;
 		}
 	}
-    else fprintf(listing, "Unknown node kind\n");
+    else fputs("Unknown node kind\n", listing);
     /*for (i = 0; i < MAXCHILDREN; ++i) {
       printTree(tree->child[i]);
     }*/
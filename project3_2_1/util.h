@@ -13,7 +13,7 @@ TreeNode *newStmtNode(StmtKind);
 
 /* Function newExpNode creates a new expression node for syntax tree construction */
 
-TreeNode *newExp(ExpKind);
+TreeNode *newExpNode(ExpKind);
 
 TreeNode *newDeclNode(DeclKind);
 TreeNode *addNode(TreeNode*, TreeNode*);
@@ -21,6 +21,7 @@ TreeNode *variableDeclarationNode(TreeNode*, TreeNode*, int);
 TreeNode *arrayDeclarationNode(TreeNode*, TreeNode*, int, TreeNode*);
 TreeNode *functionDeclarationNode(TreeNode*, TreeNode*, TreeNode*, TreeNode*, int);
 TreeNode *variableParameterNode(TreeNode*, TreeNode*, int);
+TreeNode *voidParameterNode(int);
 TreeNode *arrayParameterNode(TreeNode*, TreeNode*, int);
 TreeNode *compoundStatementNode(TreeNode*, TreeNode*, int);
 TreeNode *expressionStatementNode(TreeNode*);
@@ -28,15 +29,37 @@ TreeNode *assignExpression(TreeNode*, TreeNode*);
 TreeNode *selectionStatementNode(TreeNode*, TreeNode*, TreeNode*);
 TreeNode *iterationStatementNode(TreeNode*, TreeNode*);
 TreeNode *returnStatementNode(TreeNode*);
+TreeNode *comparisionExpressionNode(TreeNode*, TreeNode*, TreeNode*);
+TreeNode *additiveExpressionNode(TreeNode*, TreeNode*, TreeNode*);
+TreeNode *multiplicativeExpressionNode(TreeNode*, TreeNode*, TreeNode*);
+TreeNode *callNode(TreeNode*, TreeNode*);
+TreeNode *newArrayNode(TreeNode*, TreeNode*);
 TreeNode *tokenType(TokenType);
 TreeNode *newIdNode(char*);
-TreeNode *newConstNode(char*);
+TreeNode *newConstNode(int);
+void createSymTab(TreeNode*, TreeNode*);
+void scopeZero(TreeNode*);
 
 
+/* Procedure freeTree frees the nodes of a syntax tree, its siblings included, for reuse */
+
+void freeTree(TreeNode *);
+
 /* Function copyString allocates and make a new copy of an existing string */
 
 char *copyString(char *);
 
+/* Function internString returns the one copy of the n
+ * characters at s kept until internReset; the names of
+ * nodes and symbols are interned, and never freed alone
+ */
+char *internString(const char *s, int n);
+
+/* Procedure internReset frees every interned string; no
+ * tree or symbol holding one may be used afterwards
+ */
+void internReset(void);
+
 /* procedure printTree prints a syntax tree to the listing file using indentation to indicate subtrees */
 
 void printTree (TreeNode *);
@@ -0,0 +1,308 @@
+/* FILE: x86gen.c */
+/* x86-64 code generator for the C-Minus compiler */
+/* Emits System V assembly in GNU as syntax; link the */
+/* output with the runtime in cmrt.c */
+
+#include "globals.h"
+#include "symtab.h"
+#include "ir.h"
+#include "x86gen.h"
+
+/* Data memory keeps the TM model: globals and local arrays
+ * live in the int array cmrt_memory addressed by word index,
+ * globals from index 0 up and the local arrays of active
+ * calls from the top down.  %rbx holds the address of
+ * cmrt_memory and %r12d the first free word below the local
+ * arrays; both are callee-saved, so the C runtime keeps them.
+ * Every virtual register lives in a 4-byte slot of the
+ * native frame, addressed from %rbp.  When units are
+ * compiled separately, each global is a common symbol
+ * cmg_<name> merged by the system linker, and its word
+ * index is taken relative to %rbx.
+ */
+
+/* System V integer argument registers */
+static char *argReg[] = { "%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d" };
+#define NARGREGS 6
+
+static int *slot;		/* %rbp offset of every register */
+static int arrayFrame;		/* words of local arrays, 0 if none */
+static int arraySlot;		/* slot holding the local array base */
+static IrFunc curFunc;
+
+static void emitLabel(IrBlock b) {
+	fprintf(code, ".L%s_%d:\n", curFunc->name, b->id);
+}
+
+static void emitJumpTo(char *op, IrBlock b) {
+	fprintf(code, "\t%s\t.L%s_%d\n", op, curFunc->name, b->id);
+}
+
+static void load(char *reg, int r) {
+	fprintf(code, "\tmovl\t%d(%%rbp), %s\n", slot[r], reg);
+}
+
+static void store(char *reg, int r) {
+	fprintf(code, "\tmovl\t%s, %d(%%rbp)\n", reg, slot[r]);
+}
+
+/* Procedure emitCall passes the first six arguments in
+ * registers and the rest on the stack, keeping %rsp
+ * 16-byte aligned at the call
+ */
+static void emitCall(IrInstr i) {
+	int k, pushed = i->nargs > NARGREGS ? i->nargs - NARGREGS : 0;
+
+	if (pushed % 2 == 1) fprintf(code, "\tsubq\t$8, %%rsp\n");
+	for (k = i->nargs - 1; k >= NARGREGS; --k) {
+		load("%eax", i->args[k]);
+		fprintf(code, "\tpushq\t%%rax\n");
+	}
+	for (k = 0; k < i->nargs && k < NARGREGS; ++k) load(argReg[k], i->args[k]);
+	fprintf(code, "\tcall\tcm_%s\n", i->name);
+	if (pushed > 0) fprintf(code, "\taddq\t$%d, %%rsp\n", 8 * (pushed + pushed % 2));
+}
+
+static void emitEpilogue(void) {
+	if (arrayFrame > 0) fprintf(code, "\taddl\t$%d, %%r12d\n", arrayFrame);
+	fprintf(code, "\tleave\n");
+}
+
+static char *setOp(IrOp op) {
+	switch (op) {
+		case IrLt: return "setl";
+		case IrLe: return "setle";
+		case IrGt: return "setg";
+		case IrGe: return "setge";
+		case IrEq: return "sete";
+		default: return "setne";
+	}
+}
+
+static void genInstr(IrInstr i) {
+	int k;
+
+	switch (i->op) {
+		case IrConst:
+			fprintf(code, "\tmovl\t$%d, %d(%%rbp)\n", i->imm, slot[i->dst]);
+			break;
+		case IrCopy:
+			load("%eax", i->src[0]);
+			store("%eax", i->dst);
+			break;
+		case IrAdd:
+		case IrSub:
+		case IrMul:
+			load("%eax", i->src[0]);
+			fprintf(code, "\t%s\t%d(%%rbp), %%eax\n",
+				i->op == IrAdd ? "addl" : i->op == IrSub ? "subl" : "imull", slot[i->src[1]]);
+			store("%eax", i->dst);
+			break;
+		case IrDiv:
+			load("%eax", i->src[0]);
+			fprintf(code, "\tcltd\n");
+			fprintf(code, "\tidivl\t%d(%%rbp)\n", slot[i->src[1]]);
+			store("%eax", i->dst);
+			break;
+		case IrLt: case IrLe: case IrGt: case IrGe: case IrEq: case IrNe:
+			load("%eax", i->src[0]);
+			fprintf(code, "\tcmpl\t%d(%%rbp), %%eax\n", slot[i->src[1]]);
+			fprintf(code, "\t%s\t%%al\n", setOp(i->op));
+			fprintf(code, "\tmovzbl\t%%al, %%eax\n");
+			store("%eax", i->dst);
+			break;
+		case IrGAddr:
+			if (SeparateCompile) {
+				fprintf(code, "\tleaq\tcmg_%s(%%rip), %%rax\n", i->name);
+				fprintf(code, "\tsubq\t%%rbx, %%rax\n");
+				fprintf(code, "\tsarq\t$2, %%rax\n");
+				store("%eax", i->dst);
+			}
+			else fprintf(code, "\tmovl\t$%d, %d(%%rbp)\n", i->imm, slot[i->dst]);
+			break;
+		case IrLAddr:
+			load("%eax", arraySlot);
+			fprintf(code, "\taddl\t$%d, %%eax\n", i->imm);
+			store("%eax", i->dst);
+			break;
+		case IrLoad:
+			fprintf(code, "\tmovslq\t%d(%%rbp), %%rax\n", slot[i->src[0]]);
+			fprintf(code, "\tmovl\t(%%rbx,%%rax,4), %%eax\n");
+			store("%eax", i->dst);
+			break;
+		case IrStore:
+			fprintf(code, "\tmovslq\t%d(%%rbp), %%rax\n", slot[i->src[0]]);
+			load("%ecx", i->src[1]);
+			fprintf(code, "\tmovl\t%%ecx, (%%rbx,%%rax,4)\n");
+			break;
+		case IrCheck:
+			/* unsigned, so a negative index is out of bounds too */
+			fprintf(code, "\tcmpl\t$%d, %d(%%rbp)\n", i->imm, slot[i->src[0]]);
+			fprintf(code, "\tjb\t1f\n");
+			fprintf(code, "\tmovl\t$%d, %%edi\n", i->lineno);
+			fprintf(code, "\tcall\tcmrt_bounds\n");
+			fprintf(code, "1:\n");
+			break;
+		case IrCall:
+			emitCall(i);
+			if (i->dst >= 0) store("%eax", i->dst);
+			break;
+		case IrTailCall:
+			if (i->nargs > NARGREGS) {
+				/* stack arguments would not fit our frame */
+				emitCall(i);
+				emitEpilogue();
+				fprintf(code, "\tret\n");
+				break;
+			}
+			for (k = 0; k < i->nargs; ++k) load(argReg[k], i->args[k]);
+			emitEpilogue();
+			fprintf(code, "\tjmp\tcm_%s\n", i->name);
+			break;
+		case IrRet:
+			if (i->src[0] >= 0) load("%eax", i->src[0]);
+			emitEpilogue();
+			fprintf(code, "\tret\n");
+			break;
+		case IrJump:
+			if (i->block->next != i->block->succ[0]) emitJumpTo("jmp", i->block->succ[0]);
+			break;
+		case IrBranch:
+			fprintf(code, "\tcmpl\t$0, %d(%%rbp)\n", slot[i->src[0]]);
+			if (i->block->next == i->block->succ[1] && i->block->next != i->block->succ[0]) {
+				emitJumpTo("jne", i->block->succ[0]);
+				break;
+			}
+			emitJumpTo("je", i->block->succ[1]);
+			if (i->block->next != i->block->succ[0]) emitJumpTo("jmp", i->block->succ[0]);
+			break;
+		default:
+			break;
+	}
+}
+
+/* Function assignSlots gives every register a slot below %rbp,
+ * parameters past the sixth their incoming stack slot, and
+ * returns the bytes of the frame rounded up to 16
+ */
+static int assignSlots(IrFunc f) {
+	int next = 4;
+	IrBlock b;
+	IrInstr i;
+	int k;
+
+	slot = (int *)realloc(slot, (f->nregs + 1) * sizeof(int));
+	for (k = 0; k <= f->nregs; ++k) slot[k] = 0;
+	for (k = 0; k < f->nparams; ++k)
+		slot[f->params[k]] = k < NARGREGS ? -(next += 4) : 16 + 8 * (k - NARGREGS);
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next) {
+			if (i->dst >= 0 && slot[i->dst] == 0) slot[i->dst] = -(next += 4);
+			for (k = 0; k < 2; ++k)
+				if (i->src[k] >= 0 && slot[i->src[k]] == 0) slot[i->src[k]] = -(next += 4);
+			for (k = 0; k < i->nargs; ++k)
+				if (slot[i->args[k]] == 0) slot[i->args[k]] = -(next += 4);
+		}
+	/* the last slot keeps the local array base */
+	arraySlot = f->nregs;
+	slot[arraySlot] = -4;
+	return (next + 15) / 16 * 16;
+}
+
+static void genFunction(IrFunc f) {
+	IrBlock b;
+	IrInstr i;
+	int k, bytes;
+
+	curFunc = f;
+	bytes = assignSlots(f);
+	arrayFrame = 0;
+	for (b = f->entry; b != NULL; b = b->next)
+		for (i = b->first; i != NULL; i = i->next)
+			if (i->op == IrLAddr) arrayFrame = f->frameSize;
+
+	if (TraceCode) fprintf(code, "# function %s\n", f->name);
+	fprintf(code, "\t.globl\tcm_%s\n", f->name);
+	fprintf(code, "\t.type\tcm_%s, @function\n", f->name);
+	fprintf(code, "cm_%s:\n", f->name);
+	fprintf(code, "\tpushq\t%%rbp\n");
+	fprintf(code, "\tmovq\t%%rsp, %%rbp\n");
+	fprintf(code, "\tsubq\t$%d, %%rsp\n", bytes);
+	for (k = 0; k < f->nparams && k < NARGREGS; ++k) store(argReg[k], f->params[k]);
+	if (arrayFrame > 0) {
+		/* local array words sit below the caller's, addressed
+		 * like the TM frame: word -1 is unused
+		 */
+		fprintf(code, "\tmovl\t%%r12d, %d(%%rbp)\n", slot[arraySlot]);
+		fprintf(code, "\tsubl\t$%d, %%r12d\n", arrayFrame);
+	}
+	for (b = f->entry; b != NULL; b = b->next) {
+		emitLabel(b);
+		for (i = b->first; i != NULL; i = i->next) genInstr(i);
+	}
+	fprintf(code, "\t.size\tcm_%s, .-cm_%s\n", f->name, f->name);
+}
+
+void x86CodeGen(IrProgram program, char *codefile) {
+	IrFunc f;
+	IrGlobal g;
+	int hasMain = FALSE;
+
+	fprintf(code, "# C-Minus compilation to x86-64\n");
+	fprintf(code, "# File: %s\n", codefile);
+	fprintf(code, "\t.text\n");
+	for (f = program->funcs; f != NULL; f = f->next) {
+		genFunction(f);
+		if (!strcmp(f->name, "main")) hasMain = TRUE;
+	}
+	if (SeparateCompile) {
+		for (g = program->globals; g != NULL; g = g->next)
+			fprintf(code, "\t.comm\tcmg_%s, %d, 4\n", g->name, 4 * g->words);
+		/* only the unit of main starts the program */
+		if (!hasMain) {
+			fprintf(code, "\t.section\t.note.GNU-stack,\"\",@progbits\n");
+			return;
+		}
+	}
+
+	/* cmrt_start sets up data memory and runs main */
+	fprintf(code, "\t.globl\tcmrt_start\n");
+	fprintf(code, "\t.type\tcmrt_start, @function\n");
+	fprintf(code, "cmrt_start:\n");
+	fprintf(code, "\tpushq\t%%rbx\n");
+	fprintf(code, "\tpushq\t%%r12\n");
+	fprintf(code, "\tsubq\t$8, %%rsp\n");
+	fprintf(code, "\tleaq\tcmrt_memory(%%rip), %%rbx\n");
+	fprintf(code, "\tmovl\t$%d, %%r12d\n", X86_MEMORY_WORDS);
+	fprintf(code, "\tcall\tcm_main\n");
+	fprintf(code, "\taddq\t$8, %%rsp\n");
+	fprintf(code, "\tpopq\t%%r12\n");
+	fprintf(code, "\tpopq\t%%rbx\n");
+	fprintf(code, "\tret\n");
+	fprintf(code, "\t.size\tcmrt_start, .-cmrt_start\n");
+	fprintf(code, "\t.local\tcmrt_memory\n");
+	fprintf(code, "\t.comm\tcmrt_memory, %d, 32\n", X86_MEMORY_WORDS * 4);
+	if (program->counters != NULL) {
+		/* the counters of -profile for the runtime to report:
+		 * address, kind, line, ordinal and name, ending with a
+		 * null address
+		 */
+		IrCounter c;
+		int k = 0;
+
+		fprintf(code, "\t.section\t.rodata\n");
+		for (c = program->counters; c != NULL; c = c->next)
+			fprintf(code, ".Lcounter_%d:\n\t.string\t\"%s\"\n", k++, c->name);
+		fprintf(code, "\t.data\n");
+		fprintf(code, "\t.globl\tcmrt_profile\n");
+		fprintf(code, "\t.p2align\t3\n");
+		fprintf(code, "cmrt_profile:\n");
+		for (c = program->counters, k = 0; c != NULL; c = c->next, ++k) {
+			fprintf(code, "\t.quad\tcmrt_memory+%d\n", 4 * c->word);
+			fprintf(code, "\t.long\t%d, %d, %d, 0\n", c->kind, c->line, c->ordinal);
+			fprintf(code, "\t.quad\t.Lcounter_%d\n", k);
+		}
+		fprintf(code, "\t.quad\t0, 0, 0, 0\n");
+	}
+	fprintf(code, "\t.section\t.note.GNU-stack,\"\",@progbits\n");
+}
@@ -0,0 +1,19 @@
+/* FILE: x86gen.h */
+
+#ifndef _X86GEN_H_
+#define _X86GEN_H_
+
+#include "ir.h"
+
+/* words of data memory of a compiled program: globals from
+ * the bottom, local arrays from the top
+ */
+#define X86_MEMORY_WORDS (1 << 22)
+
+/* Procedure x86CodeGen generates x86-64 assembly for the GNU
+ * assembler to the code file from the IR of the program;
+ * codefile is the name of the code file
+ */
+void x86CodeGen(IrProgram program, char *codefile);
+
+#endif